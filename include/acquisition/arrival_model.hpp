@@ -0,0 +1,97 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+namespace vulkan::acquisition
+{
+    /// <summary>
+    /// Models the arrival of decrypted pages online. Coverage follows a saturating curve, so every page that is still missing is
+    /// assumed to arrive independently at a rate `lambda`, which gives an exponential approach to full coverage:
+    /// `coverage(t + h) = coverage(t) + remaining(t) * (1 - exp(-lambda * h))`. The arrival rate is smoothed with an exponentially
+    /// weighted moving average, so the model follows the target as it slows down.
+    /// </summary>
+    class arrival_model final
+    {
+        using clock = std::chrono::steady_clock;
+
+        std::size_t _total;
+        std::size_t _arrived = 0;
+
+        clock::time_point _start;
+        clock::time_point _last;
+
+        /// <summary>
+        /// The smoothed arrival rate in pages per second.
+        /// </summary>
+        double _rate = 0.0;
+
+        /// <summary>
+        /// The time constant of the moving average, in seconds.
+        /// </summary>
+        double _smoothing;
+
+        bool _has_rate = false;
+
+       public:
+        /// <summary>
+        /// Creates a new model.
+        /// </summary>
+        /// <param name="total">The number of pages that can arrive.</param>
+        /// <param name="start">The time acquisition started.</param>
+        /// <param name="arrived">The number of pages that were already there at the start. They do not count towards the rate.</param>
+        /// <param name="smoothing">The time constant of the moving average of the arrival rate.</param>
+        explicit arrival_model(
+            std::size_t total,
+            clock::time_point start,
+            std::size_t arrived = 0,
+            std::chrono::duration< double > smoothing = std::chrono::seconds( 2 ) ) noexcept;
+
+        /// <summary>
+        /// Updates the model with the number of pages that arrived so far.
+        /// </summary>
+        /// <param name="now">The current time.</param>
+        /// <param name="arrived">The total number of pages that arrived.</param>
+        void observe( clock::time_point now, std::size_t arrived ) noexcept;
+
+        /// <summary>
+        /// Returns the fraction of pages that arrived, from 0 to 1.
+        /// </summary>
+        double coverage( ) const noexcept;
+
+        /// <summary>
+        /// Returns the time since acquisition started, as of the last observation.
+        /// </summary>
+        std::chrono::duration< double > elapsed( ) const noexcept;
+
+        /// <summary>
+        /// Returns whether the model has seen enough to make predictions.
+        /// </summary>
+        bool is_warm( ) const noexcept;
+
+        /// <summary>
+        /// Returns the smoothed arrival rate, in pages per second.
+        /// </summary>
+        double rate( ) const noexcept;
+
+        /// <summary>
+        /// Returns the marginal coverage gain, as a fraction of all pages per second.
+        /// </summary>
+        double gain_per_second( ) const noexcept;
+
+        /// <summary>
+        /// Predicts the coverage after waiting for a while longer.
+        /// </summary>
+        /// <param name="horizon">The time to wait.</param>
+        /// <returns>The predicted coverage, from 0 to 1.</returns>
+        double predict( std::chrono::duration< double > horizon ) const noexcept;
+
+        /// <summary>
+        /// Estimates how long it takes to reach a coverage level.
+        /// </summary>
+        /// <param name="coverage">The coverage level, from 0 to 1.</param>
+        /// <returns>The estimated time, or nothing if the level is not expected to be reached.</returns>
+        std::optional< std::chrono::duration< double > > time_to( double coverage ) const noexcept;
+    };
+}  // namespace vulkan::acquisition
\ No newline at end of file
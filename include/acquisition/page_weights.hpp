@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace vulkan::acquisition
+{
+    /// <summary>
+    /// Weighs the pages of a code section by how useful they are for analysis, so that acquisition can poll the valuable pages first
+    /// and report how much of the useful code it recovered. Every page weighs one, plus one for every function that starts in it, plus
+    /// a bonus for pages that hold an entry point.
+    /// </summary>
+    class page_weights final
+    {
+        std::vector< double > _weights;
+        double _total = 0.0;
+
+       public:
+        /// <summary>
+        /// The weight added to pages that hold an entry point of the image, such as the one in the optional header or an export.
+        /// </summary>
+        static constexpr double ENTRY_POINT_WEIGHT = 16.0;
+
+        /// <summary>
+        /// Weighs the pages of a section.
+        /// </summary>
+        /// <param name="rva">The relative virtual address of the section.</param>
+        /// <param name="count">The number of pages of the section.</param>
+        /// <param name="function_starts">The start addresses of the functions in the exception directory. Other addresses are ignored.</param>
+        /// <param name="entry_points">The entry points of the image. Other addresses are ignored.</param>
+        explicit page_weights(
+            std::uint32_t rva,
+            std::size_t count,
+            std::span< const std::uint32_t > function_starts,
+            std::span< const std::uint32_t > entry_points );
+
+        /// <summary>
+        /// Returns the weight of a page.
+        /// </summary>
+        double operator[]( std::size_t page ) const noexcept;
+
+        /// <summary>
+        /// Returns the combined weight of all pages.
+        /// </summary>
+        double total( ) const noexcept;
+
+        /// <summary>
+        /// Returns the indices of the pages from the heaviest to the lightest. Pages of equal weight are in ascending order.
+        /// </summary>
+        std::vector< std::size_t > order( ) const;
+    };
+}  // namespace vulkan::acquisition
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>
+#include <string_view>
+
+#include "acquisition/arrival_model.hpp"
+
+namespace vulkan::acquisition
+{
+    /// <summary>
+    /// The reason acquisition of a section stopped.
+    /// </summary>
+    enum class stop_reason_t
+    {
+        none,
+
+        /// <summary>
+        /// Every page was read.
+        /// </summary>
+        complete,
+
+        /// <summary>
+        /// The target coverage was reached.
+        /// </summary>
+        target_reached,
+
+        /// <summary>
+        /// The predicted coverage gain dropped below the minimum rate.
+        /// </summary>
+        gain_too_low,
+
+        /// <summary>
+        /// The deadline passed.
+        /// </summary>
+        deadline,
+
+        /// <summary>
+        /// The source cannot produce any more pages.
+        /// </summary>
+        exhausted,
+
+        /// <summary>
+        /// Acquisition was cancelled through the stop token.
+        /// </summary>
+        cancelled,
+    };
+
+    /// <summary>
+    /// Returns a human readable description of a stop reason.
+    /// </summary>
+    std::string_view to_string( stop_reason_t reason ) noexcept;
+
+    /// <summary>
+    /// Decides when to stop waiting for more pages to arrive.
+    /// </summary>
+    struct termination_policy
+    {
+        /// <summary>
+        /// The coverage to stop at, from 0 to 1.
+        /// </summary>
+        double target = 1.0;
+
+        /// <summary>
+        /// The minimum coverage gain per second, as a fraction of all pages. Zero disables the check.
+        /// </summary>
+        double min_gain_rate = 0.0;
+
+        /// <summary>
+        /// The maximum time to spend. Zero disables the deadline.
+        /// </summary>
+        std::chrono::duration< double > deadline = { };
+
+        /// <summary>
+        /// Decides whether to stop, based on the current state of the model.
+        /// </summary>
+        /// <param name="model">The arrival model.</param>
+        /// <returns>The reason to stop, or `none` to keep going.</returns>
+        stop_reason_t evaluate( const arrival_model& model ) const noexcept;
+    };
+}  // namespace vulkan::acquisition
\ No newline at end of file
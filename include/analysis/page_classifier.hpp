@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "pe/image_view.hpp"
+
+namespace vulkan::analysis
+{
+    /// <summary>
+    /// What a page of a dumped code section appears to contain.
+    /// </summary>
+    enum class page_class_t : std::uint8_t
+    {
+        /// <summary>
+        /// Only the `0x90` filler the dumper writes before a page is read.
+        /// </summary>
+        filler,
+
+        /// <summary>
+        /// Only zeros.
+        /// </summary>
+        zero,
+
+        /// <summary>
+        /// Plausible machine code.
+        /// </summary>
+        code,
+
+        /// <summary>
+        /// Neither code nor random, such as embedded tables or strings.
+        /// </summary>
+        data,
+
+        /// <summary>
+        /// Close to random data with few common opcodes. The page was readable, but has not been decrypted yet.
+        /// </summary>
+        encrypted,
+    };
+
+    /// <summary>
+    /// Returns the name of a page class.
+    /// </summary>
+    std::string_view to_string( page_class_t type ) noexcept;
+
+    /// <summary>
+    /// The statistics a page was classified by.
+    /// </summary>
+    struct page_profile_t
+    {
+        page_class_t type;
+
+        /// <summary>
+        /// The Shannon entropy of the bytes, from 0 to 8 bits per byte.
+        /// </summary>
+        float entropy;
+
+        /// <summary>
+        /// The fraction of bytes that are among the most common bytes of x64 code.
+        /// </summary>
+        float plausibility;
+
+        /// <summary>
+        /// The longest run of `0x90` bytes.
+        /// </summary>
+        std::uint32_t filler_run;
+
+        /// <summary>
+        /// The longest run of `0x00` bytes.
+        /// </summary>
+        std::uint32_t zero_run;
+    };
+
+    /// <summary>
+    /// A classified page of a code section.
+    /// </summary>
+    struct page_coverage_t
+    {
+        std::uint32_t rva;
+        page_profile_t profile;
+
+        /// <summary>
+        /// True if the page still looked encrypted when the dumper stopped polling it and kept it as read, because its contents no longer
+        /// changed or it was polled too often.
+        /// </summary>
+        bool accepted;
+    };
+
+    /// <summary>
+    /// Classifies a single page by its byte histogram, its entropy, its runs of filler and zeros, and how many of its bytes are common
+    /// opcodes, prefixes and ModR/M bytes.
+    /// </summary>
+    /// <param name="page">The contents of the page.</param>
+    /// <returns>The profile of the page.</returns>
+    page_profile_t classify_page( std::span< const std::uint8_t > page ) noexcept;
+
+    /// <summary>
+    /// Classifies every page of the code sections of an image. The pages are processed in parallel.
+    /// </summary>
+    /// <param name="image">A snapshot of the image.</param>
+    /// <returns>The classified pages, in ascending order.</returns>
+    std::vector< page_coverage_t > classify_pages( const pe::image_view& image );
+
+    /// <summary>
+    /// Writes a coverage map, a text file with the class and statistics of every page, and whether it was accepted while it looked encrypted.
+    /// </summary>
+    /// <param name="path">The path of the file.</param>
+    /// <param name="pages">The classified pages.</param>
+    /// <returns>True if the file was written, false otherwise.</returns>
+    bool save_coverage_map( std::string_view path, std::span< const page_coverage_t > pages );
+}  // namespace vulkan::analysis
\ No newline at end of file
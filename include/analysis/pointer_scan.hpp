@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "analysis/xref_table.hpp"
+#include "pe/image_view.hpp"
+
+namespace vulkan::analysis
+{
+    /// <summary>
+    /// Finds every naturally aligned, pointer-sized value in the data sections of an image that points into the image itself. These are
+    /// the fields a loader would have to relocate. Candidates that point into executable sections are only kept if they land on a known
+    /// function start or the target of a code reference, which filters out most coincidental matches.
+    /// </summary>
+    /// <param name="image">A snapshot of the image to scan.</param>
+    /// <param name="xrefs">The cross references of the image, used to validate pointers into code.</param>
+    /// <returns>The relative virtual addresses of the pointers, sorted in ascending order.</returns>
+    std::vector< std::uint32_t > scan_pointers( const pe::image_view& image, const xref_table& xrefs );
+}  // namespace vulkan::analysis
\ No newline at end of file
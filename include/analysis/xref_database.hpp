@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "analysis/xref_table.hpp"
+#include "io/mapped_file.hpp"
+
+namespace vulkan::analysis
+{
+    /// <summary>
+    /// The signature of a cross reference database ("VXDB").
+    /// </summary>
+    static constexpr std::uint32_t XREF_DATABASE_SIGNATURE = 0x42445856;
+
+    /// <summary>
+    /// The version of the cross reference database format.
+    /// </summary>
+    static constexpr std::uint32_t XREF_DATABASE_VERSION = 1;
+
+    /// <summary>
+    /// The number of cross references in a block of a cross reference database.
+    /// </summary>
+    static constexpr std::uint32_t XREF_DATABASE_BLOCK_SIZE = 128;
+
+    /// <summary>
+    /// An import that cross references can be resolved to.
+    /// </summary>
+    struct xref_import_t
+    {
+        /// <summary>
+        /// The relative virtual address of the import address table entry of the import.
+        /// </summary>
+        std::uint32_t slot;
+
+        /// <summary>
+        /// The name of the import, as `module!import`.
+        /// </summary>
+        std::string name;
+    };
+
+    /// <summary>
+    /// A cross reference read from a database.
+    /// </summary>
+    struct xref_record_t
+    {
+        std::uint32_t source;
+        std::uint32_t target;
+        xref_kind_t kind;
+        bool indirect;
+
+        /// <summary>
+        /// The name of the import the reference goes through, or empty if there is none. It points into the database.
+        /// </summary>
+        std::string_view import;
+    };
+
+    /// <summary>
+    /// Writes a cross reference database. References through the import address table are resolved to the import of their slot.
+    /// </summary>
+    /// <param name="path">The path of the file.</param>
+    /// <param name="xrefs">The cross references.</param>
+    /// <param name="imports">The imports of the image.</param>
+    /// <returns>True if the file was written, false otherwise.</returns>
+    bool save_xref_database( std::string_view path, std::span< const xref_t > xrefs, std::span< const xref_import_t > imports );
+
+    /// <summary>
+    /// A cross reference database, mapped into memory. The references are stored twice, once sorted by source and once by target, so
+    /// that both the references of an instruction and the callers of an address are found without analyzing the image again.
+    ///
+    /// Both orders are split into blocks of `XREF_DATABASE_BLOCK_SIZE` references. Each block is stored column by column: the sort keys
+    /// as the first key followed by the deltas between keys, the other addresses relative to their key (zigzag encoded), a byte with the
+    /// kind (low two bits) and the indirect flag (third bit) of every reference, and the import of every reference as its index plus
+    /// one, or zero. The columns are LEB128 varints, except for the kinds. A lookup binary searches a table of the first keys of the
+    /// blocks and decodes the blocks that can hold the key.
+    ///
+    /// The file starts with a header of eight 32-bit integers: the signature, the version, the number of references, the block size,
+    /// the number of imports, and the offsets of the import table and of the block tables of both orders. The import table holds the
+    /// slot, the offset and the length of the name of every import, and each block table the first key and the offset of every block.
+    /// All integers outside of the blocks are little endian, and offsets are from the start of the file.
+    /// </summary>
+    class xref_database final
+    {
+        friend bool save_xref_database( std::string_view path, std::span< const xref_t > xrefs, std::span< const xref_import_t > imports );
+
+        /// <summary>
+        /// An entry of a block table.
+        /// </summary>
+        struct block_t
+        {
+            std::uint32_t first_key;
+            std::uint32_t offset;
+        };
+
+        /// <summary>
+        /// An entry of the import table.
+        /// </summary>
+        struct import_entry_t
+        {
+            std::uint32_t slot;
+            std::uint32_t name_offset;
+            std::uint32_t name_size;
+        };
+
+        io::mapped_file _file;
+
+        std::size_t _count = 0;
+        std::size_t _block_size = 0;
+
+        std::span< const import_entry_t > _imports;
+        std::span< const block_t > _by_source;
+        std::span< const block_t > _by_target;
+
+        /// <summary>
+        /// Decodes the references of one order whose key matches, swapping the addresses back for the target order.
+        /// </summary>
+        std::vector< xref_record_t > find( std::span< const block_t > blocks, std::uint32_t key, bool by_target ) const;
+
+        /// <summary>
+        /// Decodes a block into records, with the key in `source` and the other address in `target`.
+        /// </summary>
+        bool decode( std::span< const block_t > blocks, std::size_t index, std::vector< xref_record_t >& out ) const;
+
+       public:
+        /// <summary>
+        /// Maps a cross reference database.
+        /// </summary>
+        /// <param name="path">The path of the file.</param>
+        explicit xref_database( std::string_view path ) noexcept;
+
+        /// <summary>
+        /// Returns whether the database was mapped and its header is valid.
+        /// </summary>
+        bool is_valid( ) const noexcept;
+
+        /// <summary>
+        /// Returns the number of cross references in the database.
+        /// </summary>
+        std::size_t size( ) const noexcept;
+
+        /// <summary>
+        /// Gets the cross references originating from the instruction at an address.
+        /// </summary>
+        /// <param name="source">The relative virtual address of the instruction.</param>
+        std::vector< xref_record_t > from( std::uint32_t source ) const;
+
+        /// <summary>
+        /// Gets the cross references to an address, sorted by source.
+        /// </summary>
+        /// <param name="target">The relative virtual address being referenced.</param>
+        std::vector< xref_record_t > to( std::uint32_t target ) const;
+
+        /// <summary>
+        /// Gets the cross references through the import address table entry of an import, sorted by source.
+        /// </summary>
+        /// <param name="name">The name of the import, as `module!import`.</param>
+        std::vector< xref_record_t > to_import( std::string_view name ) const;
+
+        /// <summary>
+        /// Gets the address of the import address table entry of an import.
+        /// </summary>
+        /// <param name="name">The name of the import, as `module!import`.</param>
+        std::optional< std::uint32_t > slot( std::string_view name ) const noexcept;
+    };
+}  // namespace vulkan::analysis
\ No newline at end of file
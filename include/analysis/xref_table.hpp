@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "pe/image_view.hpp"
+
+namespace vulkan::analysis
+{
+    /// <summary>
+    /// The kind of a cross reference.
+    /// </summary>
+    enum class xref_kind_t : std::uint8_t
+    {
+        call,
+        jump,
+        data
+    };
+
+    /// <summary>
+    /// A single cross reference from an instruction to an address inside the image.
+    /// </summary>
+    struct xref_t
+    {
+        /// <summary>
+        /// The relative virtual address of the referencing instruction.
+        /// </summary>
+        std::uint32_t source;
+
+        /// <summary>
+        /// The relative virtual address being referenced.
+        /// </summary>
+        std::uint32_t target;
+
+        /// <summary>
+        /// The length of the referencing instruction.
+        /// </summary>
+        std::uint8_t length;
+
+        /// <summary>
+        /// The offset of the 32-bit displacement (or relative branch immediate) within the instruction.
+        /// </summary>
+        std::uint8_t operand;
+
+        /// <summary>
+        /// The kind of the reference.
+        /// </summary>
+        xref_kind_t kind;
+
+        /// <summary>
+        /// Whether the target is a RIP-relative memory operand, rather than the destination of a relative branch.
+        /// </summary>
+        bool indirect;
+    };
+
+    /// <summary>
+    /// A flat table of all cross references found by decoding the functions listed in the exception directory.
+    /// </summary>
+    class xref_table final
+    {
+        std::vector< xref_t > _xrefs;
+
+        explicit xref_table( std::vector< xref_t >&& xrefs ) noexcept;
+
+       public:
+        /// <summary>
+        /// Builds the cross reference table of an image. Every function in the exception directory is decoded with a linear sweep
+        /// in parallel. If the image has no exception directory, all executable sections are swept instead. Only PE32+ images are
+        /// decoded, the table of any other image is empty.
+        /// </summary>
+        /// <param name="image">A snapshot of the image to analyze.</param>
+        /// <returns>The cross references, sorted by source address.</returns>
+        static xref_table build( const pe::image_view& image );
+
+        /// <summary>
+        /// Gets all cross references, sorted by source address.
+        /// </summary>
+        std::span< const xref_t > xrefs( ) const noexcept;
+
+        /// <summary>
+        /// Gets the cross references originating from the instruction at the given address.
+        /// </summary>
+        /// <param name="source">The relative virtual address of the instruction.</param>
+        std::span< const xref_t > from( std::uint32_t source ) const noexcept;
+
+        /// <summary>
+        /// Points a cross reference at a new target, after its instruction was patched.
+        /// </summary>
+        /// <param name="index">The index of the cross reference.</param>
+        /// <param name="target">The relative virtual address now being referenced.</param>
+        void retarget( std::size_t index, std::uint32_t target ) noexcept;
+
+        /// <summary>
+        /// Returns the number of cross references in the table.
+        /// </summary>
+        constexpr std::size_t size( ) const noexcept
+        {
+            return _xrefs.size( );
+        }
+    };
+}  // namespace vulkan::analysis
\ No newline at end of file
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace vulkan::batch
+{
+    /// <summary>
+    /// An input of a batch.
+    /// </summary>
+    struct input_t
+    {
+        std::filesystem::path path;
+
+        /// <summary>
+        /// The address a raw snapshot was taken at. Inputs without one are minidumps.
+        /// </summary>
+        std::optional< std::uintptr_t > base;
+
+        /// <summary>
+        /// The name of the module to dump. Empty for the main module of a minidump, or the file name of a raw snapshot.
+        /// </summary>
+        std::string module_name;
+
+        /// <summary>
+        /// Returns the text that identifies the input in the results manifest.
+        /// </summary>
+        std::string key( ) const;
+    };
+
+    /// <summary>
+    /// Reads the inputs of a batch. A directory yields every minidump (`*.dmp`) in it, sorted by name. Any other file is read as a
+    /// manifest with one input per line and tab separated fields: the path of the input, the hexadecimal address of a raw snapshot (empty
+    /// for a minidump), and the name of the module to dump. Only the path is required. Empty lines and lines starting with `#` are
+    /// skipped, and relative paths are relative to the manifest.
+    /// </summary>
+    /// <param name="path">The directory or manifest.</param>
+    /// <returns>The inputs, or nothing if the path could not be read or a line is malformed.</returns>
+    std::optional< std::vector< input_t > > read_inputs( const std::filesystem::path& path );
+
+    /// <summary>
+    /// The outcome of a job.
+    /// </summary>
+    enum class status_t
+    {
+        done,
+        failed,
+        cancelled,
+    };
+
+    /// <summary>
+    /// The result of a job, as recorded in the results manifest.
+    /// </summary>
+    struct result_t
+    {
+        std::string input;
+        status_t status;
+        double seconds;
+        std::string output;
+        std::string message;
+    };
+
+    /// <summary>
+    /// The results manifest of a batch. It is a tab separated file with one line per finished job, appended to as jobs finish, so that an
+    /// interrupted batch can be resumed: inputs that are recorded as done, and whose output still exists, are skipped by later runs.
+    /// </summary>
+    class result_log final
+    {
+        std::mutex _mutex;
+        std::ofstream _file;
+        std::unordered_set< std::string > _done;
+
+       public:
+        /// <summary>
+        /// Opens a results manifest, reading the jobs that were done by earlier runs.
+        /// </summary>
+        /// <param name="path">The path of the manifest.</param>
+        explicit result_log( const std::filesystem::path& path );
+
+        result_log( const result_log& ) = delete;
+        result_log& operator=( const result_log& ) = delete;
+
+        /// <summary>
+        /// Returns true if the manifest could be opened for writing.
+        /// </summary>
+        bool is_valid( ) const noexcept;
+
+        /// <summary>
+        /// Returns true if an earlier run finished an input.
+        /// </summary>
+        /// <param name="input">The key of the input.</param>
+        bool is_done( std::string_view input ) const;
+
+        /// <summary>
+        /// Records the result of a job. Can be called from any thread.
+        /// </summary>
+        /// <param name="result">The result.</param>
+        void append( const result_t& result );
+    };
+}  // namespace vulkan::batch
\ No newline at end of file
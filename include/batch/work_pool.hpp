@@ -0,0 +1,80 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <stop_token>
+
+namespace vulkan::batch
+{
+    /// <summary>
+    /// A unit of work of a batch.
+    /// </summary>
+    struct task_t
+    {
+        /// <summary>
+        /// The number of bytes of memory the task is expected to hold at once, such as the size of the image it rebuilds.
+        /// </summary>
+        std::size_t cost;
+
+        /// <summary>
+        /// Runs the task. It receives the stop token of the batch, and is expected to report its own failures.
+        /// </summary>
+        std::function< void( std::stop_token ) > run;
+    };
+
+    /// <summary>
+    /// Runs a batch of independent tasks on a fixed number of threads. Every worker has its own queue and only takes from the queues of
+    /// other workers once its own ran dry, so workers do not contend on a shared queue and a worker that drew long tasks hands the rest
+    /// of its queue to the others. Tasks are handed out largest first.
+    ///
+    /// Tasks are only started while the costs of the running tasks fit into the memory budget. A task that does not fit on its own still
+    /// runs, but alone.
+    /// </summary>
+    class work_pool final
+    {
+        std::size_t _workers;
+        std::size_t _memory_budget;
+
+        std::mutex _mutex;
+        std::condition_variable_any _released;
+        std::size_t _memory_used = 0;
+        std::size_t _running = 0;
+
+        /// <summary>
+        /// Waits until a task fits into the memory budget and accounts for it.
+        /// </summary>
+        /// <returns>False if the batch was stopped while waiting.</returns>
+        bool admit( std::size_t cost, std::stop_token stop_token );
+
+        /// <summary>
+        /// Gives the memory of a finished task back to the budget.
+        /// </summary>
+        void release( std::size_t cost );
+
+       public:
+        /// <summary>
+        /// Creates a new pool.
+        /// </summary>
+        /// <param name="workers">The number of tasks to run at once. Zero uses one per hardware thread.</param>
+        /// <param name="memory_budget">The number of bytes the running tasks may hold at once. Zero does not limit them.</param>
+        explicit work_pool( std::size_t workers = 0, std::size_t memory_budget = 0 ) noexcept;
+
+        work_pool( const work_pool& ) = delete;
+        work_pool& operator=( const work_pool& ) = delete;
+
+        /// <summary>
+        /// Returns the number of workers.
+        /// </summary>
+        std::size_t workers( ) const noexcept;
+
+        /// <summary>
+        /// Runs tasks and waits for all of them to finish. Tasks that were not started when the batch is stopped are skipped.
+        /// </summary>
+        /// <param name="tasks">The tasks.</param>
+        /// <param name="stop_token">The associated stop token.</param>
+        void run( std::span< task_t > tasks, std::stop_token stop_token );
+    };
+}  // namespace vulkan::batch
\ No newline at end of file
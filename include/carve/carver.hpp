@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <stop_token>
+#include <vector>
+
+#include "pe/arch.hpp"
+#include "sources/source.hpp"
+
+namespace vulkan::carve
+{
+    /// <summary>
+    /// A mapped image found in captured memory.
+    /// </summary>
+    struct image_t
+    {
+        std::uintptr_t address;
+        pe::arch_t arch;
+        std::uint16_t machine;
+        std::uint16_t characteristics;
+        std::uint32_t time_date_stamp;
+
+        /// <summary>
+        /// The `SizeOfImage` field of the optional header.
+        /// </summary>
+        std::uint32_t declared_size;
+
+        /// <summary>
+        /// The size of the image as laid out by its section table, limited to the memory that was captured.
+        /// </summary>
+        std::uint32_t size;
+
+        /// <summary>
+        /// The number of bytes that were captured contiguously from the start of the image.
+        /// </summary>
+        std::uint64_t mapped_size;
+    };
+
+    /// <summary>
+    /// Validates the headers of a mapped image. Only fields that every loaded image has consistent values for are checked, so the check
+    /// is cheap and rejects the vast majority of stray `MZ` signatures.
+    /// </summary>
+    /// <param name="headers">The first page of the candidate image.</param>
+    /// <returns>The image, with its address and mapped size not yet set, or nothing if the headers are not plausible.</returns>
+    std::optional< image_t > parse_headers( std::span< const std::uint8_t > headers ) noexcept;
+
+    /// <summary>
+    /// Finds every mapped image in captured memory, whether it is in the module list or not. Page-aligned offsets are scanned in
+    /// parallel, directly in the mapping of the capture, and the `MZ` signatures of eight pages are compared at once with SSE2 before
+    /// any headers are validated. Images that lie within an earlier image, such as embedded resources, are not reported.
+    /// </summary>
+    /// <param name="extents">The captured memory, sorted by address.</param>
+    /// <param name="stop_token">The stop token to cancel the scan.</param>
+    /// <returns>The images, in ascending order.</returns>
+    std::vector< image_t > carve( std::span< const sources::extent_t > extents, std::stop_token stop_token );
+}  // namespace vulkan::carve
\ No newline at end of file
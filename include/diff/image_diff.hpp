@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "pe/image_view.hpp"
+
+namespace vulkan::diff
+{
+    /// <summary>
+    /// The differences of a section, matched between the two images by name.
+    /// </summary>
+    struct section_diff_t
+    {
+        std::string name;
+
+        /// <summary>
+        /// The size of the section in the old image, or zero if the section was added.
+        /// </summary>
+        std::uint32_t old_size;
+
+        /// <summary>
+        /// The size of the section in the new image, or zero if the section was removed.
+        /// </summary>
+        std::uint32_t new_size;
+
+        /// <summary>
+        /// The number of pages of the section in the new image.
+        /// </summary>
+        std::size_t pages = 0;
+
+        /// <summary>
+        /// The number of pages that are identical at the same offset.
+        /// </summary>
+        std::size_t identical_pages = 0;
+
+        /// <summary>
+        /// The number of pages whose contents all exist elsewhere in the old section, because code or data was shifted.
+        /// </summary>
+        std::size_t moved_pages = 0;
+
+        /// <summary>
+        /// The number of pages with new contents.
+        /// </summary>
+        std::size_t changed_pages = 0;
+
+        /// <summary>
+        /// The number of bytes with new contents.
+        /// </summary>
+        std::uint64_t changed_bytes = 0;
+    };
+
+    /// <summary>
+    /// A range of changed bytes in the new image.
+    /// </summary>
+    struct range_t
+    {
+        std::uint32_t rva;
+        std::uint32_t size;
+    };
+
+    /// <summary>
+    /// A function of the new image, from its exception directory, that overlaps changed bytes.
+    /// </summary>
+    struct function_diff_t
+    {
+        std::uint32_t begin;
+        std::uint32_t end;
+        std::uint32_t changed_bytes;
+    };
+
+    /// <summary>
+    /// The differences between two images.
+    /// </summary>
+    struct report_t
+    {
+        std::vector< section_diff_t > sections;
+
+        /// <summary>
+        /// The changed ranges, in ascending order.
+        /// </summary>
+        std::vector< range_t > ranges;
+
+        /// <summary>
+        /// The changed functions, in ascending order.
+        /// </summary>
+        std::vector< function_diff_t > functions;
+    };
+
+    /// <summary>
+    /// Compares two dumps of a module. Before comparing, relocated fields, the import address table and the displacements of
+    /// instructions that reference it are masked in both images, so that differences in image base and import resolution are ignored.
+    /// Pages are first compared at the same offset, and pages that differ are then matched against the whole old section with a rolling
+    /// hash, so that shifted code is not reported as changed. Pages are compared in parallel.
+    /// </summary>
+    /// <param name="old_image">A snapshot of the old image.</param>
+    /// <param name="new_image">A snapshot of the new image.</param>
+    /// <returns>The differences, with addresses in the new image.</returns>
+    report_t compare( const pe::image_view& old_image, const pe::image_view& new_image );
+
+    /// <summary>
+    /// Writes a compact, human readable report.
+    /// </summary>
+    /// <param name="stream">The stream to write to.</param>
+    /// <param name="report">The report.</param>
+    void write_report( std::ostream& stream, const report_t& report );
+}  // namespace vulkan::diff
\ No newline at end of file
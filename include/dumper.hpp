@@ -1,18 +1,88 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
+#include <filesystem>
 #include <fstream>
+#include <functional>
+#include <list>
 #include <map>
 #include <memory>
+#include <memory_resource>
+#include <optional>
 #include <stop_token>
 #include <string>
+#include <unordered_set>
 #include <vector>
-#include <wincpp/process.hpp>
 
+#include "analysis/xref_table.hpp"
+#include "memory/arena.hpp"
+#include "pass_manager.hpp"
 #include "pe/image.hpp"
+#include "sources/export_cache.hpp"
+#include "sources/source.hpp"
+#include "store/result_store.hpp"
+#include "watch/delta.hpp"
+#include "watch/watcher.hpp"
 
 namespace vulkan
 {
+    /// <summary>
+    /// The progress of a dump, as reported to the progress callback of the dumper.
+    /// </summary>
+    struct progress_t
+    {
+        /// <summary>
+        /// The pass that is running.
+        /// </summary>
+        std::string_view pass;
+
+        /// <summary>
+        /// The section being read by the "sections" pass, or empty.
+        /// </summary>
+        std::string_view section;
+
+        /// <summary>
+        /// The number of pages of the section that were read so far.
+        /// </summary>
+        std::size_t pages_read = 0;
+
+        /// <summary>
+        /// The number of pages of the section.
+        /// </summary>
+        std::size_t total_pages = 0;
+    };
+
+    /// <summary>
+    /// The parts of a module a targeted dump acquires. The headers and the sections that hold the data directories are always acquired as
+    /// well, so that the output is a coherent image.
+    /// </summary>
+    struct targets_t
+    {
+        /// <summary>
+        /// Ranges of relative virtual addresses, as start and size.
+        /// </summary>
+        std::vector< std::pair< std::uint32_t, std::uint32_t > > ranges;
+
+        /// <summary>
+        /// The names of whole sections.
+        /// </summary>
+        std::vector< std::string > sections;
+
+        /// <summary>
+        /// The start addresses of functions. They are expanded to their full range through the exception directory.
+        /// </summary>
+        std::vector< std::uint32_t > functions;
+
+        /// <summary>
+        /// Returns whether nothing is targeted, in which case the whole module is dumped.
+        /// </summary>
+        bool empty( ) const noexcept
+        {
+            return ranges.empty( ) && sections.empty( ) && functions.empty( );
+        }
+    };
+
     /// <summary>
     /// The dumper class rebuilds a PE file from a memory dump.
     /// </summary>
@@ -26,10 +96,23 @@ namespace vulkan
         {
             std::string _module_name;
             float _target_decryption_factor;
+            double _min_gain_rate = 0.0;
+            std::chrono::duration< double > _deadline = { };
             bool _resolve_imports;
+            bool _rebuild_relocations;
             std::list< std::string > _ignore_sections;
             std::uintptr_t _image_base = -1;
             std::string _minidump_path;
+            std::string _coverage_path;
+            std::string _stream_path;
+            std::size_t _memory_budget = 64 * 1024 * 1024;
+            std::function< void( const progress_t& ) > _progress;
+            std::shared_ptr< sources::export_cache > _export_cache;
+            targets_t _targets;
+            std::chrono::duration< double > _watch_interval = { };
+            std::string _watch_path;
+            std::string _xref_path;
+            std::shared_ptr< store::result_store > _result_store;
 
             explicit options( ) noexcept;
 
@@ -56,10 +139,31 @@ namespace vulkan
             float target_decryption_factor( ) const noexcept;
 
             /// <summary>
-            /// Sets the target decryption factor. This is the factor to use when decrypting the PE.
+            /// Sets the target decryption factor. Acquisition of a code section stops once this fraction of its pages was read.
             /// </summary>
             options& target_decryption_factor( float factor ) noexcept;
 
+            /// <summary>
+            /// Gets the minimum coverage gain per second.
+            /// </summary>
+            double min_gain_rate( ) const noexcept;
+
+            /// <summary>
+            /// Sets the minimum coverage gain, as a fraction of the pages of a section per second. Acquisition of a code section stops
+            /// once the predicted gain drops below this rate. Zero disables the check.
+            /// </summary>
+            options& min_gain_rate( double rate ) noexcept;
+
+            /// <summary>
+            /// Gets the acquisition deadline.
+            /// </summary>
+            std::chrono::duration< double > deadline( ) const noexcept;
+
+            /// <summary>
+            /// Sets the maximum time spent acquiring a single code section. Zero disables the deadline.
+            /// </summary>
+            options& deadline( std::chrono::duration< double > value ) noexcept;
+
             /// <summary>
             /// Gets whether to resolve imports.
             /// </summary>
@@ -70,6 +174,16 @@ namespace vulkan
             /// </summary>
             options& resolve_imports( bool value ) noexcept;
 
+            /// <summary>
+            /// Gets whether to rebuild the relocation directory.
+            /// </summary>
+            bool rebuild_relocations( ) const noexcept;
+
+            /// <summary>
+            /// Sets whether to rebuild the relocation directory if it is missing or unreadable. This is always done when rebasing.
+            /// </summary>
+            options& rebuild_relocations( bool value ) noexcept;
+
             /// <summary>
             /// Gets the list of sections to ignore.
             /// </summary>
@@ -99,37 +213,255 @@ namespace vulkan
             /// This is the path of the minidump file to create. This is used to create a minidump of the process.
             /// </summary>
             options& minidump_path( std::string_view path ) noexcept;
+
+            /// <summary>
+            /// Gets the path of the coverage map to create.
+            /// </summary>
+            std::string_view coverage_path( ) const noexcept;
+
+            /// <summary>
+            /// Sets the path of the coverage map to create. The map classifies every page of the code sections of the dump as read code,
+            /// filler, zeros, data or still encrypted.
+            /// </summary>
+            options& coverage_path( std::string_view path ) noexcept;
+
+            /// <summary>
+            /// Gets the path of the file the image is streamed to.
+            /// </summary>
+            std::string_view stream_path( ) const noexcept;
+
+            /// <summary>
+            /// Sets the path of the file to stream the image to. Sections are written straight into a mapping of the file as they are
+            /// read, and only the headers and the parsed directories are kept in memory. Empty builds the image in memory.
+            /// </summary>
+            options& stream_path( std::string_view path ) noexcept;
+
+            /// <summary>
+            /// Gets the resident memory budget of a streamed image.
+            /// </summary>
+            std::size_t memory_budget( ) const noexcept;
+
+            /// <summary>
+            /// Sets the number of bytes of a streamed image that may be written before they are released from memory.
+            /// </summary>
+            options& memory_budget( std::size_t bytes ) noexcept;
+
+            /// <summary>
+            /// Gets the progress callback.
+            /// </summary>
+            const std::function< void( const progress_t& ) >& progress( ) const noexcept;
+
+            /// <summary>
+            /// Sets a callback that is invoked when a pass starts, and after every sweep over the pages of a code section. Passes run
+            /// concurrently, so the callback may be invoked from several threads at once.
+            /// </summary>
+            options& progress( std::function< void( const progress_t& ) > callback ) noexcept;
+
+            /// <summary>
+            /// Gets the export cache.
+            /// </summary>
+            const std::shared_ptr< sources::export_cache >& export_cache( ) const noexcept;
+
+            /// <summary>
+            /// Sets the cache the exports of the loaded modules are looked up in when resolving imports. Dumps that share a cache only
+            /// enumerate the exports of a module once. If null, every dump uses a cache of its own.
+            /// </summary>
+            options& export_cache( std::shared_ptr< sources::export_cache > cache ) noexcept;
+
+            /// <summary>
+            /// Gets the targets of the dump.
+            /// </summary>
+            const targets_t& targets( ) const noexcept;
+
+            /// <summary>
+            /// Sets the parts of the module to acquire. Pages of code sections outside the targets are neither polled nor waited on,
+            /// sections without targets or data directories are skipped, and the skipped pages are left empty in the output. Empty
+            /// targets dump the whole module.
+            /// </summary>
+            options& targets( targets_t value ) noexcept;
+
+            /// <summary>
+            /// Gets the interval at which the code pages are checked for changes after the dump.
+            /// </summary>
+            std::chrono::duration< double > watch_interval( ) const noexcept;
+
+            /// <summary>
+            /// Sets the interval at which the code pages of a live module are checked for changes once the dump is done. The dump keeps
+            /// running until it is stopped, and writes the pages that changed to a delta file next to the watch path. Zero disables it.
+            /// </summary>
+            options& watch_interval( std::chrono::duration< double > value ) noexcept;
+
+            /// <summary>
+            /// Gets the path the image is saved to before it is watched.
+            /// </summary>
+            std::string_view watch_path( ) const noexcept;
+
+            /// <summary>
+            /// Sets the path the image is saved to before it is watched. The delta files are named after it, followed by their sequence
+            /// number and `.delta`.
+            /// </summary>
+            options& watch_path( std::string_view path ) noexcept;
+
+            /// <summary>
+            /// Gets the path of the cross reference database to create.
+            /// </summary>
+            std::string_view xref_path( ) const noexcept;
+
+            /// <summary>
+            /// Sets the path of the cross reference database to create. The database holds every cross reference of the code of the dump
+            /// and the imports they go through, so that other tools do not have to find them again. Empty disables it.
+            /// </summary>
+            options& xref_path( std::string_view path ) noexcept;
+
+            /// <summary>
+            /// Gets the result store.
+            /// </summary>
+            const std::shared_ptr< store::result_store >& result_store( ) const noexcept;
+
+            /// <summary>
+            /// Sets the store finished dumps are kept in. A dump of a module whose fingerprint and options match a stored dump without
+            /// missing code pages returns the stored image without acquiring anything. A stored dump with missing pages seeds the code
+            /// sections, so that only the pages it missed are polled. Dumps that write a coverage map, a cross reference database or a
+            /// minidump, or that are watched, always run their passes. Null disables the store.
+            /// </summary>
+            options& result_store( std::shared_ptr< store::result_store > value ) noexcept;
         };
 
        private:
+        /// <summary>
+        /// The arena the transient containers of the passes are allocated from. It is released along with the dumper, so nothing that
+        /// outlives the dump, such as the imports of the image, may be allocated from it.
+        /// </summary>
+        std::unique_ptr< memory::arena > _arena = std::make_unique< memory::arena >( );
+
         std::unique_ptr< pe::image > _image = nullptr;
         std::unique_ptr< pe::image > _physical_image = nullptr;
 
-        const wincpp::modules::module_t& _module;
+        const sources::source& _source;
+        sources::module_t _module;
         std::ifstream _file;
 
         options _options;
 
-        explicit dumper( const wincpp::modules::module_t& module, const options& options );
+        /// <summary>
+        /// The number of bytes of a streamed image written since it was last released from memory.
+        /// </summary>
+        std::size_t _resident = 0;
+
+        /// <summary>
+        /// Watches the code pages for changes once the dump is done, if watching is enabled.
+        /// </summary>
+        std::unique_ptr< watch::watcher > _watcher;
+
+        /// <summary>
+        /// The cross references of the code, once they were needed by a pass.
+        /// </summary>
+        std::optional< analysis::xref_table > _xrefs;
+
+        /// <summary>
+        /// The key of the dump in the result store, or empty if it is not stored.
+        /// </summary>
+        std::string _store_key;
+
+        /// <summary>
+        /// The code pages acquired by the stored dump of the same build, sorted by relative virtual address. They are copied into the
+        /// image instead of being polled.
+        /// </summary>
+        std::optional< watch::delta_t > _seed;
+
+        /// <summary>
+        /// The acquired code pages, written to the result store before the image was post-processed.
+        /// </summary>
+        std::optional< std::filesystem::path > _staged;
+
+        /// <summary>
+        /// The number of code pages that were never read.
+        /// </summary>
+        std::size_t _missing_pages = 0;
+
+        /// <summary>
+        /// The code pages that were kept as read although they still looked encrypted, by relative virtual address.
+        /// </summary>
+        std::unordered_set< std::uint32_t > _accepted_pages;
+
+        explicit dumper( const sources::source& source, const sources::module_t& module, const options& options );
+
+        /// <summary>
+        /// Returns the registry of passes run by `dump`. The built-in passes are registered on first use. It is only accessed while it is
+        /// locked, so that passes can be registered while other threads dump.
+        /// </summary>
+        static pass_manager& pass_registry( );
 
         /// <summary>
         /// Gets all imported functions from the modules.
         /// </summary>
         /// <param name="modules">The modules to get the imports from.</param>
-        /// <returns>A list of exported functions used in the PE.</returns>
-        std::list< std::pair< std::uintptr_t, std::shared_ptr< wincpp::modules::module_t::export_t > > > get_imports(
-            const std::vector< std::shared_ptr< wincpp::modules::module_t > >& modules );
+        /// <returns>A list of exported functions used in the PE, allocated from the arena.</returns>
+        std::pmr::vector< std::pair< std::uintptr_t, sources::export_t > > get_imports( const std::vector< sources::module_t >& modules );
+
+        /// <summary>
+        /// Accounts for bytes written to a streamed image, and releases the image from memory once the budget is exceeded.
+        /// </summary>
+        /// <param name="size">The number of bytes written.</param>
+        void charge( std::size_t size ) noexcept;
+
+        /// <summary>
+        /// Invokes the progress callback, if there is one.
+        /// </summary>
+        /// <param name="progress">The progress to report.</param>
+        void report( const progress_t& progress ) const;
+
+        /// <summary>
+        /// Selects the pages of a targeted dump, along with the pages of the data directories.
+        /// </summary>
+        /// <param name="functions">The exception directory, used to find the ends of targeted functions.</param>
+        /// <returns>Whether each page of the module is selected, or nothing if the dump is not targeted.</returns>
+        std::vector< bool > select_pages( std::span< const pe::runtime_function_t > functions ) const;
+
+        /// <summary>
+        /// Returns the cross references of the code. They are found the first time they are needed, after the sections were read, and
+        /// shared by the passes after that. The table only holds addresses, so it does not keep the snapshot it was built from, which
+        /// would be a live view for a streamed image. Passes that call it must declare that they write `resource_t::xrefs`.
+        /// </summary>
+        analysis::xref_table& cross_references( );
+
+        /// <summary>
+        /// Saves the image to the watch path, and then writes the code pages that change to delta files until it is stopped.
+        /// </summary>
+        /// <param name="stop_token">The associated stop token.</param>
+        void watch( std::stop_token stop_token );
 
        public:
         /// <summary>
-        /// Dumps the PE image from memory.
+        /// Dumps the PE image from a source, such as a minidump or a raw snapshot. Static sources are read in a single sweep.
         /// </summary>
-        /// <param name="process">The process to dump from.</param>
+        /// <param name="source">The source to dump from.</param>
         /// <param name="options">The options for the dumper.</param>
         /// <param name="stop_token">The associated stop token.</param>
-        /// <returns>A resolved PE image.</reru
-        static std::unique_ptr< pe::image >
-        dump( const std::unique_ptr< wincpp::process_t >& process, const dumper::options& options, std::stop_token stop_token );
+        /// <returns>A resolved PE image.</returns>
+        static std::unique_ptr< pe::image > dump( const sources::source& source, const dumper::options& options, std::stop_token stop_token );
+
+        /// <summary>
+        /// Registers an additional pass that is run by every subsequent dump. Passes are ordered after the built-in ones whenever they
+        /// access the same resources. Can be called from any thread.
+        /// </summary>
+        /// <param name="pass">The pass to register.</param>
+        static void register_pass( pass_t pass );
+
+        /// <summary>
+        /// Gets the options of the dumper.
+        /// </summary>
+        const options& settings( ) const noexcept;
+
+        /// <summary>
+        /// Gets the source the module is read from.
+        /// </summary>
+        const sources::source& source( ) const noexcept;
+
+        /// <summary>
+        /// Gets the image being reconstructed.
+        /// </summary>
+        const std::unique_ptr< pe::image >& image( ) const noexcept;
 
         /// <summary>
         /// Resolves all of the sections in the PE file.
@@ -140,7 +472,7 @@ namespace vulkan
         /// <summary>
         /// Resolves all of the imports in the PE file.
         /// </summary>
-        void resolve_imports( const std::vector< std::shared_ptr< wincpp::modules::module_t > >& modules );
+        void resolve_imports( const std::vector< sources::module_t >& modules );
 
         /// <summary>
         /// Walks the exception directory and makes sure that all references are valid.
@@ -148,10 +480,13 @@ namespace vulkan
         void resolve_runtime_functions( );
 
         /// <summary>
-        /// Creates and saves a minidump of the process.
+        /// Reconstructs the relocation directory into a new section if it is missing or unreadable.
+        /// </summary>
+        void resolve_relocations( );
+
+        /// <summary>
+        /// Saves the cross reference database, resolving references through the import address table to their imports.
         /// </summary>
-        /// <param name="process">The process to create a minidump of.</param>
-        /// <param name="path">The path to save the minidump to.</param>
-        void save_minidump( const std::unique_ptr< wincpp::process_t >& process, const std::string_view path ) const;
+        void save_xref_database( );
     };
 }  // namespace vulkan
\ No newline at end of file
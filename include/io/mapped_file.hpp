@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace vulkan::io
+{
+    /// <summary>
+    /// A read-only memory mapping of an entire file. Large inputs such as minidumps are only paged in as they are accessed.
+    /// </summary>
+    class mapped_file final
+    {
+        const std::uint8_t* _data = nullptr;
+        std::size_t _size = 0;
+
+#ifdef _WIN32
+        void* _file = nullptr;
+        void* _mapping = nullptr;
+#else
+        int _fd = -1;
+#endif
+
+        /// <summary>
+        /// Unmaps the file and closes all handles.
+        /// </summary>
+        void close( ) noexcept;
+
+       public:
+        /// <summary>
+        /// Maps a file into memory.
+        /// </summary>
+        /// <param name="path">The path of the file.</param>
+        explicit mapped_file( std::string_view path ) noexcept;
+
+        mapped_file( const mapped_file& ) = delete;
+        mapped_file& operator=( const mapped_file& ) = delete;
+
+        mapped_file( mapped_file&& other ) noexcept;
+        mapped_file& operator=( mapped_file&& other ) noexcept;
+
+        ~mapped_file( );
+
+        /// <summary>
+        /// Returns whether the file was mapped successfully. Empty files are never mapped.
+        /// </summary>
+        constexpr bool is_valid( ) const noexcept
+        {
+            return _data != nullptr;
+        }
+
+        /// <summary>
+        /// Returns the contents of the file.
+        /// </summary>
+        constexpr std::span< const std::uint8_t > data( ) const noexcept
+        {
+            return { _data, _size };
+        }
+
+        /// <summary>
+        /// Returns the size of the file in bytes.
+        /// </summary>
+        constexpr std::size_t size( ) const noexcept
+        {
+            return _size;
+        }
+    };
+}  // namespace vulkan::io
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace vulkan::io
+{
+    /// <summary>
+    /// A writable memory mapping of an entire output file. Pages are written back to the file by the system, so an image can be built in
+    /// place without holding all of it in memory. Where the system supports it, the mapping is backed by huge pages.
+    /// </summary>
+    class mapped_output final
+    {
+        std::uint8_t* _data = nullptr;
+        std::size_t _size = 0;
+        std::string _path;
+
+#ifdef _WIN32
+        void* _file = nullptr;
+        void* _mapping = nullptr;
+#else
+        int _fd = -1;
+#endif
+
+        /// <summary>
+        /// Unmaps the file and closes all handles.
+        /// </summary>
+        void close( ) noexcept;
+
+       public:
+        /// <summary>
+        /// Maps a file for writing, creating it if it does not exist.
+        /// </summary>
+        /// <param name="path">The path of the file.</param>
+        /// <param name="size">The size of the file in bytes. The file is extended with zeros if it is smaller.</param>
+        /// <param name="truncate">Whether to discard the previous contents of the file.</param>
+        mapped_output( std::string_view path, std::size_t size, bool truncate = true ) noexcept;
+
+        mapped_output( const mapped_output& ) = delete;
+        mapped_output& operator=( const mapped_output& ) = delete;
+
+        mapped_output( mapped_output&& other ) noexcept;
+        mapped_output& operator=( mapped_output&& other ) noexcept;
+
+        ~mapped_output( );
+
+        /// <summary>
+        /// Returns whether the file was mapped successfully.
+        /// </summary>
+        constexpr bool is_valid( ) const noexcept
+        {
+            return _data != nullptr;
+        }
+
+        /// <summary>
+        /// Returns the contents of the file.
+        /// </summary>
+        constexpr std::span< std::uint8_t > data( ) const noexcept
+        {
+            return { _data, _size };
+        }
+
+        /// <summary>
+        /// Returns the size of the file in bytes.
+        /// </summary>
+        constexpr std::size_t size( ) const noexcept
+        {
+            return _size;
+        }
+
+        /// <summary>
+        /// Returns the path of the file.
+        /// </summary>
+        std::string_view path( ) const noexcept
+        {
+            return _path;
+        }
+
+        /// <summary>
+        /// Writes a range of the mapping back to the file and waits for the write to complete.
+        /// </summary>
+        /// <param name="offset">The offset of the range.</param>
+        /// <param name="size">The size of the range in bytes.</param>
+        /// <returns>True if the range was written, false otherwise.</returns>
+        bool flush( std::size_t offset, std::size_t size ) const noexcept;
+
+        /// <summary>
+        /// Schedules a range of the mapping to be written back and removes its pages from the working set of the process. The contents
+        /// are kept, and are paged in again from the file the next time they are accessed.
+        /// </summary>
+        /// <param name="offset">The offset of the range.</param>
+        /// <param name="size">The size of the range in bytes.</param>
+        void release( std::size_t offset, std::size_t size ) const noexcept;
+    };
+}  // namespace vulkan::io
\ No newline at end of file
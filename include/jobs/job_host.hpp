@@ -0,0 +1,135 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "dumper.hpp"
+#include "sources/export_cache.hpp"
+
+namespace vulkan::jobs
+{
+    /// <summary>
+    /// The state of a dump job.
+    /// </summary>
+    enum class status_t : std::uint8_t
+    {
+        queued,
+        running,
+        finished,
+
+        /// <summary>
+        /// The job was cancelled. If it was already running, the image holds everything that was read until then.
+        /// </summary>
+        cancelled,
+
+        /// <summary>
+        /// The dump threw. The exception is rethrown by the result.
+        /// </summary>
+        failed,
+    };
+
+    /// <summary>
+    /// A dump to run on a job host.
+    /// </summary>
+    struct request_t
+    {
+        /// <summary>
+        /// The source to dump from. The job keeps it alive until the dump finished.
+        /// </summary>
+        std::shared_ptr< const sources::source > source;
+
+        /// <summary>
+        /// The options for the dumper. Progress is reported through their progress callback. If they have no export cache, the cache of
+        /// the host is used.
+        /// </summary>
+        dumper::options options = dumper::options::default_value( );
+    };
+
+    /// <summary>
+    /// A handle to a dump submitted to a job host. Copies refer to the same job.
+    /// </summary>
+    class job final
+    {
+        friend class job_host;
+
+        struct state_t;
+
+        std::shared_ptr< state_t > _state;
+
+        explicit job( std::shared_ptr< state_t > state ) noexcept;
+
+       public:
+        /// <summary>
+        /// Gets the state of the job.
+        /// </summary>
+        status_t status( ) const noexcept;
+
+        /// <summary>
+        /// Requests the job to stop. Queued jobs are dropped, and running jobs stop acquiring pages and finish with what they read.
+        /// </summary>
+        void cancel( ) noexcept;
+
+        /// <summary>
+        /// Gets the result of the job. The image is null if the job was cancelled before it started.
+        /// </summary>
+        std::shared_future< std::shared_ptr< pe::image > > result( ) const noexcept;
+    };
+
+    /// <summary>
+    /// Runs dumps on a fixed set of worker threads, so that a long-lived process can run many dumps without paying for startup every time.
+    /// All jobs of a host share its export cache.
+    /// </summary>
+    class job_host final
+    {
+        std::shared_ptr< sources::export_cache > _exports;
+
+        std::mutex _mutex;
+        std::condition_variable_any _ready;
+        std::deque< std::shared_ptr< job::state_t > > _queue;
+
+        std::vector< std::jthread > _workers;
+
+        /// <summary>
+        /// Runs queued jobs until the worker is stopped.
+        /// </summary>
+        void work( std::stop_token stop_token );
+
+        /// <summary>
+        /// Runs a single job and publishes its result.
+        /// </summary>
+        void run( job::state_t& state, std::stop_token stop_token );
+
+       public:
+        /// <summary>
+        /// Creates a new job host.
+        /// </summary>
+        /// <param name="workers">The number of dumps to run at once. Zero uses one per hardware thread.</param>
+        explicit job_host( std::size_t workers = 0 );
+
+        /// <summary>
+        /// Cancels all jobs and waits for the running ones to finish.
+        /// </summary>
+        ~job_host( );
+
+        job_host( const job_host& ) = delete;
+        job_host& operator=( const job_host& ) = delete;
+
+        /// <summary>
+        /// Queues a dump.
+        /// </summary>
+        /// <param name="request">The dump to run.</param>
+        /// <returns>A handle to the job.</returns>
+        job submit( request_t request );
+
+        /// <summary>
+        /// Gets the export cache shared by the jobs of the host.
+        /// </summary>
+        const std::shared_ptr< sources::export_cache >& exports( ) const noexcept;
+    };
+}  // namespace vulkan::jobs
\ No newline at end of file
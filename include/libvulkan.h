@@ -0,0 +1,182 @@
+#pragma once
+
+#include <stdint.h>
+
+#if defined( _WIN32 )
+#if defined( VULKAN_EXPORTS )
+#define VULKAN_API __declspec( dllexport )
+#else
+#define VULKAN_API __declspec( dllimport )
+#endif
+#else
+#define VULKAN_API
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /// <summary>
+    /// A set of worker threads that run dumps. Jobs of the same host share their caches.
+    /// </summary>
+    typedef struct vulkan_host vulkan_host;
+
+    /// <summary>
+    /// A dump submitted to a host.
+    /// </summary>
+    typedef struct vulkan_job vulkan_job;
+
+    /// <summary>
+    /// The state of a job.
+    /// </summary>
+    typedef enum vulkan_status
+    {
+        VULKAN_STATUS_QUEUED,
+        VULKAN_STATUS_RUNNING,
+        VULKAN_STATUS_FINISHED,
+        VULKAN_STATUS_CANCELLED,
+        VULKAN_STATUS_FAILED,
+    } vulkan_status;
+
+    /// <summary>
+    /// Waits without a timeout.
+    /// </summary>
+#define VULKAN_INFINITE 0xFFFFFFFFu
+
+    /// <summary>
+    /// The options of a dump. Initialize them with `vulkan_dump_options_init` before changing individual fields.
+    /// </summary>
+    typedef struct vulkan_dump_options
+    {
+        /// <summary>
+        /// The module to dump, or null for the main module.
+        /// </summary>
+        const char* module_name;
+
+        /// <summary>
+        /// Stop reading a code section once this fraction of its pages was read.
+        /// </summary>
+        float decryption_factor;
+
+        /// <summary>
+        /// Stop reading a code section once the expected gain drops below this fraction of its pages per second. Zero disables the check.
+        /// </summary>
+        double min_gain_rate;
+
+        /// <summary>
+        /// The maximum number of seconds to spend reading a code section. Zero disables the deadline.
+        /// </summary>
+        double deadline;
+
+        int32_t resolve_imports;
+        int32_t rebuild_relocations;
+
+        /// <summary>
+        /// The image base to rebase the image to, or zero to keep it.
+        /// </summary>
+        uint64_t image_base;
+
+        /// <summary>
+        /// The file to stream the image to, or null to build it in memory.
+        /// </summary>
+        const char* stream_path;
+
+        /// <summary>
+        /// The number of bytes of a streamed image that may be written before they are released from memory.
+        /// </summary>
+        uint64_t memory_budget;
+    } vulkan_dump_options;
+
+    /// <summary>
+    /// Receives the progress of a job. `section` is empty outside of the "sections" pass. Passes run concurrently, so the callback may be
+    /// invoked from several threads at once. The strings are only valid during the call.
+    /// </summary>
+    typedef void ( *vulkan_progress_callback )( const char* pass, const char* section, uint64_t pages_read, uint64_t total_pages, void* user );
+
+    /// <summary>
+    /// Fills the options with their defaults.
+    /// </summary>
+    VULKAN_API void vulkan_dump_options_init( vulkan_dump_options* options );
+
+    /// <summary>
+    /// Creates a host that runs up to `workers` dumps at once. Zero uses one per hardware thread.
+    /// </summary>
+    /// <returns>The host, or null on failure.</returns>
+    VULKAN_API vulkan_host* vulkan_host_create( uint32_t workers );
+
+    /// <summary>
+    /// Cancels all jobs of a host, waits for the running ones and destroys it. Jobs that were not released yet stay valid.
+    /// </summary>
+    VULKAN_API void vulkan_host_destroy( vulkan_host* host );
+
+    /// <summary>
+    /// Queues a dump of a live process.
+    /// </summary>
+    /// <param name="host">The host to run the dump on.</param>
+    /// <param name="process_name">The name of the process.</param>
+    /// <param name="options">The options, or null for the defaults.</param>
+    /// <param name="progress">The progress callback, or null.</param>
+    /// <param name="user">Passed to the progress callback.</param>
+    /// <returns>The job, or null if the process could not be opened.</returns>
+    VULKAN_API vulkan_job* vulkan_dump_process(
+        vulkan_host* host,
+        const char* process_name,
+        const vulkan_dump_options* options,
+        vulkan_progress_callback progress,
+        void* user );
+
+    /// <summary>
+    /// Queues a dump from a minidump that holds the full memory of the process.
+    /// </summary>
+    /// <param name="host">The host to run the dump on.</param>
+    /// <param name="path">The path of the minidump.</param>
+    /// <param name="options">The options, or null for the defaults.</param>
+    /// <param name="progress">The progress callback, or null.</param>
+    /// <param name="user">Passed to the progress callback.</param>
+    /// <returns>The job, or null if the minidump could not be read.</returns>
+    VULKAN_API vulkan_job* vulkan_dump_minidump(
+        vulkan_host* host,
+        const char* path,
+        const vulkan_dump_options* options,
+        vulkan_progress_callback progress,
+        void* user );
+
+    /// <summary>
+    /// Gets the state of a job.
+    /// </summary>
+    VULKAN_API vulkan_status vulkan_job_status( const vulkan_job* job );
+
+    /// <summary>
+    /// Requests a job to stop. A running job finishes with the pages it read so far.
+    /// </summary>
+    VULKAN_API void vulkan_job_cancel( vulkan_job* job );
+
+    /// <summary>
+    /// Waits for a job to complete.
+    /// </summary>
+    /// <param name="job">The job.</param>
+    /// <param name="timeout">The number of milliseconds to wait, or `VULKAN_INFINITE`.</param>
+    /// <returns>The state of the job when the wait ended.</returns>
+    VULKAN_API vulkan_status vulkan_job_wait( vulkan_job* job, uint32_t timeout );
+
+    /// <summary>
+    /// Saves the image of a completed job.
+    /// </summary>
+    /// <returns>Nonzero on success.</returns>
+    VULKAN_API int32_t vulkan_job_save( vulkan_job* job, const char* path );
+
+    /// <summary>
+    /// Gets the error of a failed job.
+    /// </summary>
+    /// <returns>The error message, or null if the job did not fail. It is valid until the job is released.</returns>
+    VULKAN_API const char* vulkan_job_error( vulkan_job* job );
+
+    /// <summary>
+    /// Releases a job handle. The job keeps running unless it was cancelled.
+    /// </summary>
+    VULKAN_API void vulkan_job_release( vulkan_job* job );
+
+#ifdef __cplusplus
+}
+#endif
\ No newline at end of file
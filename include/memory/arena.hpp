@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+
+namespace vulkan::memory
+{
+    /// <summary>
+    /// A memory resource for the short-lived containers of a single dump. Memory is handed out from a growing monotonic buffer and only
+    /// given back when the arena is destroyed, so freeing a node costs nothing and tearing a dump down releases a few large blocks
+    /// instead of every node. Allocations are serialized, so passes that run alongside each other can share an arena. Debug builds also
+    /// count the allocations.
+    /// </summary>
+    class arena final : public std::pmr::memory_resource
+    {
+        mutable std::mutex _mutex;
+        std::pmr::monotonic_buffer_resource _resource;
+
+#ifndef NDEBUG
+        std::size_t _allocations = 0;
+        std::size_t _bytes = 0;
+#endif
+
+       protected:
+        void* do_allocate( std::size_t bytes, std::size_t alignment ) override;
+
+        void do_deallocate( void* p, std::size_t bytes, std::size_t alignment ) override;
+
+        bool do_is_equal( const std::pmr::memory_resource& other ) const noexcept override;
+
+       public:
+        /// <summary>
+        /// The allocations served by an arena.
+        /// </summary>
+        struct stats_t
+        {
+            std::size_t allocations;
+            std::size_t bytes;
+        };
+
+        /// <summary>
+        /// Creates an empty arena. Nothing is allocated until the first allocation.
+        /// </summary>
+        /// <param name="initial_size">The size of the first block taken from the upstream resource. Later blocks grow geometrically.</param>
+        /// <param name="upstream">The resource the blocks are taken from.</param>
+        explicit arena( std::size_t initial_size = 64 * 1024, std::pmr::memory_resource* upstream = std::pmr::get_default_resource( ) ) noexcept;
+
+        /// <summary>
+        /// Returns the number of allocations served and their total size. Only debug builds count them, release builds return zeros.
+        /// </summary>
+        stats_t stats( ) const noexcept;
+    };
+}  // namespace vulkan::memory
\ No newline at end of file
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "io/mapped_file.hpp"
+#include "pe/image.hpp"
+
+namespace vulkan::merge
+{
+    /// <summary>
+    /// A page that was read by several inputs, but with different contents.
+    /// </summary>
+    struct conflict_t
+    {
+        /// <summary>
+        /// The relative virtual address of the page.
+        /// </summary>
+        std::uint32_t rva;
+
+        /// <summary>
+        /// The index of the input the page was taken from.
+        /// </summary>
+        std::size_t chosen;
+
+        /// <summary>
+        /// The number of inputs whose contents differ from the chosen ones.
+        /// </summary>
+        std::size_t dissenting;
+    };
+
+    /// <summary>
+    /// The outcome of a merge.
+    /// </summary>
+    struct result_t
+    {
+        /// <summary>
+        /// The merged image, based at the image base of the first input.
+        /// </summary>
+        std::unique_ptr< pe::image > image;
+
+        /// <summary>
+        /// The number of code pages in the image.
+        /// </summary>
+        std::size_t total_pages = 0;
+
+        /// <summary>
+        /// The number of code pages that were read by at least one input.
+        /// </summary>
+        std::size_t merged_pages = 0;
+
+        /// <summary>
+        /// The number of pages taken from each input.
+        /// </summary>
+        std::vector< std::size_t > contributions;
+
+        /// <summary>
+        /// The pages the inputs disagree on, in ascending order.
+        /// </summary>
+        std::vector< conflict_t > conflicts;
+    };
+
+    /// <summary>
+    /// Combines partial dumps of the same module into a single image. Every input decrypted a different subset of the code pages, and
+    /// the pages that were never read are filled with `0x90`. The merged image takes every page from an input that actually read it, and
+    /// ignores pages that still look encrypted.
+    /// </summary>
+    class merger final
+    {
+        /// <summary>
+        /// A memory-mapped dump and its parsed headers.
+        /// </summary>
+        struct input_t
+        {
+            std::string path;
+            io::mapped_file file;
+            std::uintptr_t image_base;
+            std::uint16_t machine;
+            std::uint32_t time_date_stamp;
+            std::uint32_t entry_point;
+            std::vector< pe::section_header_t > sections;
+        };
+
+        std::vector< input_t > _inputs;
+
+       public:
+        /// <summary>
+        /// Creates a new, empty merger.
+        /// </summary>
+        explicit merger( ) noexcept;
+
+        /// <summary>
+        /// Maps a dump and adds it to the merge. Every dump must be the same build as the first one, judging by the file header and
+        /// the section table.
+        /// </summary>
+        /// <param name="path">The path of the dump.</param>
+        /// <returns>True if the dump was added, false if it could not be read or is a different build.</returns>
+        bool add( std::string_view path ) noexcept;
+
+        /// <summary>
+        /// Returns the number of dumps added so far.
+        /// </summary>
+        constexpr std::size_t count( ) const noexcept
+        {
+            return _inputs.size( );
+        }
+
+        /// <summary>
+        /// Merges the dumps. The code pages are processed in parallel. Pointers in pages taken from dumps that were saved at a different
+        /// image base are relocated to the base of the first dump. When dumps disagree on a page, the contents most of them agree on
+        /// win, and ties go to the dump that was added first.
+        /// </summary>
+        /// <returns>The merged image, or `std::nullopt` if there is nothing to merge.</returns>
+        std::optional< result_t > merge( ) const;
+    };
+}  // namespace vulkan::merge
\ No newline at end of file
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// The structures of the minidump file format, as written by `MiniDumpWriteDump`. They are declared here instead of being taken from
+/// `DbgHelp.h`, so that minidumps can be read on any platform.
+namespace vulkan::minidump
+{
+    /// <summary>
+    /// The signature of a minidump file ("MDMP").
+    /// </summary>
+    static constexpr std::uint32_t SIGNATURE = 0x504D444D;
+
+    /// <summary>
+    /// The implementation specific version that is stored in the low word of the header version.
+    /// </summary>
+    static constexpr std::uint16_t VERSION = 0xA793;
+
+    /// <summary>
+    /// The types of streams this reader understands.
+    /// </summary>
+    enum class stream_type_t : std::uint32_t
+    {
+        module_list = 4,
+        memory_list = 5,
+        memory64_list = 9,
+        memory_info_list = 16,
+    };
+
+    /// <summary>
+    /// The memory state of a committed region (`MEM_COMMIT`).
+    /// </summary>
+    static constexpr std::uint32_t MEM_STATE_COMMIT = 0x1000;
+
+    /// <summary>
+    /// The protection flags of a region that make it unreadable (`PAGE_NOACCESS` and `PAGE_GUARD`).
+    /// </summary>
+    static constexpr std::uint32_t PAGE_PROTECT_NOACCESS = 0x01;
+    static constexpr std::uint32_t PAGE_PROTECT_GUARD = 0x100;
+
+#pragma pack( push, 4 )
+
+    struct location_t
+    {
+        std::uint32_t data_size;
+        std::uint32_t rva;
+    };
+
+    struct header_t
+    {
+        std::uint32_t signature;
+        std::uint32_t version;
+        std::uint32_t number_of_streams;
+        std::uint32_t stream_directory_rva;
+        std::uint32_t checksum;
+        std::uint32_t time_date_stamp;
+        std::uint64_t flags;
+    };
+
+    struct directory_t
+    {
+        std::uint32_t stream_type;
+        location_t location;
+    };
+
+    struct module_t
+    {
+        std::uint64_t base_of_image;
+        std::uint32_t size_of_image;
+        std::uint32_t checksum;
+        std::uint32_t time_date_stamp;
+        std::uint32_t module_name_rva;
+        std::uint8_t version_info[ 52 ];
+        location_t cv_record;
+        location_t misc_record;
+        std::uint64_t reserved0;
+        std::uint64_t reserved1;
+    };
+
+    struct memory_descriptor_t
+    {
+        std::uint64_t start_of_memory_range;
+        location_t memory;
+    };
+
+    struct memory_descriptor64_t
+    {
+        std::uint64_t start_of_memory_range;
+        std::uint64_t data_size;
+    };
+
+    struct memory64_list_t
+    {
+        std::uint64_t number_of_memory_ranges;
+        std::uint64_t base_rva;
+    };
+
+    struct memory_info_list_t
+    {
+        std::uint32_t size_of_header;
+        std::uint32_t size_of_entry;
+        std::uint64_t number_of_entries;
+    };
+
+    struct memory_info_t
+    {
+        std::uint64_t base_address;
+        std::uint64_t allocation_base;
+        std::uint32_t allocation_protect;
+        std::uint32_t alignment1;
+        std::uint64_t region_size;
+        std::uint32_t state;
+        std::uint32_t protect;
+        std::uint32_t type;
+        std::uint32_t alignment2;
+    };
+
+#pragma pack( pop )
+
+    static_assert( sizeof( location_t ) == 8 );
+    static_assert( sizeof( header_t ) == 32 );
+    static_assert( sizeof( directory_t ) == 12 );
+    static_assert( sizeof( module_t ) == 108 );
+    static_assert( offsetof( module_t, module_name_rva ) == 20 );
+    static_assert( sizeof( memory_descriptor_t ) == 16 );
+    static_assert( sizeof( memory_descriptor64_t ) == 16 );
+    static_assert( sizeof( memory64_list_t ) == 16 );
+    static_assert( sizeof( memory_info_list_t ) == 16 );
+    static_assert( sizeof( memory_info_t ) == 48 );
+}  // namespace vulkan::minidump
\ No newline at end of file
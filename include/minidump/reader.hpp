@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "io/mapped_file.hpp"
+
+namespace vulkan::minidump
+{
+    /// <summary>
+    /// A module that was loaded in the process when the minidump was written.
+    /// </summary>
+    struct module_info_t
+    {
+        /// <summary>
+        /// The full path of the module, as recorded in the minidump.
+        /// </summary>
+        std::string path;
+
+        /// <summary>
+        /// The file name of the module.
+        /// </summary>
+        std::string name;
+
+        std::uint64_t base;
+        std::uint32_t size;
+        std::uint32_t checksum;
+        std::uint32_t time_date_stamp;
+    };
+
+    /// <summary>
+    /// A range of memory whose contents were captured in the minidump.
+    /// </summary>
+    struct memory_range_t
+    {
+        std::uint64_t base;
+        std::uint64_t size;
+
+        /// <summary>
+        /// The offset of the contents in the minidump file.
+        /// </summary>
+        std::uint64_t offset;
+    };
+
+    /// <summary>
+    /// The state and protection of a region of memory, from the memory info stream.
+    /// </summary>
+    struct memory_region_t
+    {
+        std::uint64_t base;
+        std::uint64_t size;
+        std::uint32_t state;
+        std::uint32_t protect;
+
+        /// <summary>
+        /// Returns whether the region was committed and readable.
+        /// </summary>
+        bool is_readable( ) const noexcept;
+    };
+
+    /// <summary>
+    /// Reads the module list, memory and memory info streams of a minidump. The file is memory-mapped, so reading a dump only touches the
+    /// pages that are actually needed. The reader does not depend on any Windows API.
+    /// </summary>
+    class reader final
+    {
+        io::mapped_file _file;
+
+        std::vector< module_info_t > _modules;
+        std::vector< memory_range_t > _ranges;
+        std::vector< memory_region_t > _regions;
+
+        bool _is_valid = false;
+
+        /// <summary>
+        /// Parses the stream directory of the minidump.
+        /// </summary>
+        bool parse( ) noexcept;
+
+       public:
+        /// <summary>
+        /// Opens and parses a minidump.
+        /// </summary>
+        /// <param name="path">The path of the minidump.</param>
+        explicit reader( std::string_view path ) noexcept;
+
+        /// <summary>
+        /// Returns whether the minidump was parsed successfully.
+        /// </summary>
+        constexpr bool is_valid( ) const noexcept
+        {
+            return _is_valid;
+        }
+
+        /// <summary>
+        /// Returns the modules of the process, in the order they appear in the minidump (the main module is usually first).
+        /// </summary>
+        const std::vector< module_info_t >& modules( ) const noexcept;
+
+        /// <summary>
+        /// Returns the captured memory ranges, sorted by address.
+        /// </summary>
+        const std::vector< memory_range_t >& ranges( ) const noexcept;
+
+        /// <summary>
+        /// Returns the contents of a captured memory range, directly from the mapping of the file.
+        /// </summary>
+        /// <param name="range">One of the ranges returned by `ranges`.</param>
+        std::span< const std::uint8_t > contents( const memory_range_t& range ) const noexcept;
+
+        /// <summary>
+        /// Returns the memory regions of the process, sorted by address. Empty if the minidump has no memory info stream.
+        /// </summary>
+        const std::vector< memory_region_t >& regions( ) const noexcept;
+
+        /// <summary>
+        /// Finds the module with the given file name. The comparison is case insensitive.
+        /// </summary>
+        /// <param name="name">The file name of the module.</param>
+        /// <returns>The module, or a null pointer if there is no such module.</returns>
+        const module_info_t* find_module( std::string_view name ) const noexcept;
+
+        /// <summary>
+        /// Finds the memory region that contains an address.
+        /// </summary>
+        /// <param name="address">The address.</param>
+        /// <returns>The region, or nothing if the address is not part of any region.</returns>
+        std::optional< memory_region_t > query( std::uint64_t address ) const noexcept;
+
+        /// <summary>
+        /// Reads captured memory. The read stops at the first byte that was not captured.
+        /// </summary>
+        /// <param name="address">The address to read from.</param>
+        /// <param name="out">The buffer to read into.</param>
+        /// <returns>The number of bytes read.</returns>
+        std::size_t read( std::uint64_t address, std::span< std::uint8_t > out ) const noexcept;
+    };
+}  // namespace vulkan::minidump
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace vulkan
+{
+    /// <summary>
+    /// A contiguous range of work items assigned to a single worker.
+    /// </summary>
+    struct chunk_t
+    {
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    /// <summary>
+    /// Splits a number of work items into contiguous chunks, one per available hardware thread.
+    /// </summary>
+    /// <param name="count">The number of work items.</param>
+    /// <param name="grain">The minimum number of items per chunk.</param>
+    /// <returns>The chunks, in ascending order.</returns>
+    inline std::vector< chunk_t > split( std::size_t count, std::size_t grain = 1 )
+    {
+        if ( !count )
+            return { };
+
+        const auto threads = std::max< std::size_t >( 1, std::thread::hardware_concurrency( ) );
+        const auto workers = std::clamp< std::size_t >( count / std::max< std::size_t >( 1, grain ), 1, threads );
+        const auto step = ( count + workers - 1 ) / workers;
+
+        std::vector< chunk_t > chunks;
+        chunks.reserve( workers );
+
+        for ( std::size_t begin = 0; begin < count; begin += step )
+            chunks.push_back( { begin, std::min< std::size_t >( begin + step, count ) } );
+
+        return chunks;
+    }
+
+    /// <summary>
+    /// Invokes a function for every chunk on its own thread and waits for all of them to finish. The function receives the
+    /// index of the chunk, so callers can collect results into per-chunk storage without locking.
+    /// </summary>
+    /// <param name="chunks">The chunks to process.</param>
+    /// <param name="fn">The function to invoke as `fn( index, begin, end )`.</param>
+    template< typename Fn >
+    void parallel_for( const std::vector< chunk_t >& chunks, Fn&& fn )
+    {
+        if ( chunks.size( ) == 1 )
+        {
+            fn( std::size_t{ 0 }, chunks.front( ).begin, chunks.front( ).end );
+            return;
+        }
+
+        std::vector< std::jthread > workers;
+        workers.reserve( chunks.size( ) );
+
+        for ( std::size_t i = 0; i < chunks.size( ); ++i )
+            workers.emplace_back( [ &fn, &chunks, i ]( ) { fn( i, chunks[ i ].begin, chunks[ i ].end ); } );
+    }
+}  // namespace vulkan
\ No newline at end of file
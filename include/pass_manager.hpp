@@ -0,0 +1,144 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+namespace vulkan
+{
+    class dumper;
+
+    /// <summary>
+    /// The parts of a dump that a pass can read or write. Directories live inside the section bytes, so passes that edit a directory in
+    /// place must also declare that they write the sections.
+    /// </summary>
+    enum class resource_t : std::uint32_t
+    {
+        none = 0,
+
+        /// <summary>
+        /// The memory of the target.
+        /// </summary>
+        memory = 1 << 0,
+
+        /// <summary>
+        /// The bytes of the sections (and the layout of the image buffer).
+        /// </summary>
+        sections = 1 << 1,
+
+        /// <summary>
+        /// The DOS, NT and section headers.
+        /// </summary>
+        headers = 1 << 2,
+
+        /// <summary>
+        /// The import directory.
+        /// </summary>
+        imports = 1 << 3,
+
+        /// <summary>
+        /// The relocation directory.
+        /// </summary>
+        relocations = 1 << 4,
+
+        /// <summary>
+        /// The exception directory.
+        /// </summary>
+        exceptions = 1 << 5,
+
+        /// <summary>
+        /// The cross references of the dumper. They are built by the first pass that needs them, so every pass that uses them writes
+        /// them.
+        /// </summary>
+        xrefs = 1 << 6,
+    };
+
+    constexpr resource_t operator|( resource_t a, resource_t b ) noexcept
+    {
+        return static_cast< resource_t >( static_cast< std::uint32_t >( a ) | static_cast< std::uint32_t >( b ) );
+    }
+
+    constexpr resource_t operator&( resource_t a, resource_t b ) noexcept
+    {
+        return static_cast< resource_t >( static_cast< std::uint32_t >( a ) & static_cast< std::uint32_t >( b ) );
+    }
+
+    constexpr bool any( resource_t resources ) noexcept
+    {
+        return resources != resource_t::none;
+    }
+
+    /// <summary>
+    /// A single post-processing step of a dump.
+    /// </summary>
+    struct pass_t
+    {
+        /// <summary>
+        /// The name of the pass, used for logging.
+        /// </summary>
+        std::string name;
+
+        /// <summary>
+        /// The resources the pass reads. Passes that were registered earlier and write any of them run before it.
+        /// </summary>
+        resource_t reads = resource_t::none;
+
+        /// <summary>
+        /// The resources the pass writes. Passes that write a resource never run concurrently with passes that access it.
+        /// </summary>
+        resource_t writes = resource_t::none;
+
+        /// <summary>
+        /// Determines whether the pass should run at all. If empty, the pass is always enabled.
+        /// </summary>
+        std::function< bool( const dumper& ) > enabled;
+
+        /// <summary>
+        /// Runs the pass.
+        /// </summary>
+        std::function< void( dumper&, std::stop_token ) > run;
+    };
+
+    /// <summary>
+    /// Runs a set of passes as a dependency graph. Two passes depend on each other if one of them writes a resource the other one
+    /// accesses, in which case they run in registration order. All other passes run concurrently.
+    /// </summary>
+    class pass_manager final
+    {
+        std::vector< pass_t > _passes;
+
+        /// <summary>
+        /// The time every pass took the last time it ran.
+        /// </summary>
+        std::vector< std::chrono::steady_clock::duration > _elapsed;
+
+       public:
+        /// <summary>
+        /// Registers a new pass. Passes are ordered by registration when they depend on each other.
+        /// </summary>
+        /// <param name="pass">The pass to register.</param>
+        void add( pass_t pass );
+
+        /// <summary>
+        /// Runs all enabled passes. Independent passes are run on separate threads.
+        /// </summary>
+        /// <param name="d">The dumper to run the passes on.</param>
+        /// <param name="stop_token">The associated stop token.</param>
+        /// <param name="started">Invoked right before a pass runs, on the thread that runs it.</param>
+        void run( dumper& d, std::stop_token stop_token, const std::function< void( const pass_t& ) >& started = { } );
+
+        /// <summary>
+        /// Returns the registered passes.
+        /// </summary>
+        const std::vector< pass_t >& passes( ) const noexcept;
+
+        /// <summary>
+        /// Returns the time the pass with the given name took the last time it ran.
+        /// </summary>
+        /// <param name="name">The name of the pass.</param>
+        std::chrono::steady_clock::duration elapsed( std::string_view name ) const noexcept;
+    };
+}  // namespace vulkan
\ No newline at end of file
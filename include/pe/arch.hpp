@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+#include "pe/format.hpp"
+
+namespace vulkan::pe
+{
+    /// <summary>
+    /// The layout of a 32-bit (PE32) image.
+    /// </summary>
+    struct pe32
+    {
+        using nt_headers_t = nt_headers32_t;
+        using optional_header_t = optional_header32_t;
+        using thunk_t = thunk_data32_t;
+
+        /// <summary>
+        /// The type of an absolute address in the image, such as an import address table entry.
+        /// </summary>
+        using pointer_t = std::uint32_t;
+
+        static constexpr std::uint16_t magic = OPTIONAL_HDR32_MAGIC;
+        static constexpr pointer_t ordinal_flag = ORDINAL_FLAG32;
+
+        /// <summary>
+        /// The base relocation type of an absolute address.
+        /// </summary>
+        static constexpr std::uint8_t pointer_relocation = REL_BASED_HIGHLOW;
+    };
+
+    /// <summary>
+    /// The layout of a 64-bit (PE32+) image.
+    /// </summary>
+    struct pe64
+    {
+        using nt_headers_t = nt_headers64_t;
+        using optional_header_t = optional_header64_t;
+        using thunk_t = thunk_data64_t;
+
+        /// <summary>
+        /// The type of an absolute address in the image, such as an import address table entry.
+        /// </summary>
+        using pointer_t = std::uint64_t;
+
+        static constexpr std::uint16_t magic = OPTIONAL_HDR64_MAGIC;
+        static constexpr pointer_t ordinal_flag = ORDINAL_FLAG64;
+
+        /// <summary>
+        /// The base relocation type of an absolute address.
+        /// </summary>
+        static constexpr std::uint8_t pointer_relocation = REL_BASED_DIR64;
+    };
+
+    /// <summary>
+    /// The layout of an image, as selected by the magic of its optional header.
+    /// </summary>
+    enum class arch_t : std::uint8_t
+    {
+        unknown,
+        pe32,
+        pe64,
+    };
+
+    /// <summary>
+    /// Returns the layout that belongs to the magic of an optional header.
+    /// </summary>
+    /// <param name="magic">The `OptionalHeader.Magic` field.</param>
+    /// <returns>The layout, or `arch_t::unknown` if the magic is not recognized.</returns>
+    constexpr arch_t arch_of( std::uint16_t magic ) noexcept
+    {
+        switch ( magic )
+        {
+            case pe32::magic: return arch_t::pe32;
+            case pe64::magic: return arch_t::pe64;
+            default: return arch_t::unknown;
+        }
+    }
+
+    /// <summary>
+    /// Invokes a generic callable with the layout type of an image, so that the branch on the layout is taken once and the code inside
+    /// the callable is compiled separately for each layout. Unknown layouts are treated as PE32+.
+    /// </summary>
+    /// <param name="arch">The layout of the image.</param>
+    /// <param name="fn">A callable that accepts both `pe32` and `pe64`.</param>
+    /// <returns>The result of the callable.</returns>
+    template< typename Fn >
+    constexpr decltype( auto ) dispatch( arch_t arch, Fn&& fn )
+    {
+        if ( arch == arch_t::pe32 )
+            return std::forward< Fn >( fn )( pe32{ } );
+
+        return std::forward< Fn >( fn )( pe64{ } );
+    }
+}  // namespace vulkan::pe
\ No newline at end of file
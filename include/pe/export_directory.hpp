@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "pe/format.hpp"
+
+namespace vulkan::pe
+{
+    class image;
+
+    /// <summary>
+    /// The abstract representation of the export directory in a PE image.
+    /// </summary>
+    class export_directory final
+    {
+        friend class image;
+
+       public:
+        /// <summary>
+        /// An abstract representation of an export in the export directory.
+        /// </summary>
+        struct export_t
+        {
+            /// <summary>
+            /// The name of the export. Empty if the export is only exported by ordinal.
+            /// </summary>
+            std::string name;
+
+            /// <summary>
+            /// The ordinal of the export (including the ordinal base).
+            /// </summary>
+            std::uint16_t ordinal;
+
+            /// <summary>
+            /// The relative virtual address of the export. Zero if the export is forwarded.
+            /// </summary>
+            std::uint32_t rva;
+
+            /// <summary>
+            /// The forwarder string (`module.function` or `module.#ordinal`), if the export is forwarded.
+            /// </summary>
+            std::string forwarder;
+        };
+
+       private:
+        std::string _module_name;
+        std::vector< export_t > _exports;
+
+        /// <summary>
+        /// Creates a new export directory class instance.
+        /// </summary>
+        explicit export_directory( ) noexcept;
+
+        /// <summary>
+        /// Refreshes the export directory by parsing the image.
+        /// </summary>
+        void refresh( const image *img ) noexcept;
+
+       public:
+        /// <summary>
+        /// Parses an export directory that was read without the rest of the image. Names and tables outside of the bytes are skipped,
+        /// which is rare, since linkers emit them inside of the directory.
+        /// </summary>
+        /// <param name="bytes">The bytes of the image, starting at `base`.</param>
+        /// <param name="base">The relative virtual address of the first byte.</param>
+        /// <param name="directory">The export data directory of the image.</param>
+        /// <returns>The exports in the directory, ordered by ordinal.</returns>
+        static std::vector< export_t > parse( std::span< const std::uint8_t > bytes, std::uint32_t base, const data_directory_t &directory ) noexcept;
+
+        /// <summary>
+        /// Returns the name of the module, as recorded in the export directory.
+        /// </summary>
+        std::string_view module_name( ) const noexcept;
+
+        /// <summary>
+        /// Returns the exports in the export directory, ordered by ordinal.
+        /// </summary>
+        const std::vector< export_t > &exports( ) const noexcept;
+
+        /// <summary>
+        /// Returns the export with the specified name.
+        /// </summary>
+        /// <param name="name">The name of the export.</param>
+        /// <returns>The export, or a null pointer if there is no such export.</returns>
+        const export_t *find( std::string_view name ) const noexcept;
+
+        /// <summary>
+        /// Returns the export with the specified ordinal.
+        /// </summary>
+        /// <param name="ordinal">The ordinal of the export (including the ordinal base).</param>
+        /// <returns>The export, or a null pointer if there is no such export.</returns>
+        const export_t *find( std::uint16_t ordinal ) const noexcept;
+    };
+}  // namespace vulkan::pe
\ No newline at end of file
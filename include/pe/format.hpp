@@ -0,0 +1,344 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// The structures of the PE file format. They are declared here instead of being taken from `windows.h`, so that images can be
+/// reconstructed on any platform. The fields keep the names of the specification.
+namespace vulkan::pe
+{
+    /// <summary>
+    /// The signature of the DOS header ("MZ").
+    /// </summary>
+    static constexpr std::uint16_t DOS_SIGNATURE = 0x5A4D;
+
+    /// <summary>
+    /// The signature of the NT headers ("PE\0\0").
+    /// </summary>
+    static constexpr std::uint32_t NT_SIGNATURE = 0x00004550;
+
+    /// <summary>
+    /// The magic of the optional header of PE32 and PE32+ images.
+    /// </summary>
+    static constexpr std::uint16_t OPTIONAL_HDR32_MAGIC = 0x10B;
+    static constexpr std::uint16_t OPTIONAL_HDR64_MAGIC = 0x20B;
+
+    static constexpr std::uint32_t NUMBEROF_DIRECTORY_ENTRIES = 16;
+    static constexpr std::uint32_t SIZEOF_SHORT_NAME = 8;
+
+    /// <summary>
+    /// The indices of the data directories.
+    /// </summary>
+    static constexpr std::uint32_t DIRECTORY_ENTRY_EXPORT = 0;
+    static constexpr std::uint32_t DIRECTORY_ENTRY_IMPORT = 1;
+    static constexpr std::uint32_t DIRECTORY_ENTRY_RESOURCE = 2;
+    static constexpr std::uint32_t DIRECTORY_ENTRY_EXCEPTION = 3;
+    static constexpr std::uint32_t DIRECTORY_ENTRY_SECURITY = 4;
+    static constexpr std::uint32_t DIRECTORY_ENTRY_BASERELOC = 5;
+    static constexpr std::uint32_t DIRECTORY_ENTRY_DEBUG = 6;
+    static constexpr std::uint32_t DIRECTORY_ENTRY_IAT = 12;
+
+    /// <summary>
+    /// The characteristics of the file header.
+    /// </summary>
+    static constexpr std::uint16_t FILE_RELOCS_STRIPPED = 0x0001;
+    static constexpr std::uint16_t FILE_EXECUTABLE_IMAGE = 0x0002;
+    static constexpr std::uint16_t FILE_DLL = 0x2000;
+
+    /// <summary>
+    /// The characteristics of a section header.
+    /// </summary>
+    static constexpr std::uint32_t SCN_CNT_CODE = 0x00000020;
+    static constexpr std::uint32_t SCN_CNT_INITIALIZED_DATA = 0x00000040;
+    static constexpr std::uint32_t SCN_CNT_UNINITIALIZED_DATA = 0x00000080;
+    static constexpr std::uint32_t SCN_MEM_DISCARDABLE = 0x02000000;
+    static constexpr std::uint32_t SCN_MEM_EXECUTE = 0x20000000;
+    static constexpr std::uint32_t SCN_MEM_READ = 0x40000000;
+    static constexpr std::uint32_t SCN_MEM_WRITE = 0x80000000;
+
+    /// <summary>
+    /// The types of base relocations, as stored in the upper four bits of an entry.
+    /// </summary>
+    static constexpr std::uint8_t REL_BASED_ABSOLUTE = 0;
+    static constexpr std::uint8_t REL_BASED_HIGH = 1;
+    static constexpr std::uint8_t REL_BASED_LOW = 2;
+    static constexpr std::uint8_t REL_BASED_HIGHLOW = 3;
+    static constexpr std::uint8_t REL_BASED_HIGHADJ = 4;
+    static constexpr std::uint8_t REL_BASED_DIR64 = 10;
+
+    /// <summary>
+    /// The bit of a thunk that marks an import by ordinal.
+    /// </summary>
+    static constexpr std::uint32_t ORDINAL_FLAG32 = 0x80000000;
+    static constexpr std::uint64_t ORDINAL_FLAG64 = 0x8000000000000000;
+
+#pragma pack( push, 4 )
+
+    struct dos_header_t
+    {
+        std::uint16_t e_magic;
+        std::uint16_t e_cblp;
+        std::uint16_t e_cp;
+        std::uint16_t e_crlc;
+        std::uint16_t e_cparhdr;
+        std::uint16_t e_minalloc;
+        std::uint16_t e_maxalloc;
+        std::uint16_t e_ss;
+        std::uint16_t e_sp;
+        std::uint16_t e_csum;
+        std::uint16_t e_ip;
+        std::uint16_t e_cs;
+        std::uint16_t e_lfarlc;
+        std::uint16_t e_ovno;
+        std::uint16_t e_res[ 4 ];
+        std::uint16_t e_oemid;
+        std::uint16_t e_oeminfo;
+        std::uint16_t e_res2[ 10 ];
+        std::int32_t e_lfanew;
+    };
+
+    struct file_header_t
+    {
+        std::uint16_t Machine;
+        std::uint16_t NumberOfSections;
+        std::uint32_t TimeDateStamp;
+        std::uint32_t PointerToSymbolTable;
+        std::uint32_t NumberOfSymbols;
+        std::uint16_t SizeOfOptionalHeader;
+        std::uint16_t Characteristics;
+    };
+
+    struct data_directory_t
+    {
+        std::uint32_t VirtualAddress;
+        std::uint32_t Size;
+    };
+
+    struct optional_header32_t
+    {
+        std::uint16_t Magic;
+        std::uint8_t MajorLinkerVersion;
+        std::uint8_t MinorLinkerVersion;
+        std::uint32_t SizeOfCode;
+        std::uint32_t SizeOfInitializedData;
+        std::uint32_t SizeOfUninitializedData;
+        std::uint32_t AddressOfEntryPoint;
+        std::uint32_t BaseOfCode;
+        std::uint32_t BaseOfData;
+        std::uint32_t ImageBase;
+        std::uint32_t SectionAlignment;
+        std::uint32_t FileAlignment;
+        std::uint16_t MajorOperatingSystemVersion;
+        std::uint16_t MinorOperatingSystemVersion;
+        std::uint16_t MajorImageVersion;
+        std::uint16_t MinorImageVersion;
+        std::uint16_t MajorSubsystemVersion;
+        std::uint16_t MinorSubsystemVersion;
+        std::uint32_t Win32VersionValue;
+        std::uint32_t SizeOfImage;
+        std::uint32_t SizeOfHeaders;
+        std::uint32_t CheckSum;
+        std::uint16_t Subsystem;
+        std::uint16_t DllCharacteristics;
+        std::uint32_t SizeOfStackReserve;
+        std::uint32_t SizeOfStackCommit;
+        std::uint32_t SizeOfHeapReserve;
+        std::uint32_t SizeOfHeapCommit;
+        std::uint32_t LoaderFlags;
+        std::uint32_t NumberOfRvaAndSizes;
+        data_directory_t DataDirectory[ NUMBEROF_DIRECTORY_ENTRIES ];
+    };
+
+    struct optional_header64_t
+    {
+        std::uint16_t Magic;
+        std::uint8_t MajorLinkerVersion;
+        std::uint8_t MinorLinkerVersion;
+        std::uint32_t SizeOfCode;
+        std::uint32_t SizeOfInitializedData;
+        std::uint32_t SizeOfUninitializedData;
+        std::uint32_t AddressOfEntryPoint;
+        std::uint32_t BaseOfCode;
+        std::uint64_t ImageBase;
+        std::uint32_t SectionAlignment;
+        std::uint32_t FileAlignment;
+        std::uint16_t MajorOperatingSystemVersion;
+        std::uint16_t MinorOperatingSystemVersion;
+        std::uint16_t MajorImageVersion;
+        std::uint16_t MinorImageVersion;
+        std::uint16_t MajorSubsystemVersion;
+        std::uint16_t MinorSubsystemVersion;
+        std::uint32_t Win32VersionValue;
+        std::uint32_t SizeOfImage;
+        std::uint32_t SizeOfHeaders;
+        std::uint32_t CheckSum;
+        std::uint16_t Subsystem;
+        std::uint16_t DllCharacteristics;
+        std::uint64_t SizeOfStackReserve;
+        std::uint64_t SizeOfStackCommit;
+        std::uint64_t SizeOfHeapReserve;
+        std::uint64_t SizeOfHeapCommit;
+        std::uint32_t LoaderFlags;
+        std::uint32_t NumberOfRvaAndSizes;
+        data_directory_t DataDirectory[ NUMBEROF_DIRECTORY_ENTRIES ];
+    };
+
+    struct nt_headers32_t
+    {
+        std::uint32_t Signature;
+        file_header_t FileHeader;
+        optional_header32_t OptionalHeader;
+    };
+
+    struct nt_headers64_t
+    {
+        std::uint32_t Signature;
+        file_header_t FileHeader;
+        optional_header64_t OptionalHeader;
+    };
+
+    /// <summary>
+    /// The NT headers of an image of either layout. Only the file header and the optional header fields up to `BaseOfCode` and from
+    /// `SectionAlignment` to `DllCharacteristics` can be read through it; see `arch.hpp` for the rest.
+    /// </summary>
+    using nt_headers_t = nt_headers64_t;
+
+    struct section_header_t
+    {
+        std::uint8_t Name[ SIZEOF_SHORT_NAME ];
+
+        union
+        {
+            std::uint32_t PhysicalAddress;
+            std::uint32_t VirtualSize;
+        } Misc;
+
+        std::uint32_t VirtualAddress;
+        std::uint32_t SizeOfRawData;
+        std::uint32_t PointerToRawData;
+        std::uint32_t PointerToRelocations;
+        std::uint32_t PointerToLinenumbers;
+        std::uint16_t NumberOfRelocations;
+        std::uint16_t NumberOfLinenumbers;
+        std::uint32_t Characteristics;
+    };
+
+    struct import_descriptor_t
+    {
+        union
+        {
+            std::uint32_t Characteristics;
+            std::uint32_t OriginalFirstThunk;
+        };
+
+        std::uint32_t TimeDateStamp;
+        std::uint32_t ForwarderChain;
+        std::uint32_t Name;
+        std::uint32_t FirstThunk;
+    };
+
+    struct import_by_name_t
+    {
+        std::uint16_t Hint;
+        char Name[ 1 ];
+    };
+
+    struct thunk_data32_t
+    {
+        union
+        {
+            std::uint32_t ForwarderString;
+            std::uint32_t Function;
+            std::uint32_t Ordinal;
+            std::uint32_t AddressOfData;
+        } u1;
+    };
+
+    struct thunk_data64_t
+    {
+        union
+        {
+            std::uint64_t ForwarderString;
+            std::uint64_t Function;
+            std::uint64_t Ordinal;
+            std::uint64_t AddressOfData;
+        } u1;
+    };
+
+    struct export_directory_t
+    {
+        std::uint32_t Characteristics;
+        std::uint32_t TimeDateStamp;
+        std::uint16_t MajorVersion;
+        std::uint16_t MinorVersion;
+        std::uint32_t Name;
+        std::uint32_t Base;
+        std::uint32_t NumberOfFunctions;
+        std::uint32_t NumberOfNames;
+        std::uint32_t AddressOfFunctions;
+        std::uint32_t AddressOfNames;
+        std::uint32_t AddressOfNameOrdinals;
+    };
+
+    struct base_relocation_t
+    {
+        std::uint32_t VirtualAddress;
+        std::uint32_t SizeOfBlock;
+    };
+
+    struct runtime_function_t
+    {
+        std::uint32_t BeginAddress;
+        std::uint32_t EndAddress;
+
+        union
+        {
+            std::uint32_t UnwindInfoAddress;
+            std::uint32_t UnwindData;
+        };
+    };
+
+#pragma pack( pop )
+
+    static_assert( sizeof( dos_header_t ) == 64 );
+    static_assert( offsetof( dos_header_t, e_lfanew ) == 60 );
+    static_assert( sizeof( file_header_t ) == 20 );
+    static_assert( sizeof( data_directory_t ) == 8 );
+    static_assert( sizeof( optional_header32_t ) == 224 );
+    static_assert( offsetof( optional_header32_t, ImageBase ) == 28 );
+    static_assert( offsetof( optional_header32_t, DataDirectory ) == 96 );
+    static_assert( sizeof( optional_header64_t ) == 240 );
+    static_assert( offsetof( optional_header64_t, ImageBase ) == 24 );
+    static_assert( offsetof( optional_header64_t, DataDirectory ) == 112 );
+    static_assert( offsetof( optional_header32_t, SectionAlignment ) == offsetof( optional_header64_t, SectionAlignment ) );
+    static_assert( offsetof( optional_header32_t, DllCharacteristics ) == offsetof( optional_header64_t, DllCharacteristics ) );
+    static_assert( sizeof( nt_headers32_t ) == 248 );
+    static_assert( sizeof( nt_headers64_t ) == 264 );
+    static_assert( offsetof( nt_headers32_t, OptionalHeader ) == offsetof( nt_headers64_t, OptionalHeader ) );
+    static_assert( sizeof( section_header_t ) == 40 );
+    static_assert( sizeof( import_descriptor_t ) == 20 );
+    static_assert( sizeof( thunk_data32_t ) == 4 );
+    static_assert( sizeof( thunk_data64_t ) == 8 );
+    static_assert( sizeof( export_directory_t ) == 40 );
+    static_assert( sizeof( base_relocation_t ) == 8 );
+    static_assert( sizeof( runtime_function_t ) == 12 );
+
+    /// <summary>
+    /// Returns the first section header, which follows the optional header.
+    /// </summary>
+    /// <param name="nt_headers">The NT headers of an image of either layout.</param>
+    inline section_header_t* first_section( nt_headers_t* nt_headers ) noexcept
+    {
+        return reinterpret_cast< section_header_t* >(
+            reinterpret_cast< std::uint8_t* >( nt_headers ) + offsetof( nt_headers_t, OptionalHeader ) + nt_headers->FileHeader.SizeOfOptionalHeader );
+    }
+
+    /// <summary>
+    /// Returns the first section header, which follows the optional header.
+    /// </summary>
+    /// <param name="nt_headers">The NT headers of an image of either layout.</param>
+    inline const section_header_t* first_section( const nt_headers_t* nt_headers ) noexcept
+    {
+        return first_section( const_cast< nt_headers_t* >( nt_headers ) );
+    }
+}  // namespace vulkan::pe
\ No newline at end of file
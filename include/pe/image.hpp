@@ -1,10 +1,16 @@
 #pragma once
 
+#include <memory>
+#include <mutex>
 #include <span>
 #include <vector>
-#include <wincpp/process.hpp>
 
+#include "io/mapped_output.hpp"
+#include "pe/arch.hpp"
+#include "pe/export_directory.hpp"
+#include "pe/image_view.hpp"
 #include "pe/import_directory.hpp"
+#include "pe/relocation_directory.hpp"
 #include "pe/section_headers.hpp"
 
 namespace vulkan::pe
@@ -15,20 +21,86 @@ namespace vulkan::pe
     class image
     {
         mutable std::vector< std::uint8_t > _buffer;
-        mutable std::unique_ptr< section_headers > _section_headers;
-        mutable std::unique_ptr< import_directory > _import_directory;
 
-        PIMAGE_DOS_HEADER _dos_header = nullptr;
-        PIMAGE_NT_HEADERS _nt_headers = nullptr;
+        /// <summary>
+        /// The output file that holds the bytes instead of `_buffer`, if the image is built in place.
+        /// </summary>
+        std::shared_ptr< io::mapped_output > _mapping;
+        mutable std::unique_ptr< pe::section_headers > _section_headers;
+        mutable std::unique_ptr< pe::import_directory > _import_directory;
+        mutable std::unique_ptr< pe::relocation_directory > _relocation_directory;
+        mutable std::unique_ptr< pe::export_directory > _export_directory;
+        mutable std::vector< runtime_function_t > _runtime_functions;
+        mutable std::uint32_t _checksum = 0;
+
+        dos_header_t* _dos_header = nullptr;
+        nt_headers_t* _nt_headers = nullptr;
+
+        arch_t _arch = arch_t::unknown;
 
         bool _is_valid = false;
 
+        /// <summary>
+        /// The edit epoch of the buffer. It is bumped every time the buffer may have been modified.
+        /// </summary>
+        std::uint64_t _epoch = 1;
+
+        /// <summary>
+        /// The epochs at which the cached directories were last parsed. Zero means never.
+        /// </summary>
+        mutable struct
+        {
+            std::uint64_t imports = 0;
+            std::uint64_t relocations = 0;
+            std::uint64_t exports = 0;
+            std::uint64_t exceptions = 0;
+            std::uint64_t checksum = 0;
+        } _parsed;
+
+        /// <summary>
+        /// Serializes the lazy parsing of the directories, so that concurrent readers do not race on the caches.
+        /// </summary>
+        mutable std::mutex _parse_mutex;
+
+        /// <summary>
+        /// Validates the headers and prepares the section headers of a freshly created image.
+        /// </summary>
+        /// <param name="mapped">Whether the bytes are laid out as they are mapped in memory.</param>
+        void initialize( bool mapped );
+
+        /// <summary>
+        /// Returns the bytes of the image, wherever they are held.
+        /// </summary>
+        std::span< std::uint8_t > storage( ) const noexcept;
+
+        /// <summary>
+        /// Inserts bytes at an offset. A mapped image is moved to a larger mapping of the same file. Snapshots of the old mapping stay
+        /// valid to read, but since both mappings share the file, the bytes after the offset move in them as well.
+        /// </summary>
+        /// <param name="offset">The offset to insert at.</param>
+        /// <param name="data">The bytes to insert.</param>
+        /// <returns>True if the bytes were inserted, false otherwise.</returns>
+        bool insert( std::size_t offset, std::span< const std::uint8_t > data );
+
         /// <summary>
         /// Computes the checksum of the image.
         /// </summary>
         /// <returns>The checksum of the image.</returns>
         std::uint32_t compute_checksum( ) const noexcept;
 
+        /// <summary>
+        /// Returns whether a cache parsed at the given epoch is out of date, and marks it as up to date.
+        /// </summary>
+        bool is_stale( std::uint64_t& parsed ) const noexcept;
+
+        /// <summary>
+        /// Applies the base relocations of the image for a specific layout.
+        /// </summary>
+        /// <typeparam name="Arch">The layout of the image.</typeparam>
+        /// <param name="base">The new base address.</param>
+        template< typename Arch >
+        void rebase( std::uintptr_t base ) noexcept;
+
        public:
         /// <summary>
         /// Creates a new image from a buffer.
@@ -38,34 +110,101 @@ namespace vulkan::pe
         explicit image( const std::vector< std::uint8_t >& buffer, bool mapped = true );
 
         /// <summary>
-        /// Creates a new image from a loaded module.
+        /// Creates a new image that is built in place in an output file. Only the pages that are being worked on are held in memory.
+        /// </summary>
+        /// <param name="mapping">The mapping of the output file, which already holds the headers.</param>
+        /// <param name="mapped">Whether the bytes are laid out as they are mapped in memory.</param>
+        explicit image( std::shared_ptr< io::mapped_output > mapping, bool mapped = true );
+
+        /// <summary>
+        /// Returns the bytes of the image. Since they may be written through the span, the image is marked as modified. Re-obtain the
+        /// span (or call `touch`) after editing through a span that was obtained earlier, and after adding or extending sections.
+        /// </summary>
+        std::span< std::uint8_t > buffer( ) noexcept;
+
+        /// <summary>
+        /// Returns the bytes of the image for reading.
         /// </summary>
-        /// <param name="module">The module.</param>
-        static std::unique_ptr< image > create( const wincpp::modules::module_t& module );
+        std::span< const std::uint8_t > buffer( ) const noexcept;
 
         /// <summary>
-        /// Returns a reference to the internal buffer.
+        /// Gets the output file the image is built in, or a null pointer if the image is held in memory.
         /// </summary>
-        std::vector< std::uint8_t >& buffer( ) const noexcept;
+        const std::shared_ptr< io::mapped_output >& mapping( ) const noexcept
+        {
+            return _mapping;
+        }
+
+        /// <summary>
+        /// Writes everything past the headers of an image that is built in place back to its file and drops it from memory. It is paged
+        /// in again when it is next accessed. Does nothing for images held in memory.
+        /// </summary>
+        void release( ) const noexcept;
+
+        /// <summary>
+        /// Marks the image as modified, so that the cached directories are parsed again the next time they are accessed.
+        /// </summary>
+        void touch( ) noexcept;
+
+        /// <summary>
+        /// Returns the edit epoch of the image. It changes every time the image may have been modified.
+        /// </summary>
+        constexpr std::uint64_t epoch( ) const noexcept
+        {
+            return _epoch;
+        }
 
         /// <summary>
         /// Gets the section headers of the image.
         /// </summary>
         /// <returns>A pointer to the section headers.</returns>
-        std::unique_ptr< section_headers >& section_headers( ) const noexcept;
+        std::unique_ptr< pe::section_headers >& section_headers( ) const noexcept;
 
         /// <summary>
-        /// Gets the import directory of the image.
+        /// Gets the import directory of the image. The directory is parsed on first access, and again whenever the image was modified
+        /// since. Parsed imports are merged into the ones that were already added.
         /// </summary>
         /// <returns>A pointer to the import directory.</returns>
-        std::unique_ptr< import_directory >& import_directory( ) const noexcept;
+        std::unique_ptr< pe::import_directory >& import_directory( ) const noexcept;
+
+        /// <summary>
+        /// Gets the relocation directory of the image. The directory is parsed on first access, and again whenever the image was
+        /// modified since.
+        /// </summary>
+        /// <returns>A pointer to the relocation directory.</returns>
+        std::unique_ptr< pe::relocation_directory >& relocation_directory( ) const noexcept;
+
+        /// <summary>
+        /// Gets the export directory of the image. The directory is parsed on first access, and again whenever the image was modified
+        /// since.
+        /// </summary>
+        /// <returns>A pointer to the export directory.</returns>
+        const std::unique_ptr< pe::export_directory >& export_directory( ) const noexcept;
+
+        /// <summary>
+        /// Gets the entries of the exception directory. The entries are copied on first access, and again whenever the image was
+        /// modified since.
+        /// </summary>
+        /// <returns>The runtime function entries.</returns>
+        const std::vector< runtime_function_t >& runtime_functions( ) const noexcept;
+
+        /// <summary>
+        /// Gets the checksum of the image. It is computed on first access, and again whenever the image was modified since.
+        /// </summary>
+        /// <returns>The checksum.</returns>
+        std::uint32_t checksum( ) const noexcept;
+
+        /// <summary>
+        /// Writes the checksum of the image to the optional header.
+        /// </summary>
+        void update_checksum( ) noexcept;
 
         /// <summary>
         /// Gets the data directory of the image.
         /// </summary>
         /// <param name="id">The ID of the data directory.</param>
         /// <returns>The data directory.</returns>
-        PIMAGE_DATA_DIRECTORY data_directory( std::uint32_t id ) const noexcept;
+        data_directory_t* data_directory( std::uint32_t id ) const noexcept;
 
         /// <summary>
         /// Adds a new section to the image.
@@ -74,7 +213,7 @@ namespace vulkan::pe
         /// <param name="characteristics">The characteristics of the section.</param>
         /// <param name="data">The data to write to the section.</param>
         /// <returns>The section header.</returns>
-        PIMAGE_SECTION_HEADER append_section( const std::string_view name, std::uint32_t characteristics, const std::span< std::uint8_t >& data );
+        section_header_t* append_section( const std::string_view name, std::uint32_t characteristics, const std::span< std::uint8_t >& data );
 
         /// <summary>
         /// Adds a new section to the image.
@@ -83,7 +222,7 @@ namespace vulkan::pe
         /// <param name="characteristics">The characteristics of the section.</param>
         /// <param name="data">The size of the section in bytes.</param>
         /// <returns>The section header.</returns>
-        PIMAGE_SECTION_HEADER append_section( const std::string_view name, std::uint32_t characteristics, std::uint32_t size );
+        section_header_t* append_section( const std::string_view name, std::uint32_t characteristics, std::uint32_t size );
 
         /// <summary>
         /// Extends a section in the image.
@@ -91,10 +230,27 @@ namespace vulkan::pe
         /// <param name="name">The name of the section.</param>
         /// <param name="size">The number of bytes to extent by (delta).</param>
         /// <returns>A pointer to the section header.</returns>
-        PIMAGE_SECTION_HEADER extend_section( const std::string_view name, std::uint32_t size );
+        section_header_t* extend_section( const std::string_view name, std::uint32_t size );
+
+        /// <summary>
+        /// Takes a snapshot of the image. An image held in memory is copied, so its snapshot is immutable and unaffected by any later
+        /// edits. An image that is built in place is not copied, since that would defeat the point of streaming: its snapshot is a live
+        /// view of the mapping, so every later edit, including an `insert`, shows through it. Such a snapshot must only be read while
+        /// nothing writes the resources it is read for, and must not be held across an edit.
+        /// </summary>
+        /// <returns>The snapshot.</returns>
+        image_view snapshot( ) const;
+
+        /// <summary>
+        /// Replaces the contents of the image with a snapshot, typically one published by an `image_editor`. An image that is built in
+        /// place only accepts snapshots of the same size.
+        /// </summary>
+        /// <param name="view">The snapshot to adopt.</param>
+        /// <returns>True if the image is valid, false otherwise.</returns>
+        bool commit( const image_view& view );
 
         /// <summary>
-        /// Refreshes the current image and its headers.
+        /// Refreshes the header pointers of the image and marks it as modified. The directories are not parsed until they are accessed.
         /// </summary>
         /// <returns>True if the image is valid, false otherwise.</returns>
         bool refresh( ) noexcept;
@@ -122,16 +278,61 @@ namespace vulkan::pe
             return _is_valid;
         }
 
+        /// <summary>
+        /// Gets the layout of the image.
+        /// </summary>
+        constexpr arch_t arch( ) const noexcept
+        {
+            return _arch;
+        }
+
+        /// <summary>
+        /// Gets the NT headers of the image. Only the file header and the optional header fields up to `BaseOfCode` and from
+        /// `SectionAlignment` to `DllCharacteristics` have the same layout in PE32 and PE32+; use `optional_header` for the rest.
+        /// </summary>
+        constexpr nt_headers_t* nt_headers( ) const noexcept
+        {
+            return _nt_headers;
+        }
+
+        /// <summary>
+        /// Gets the optional header of the image in a specific layout. The layout must match `arch`.
+        /// </summary>
+        /// <typeparam name="Arch">The layout of the image.</typeparam>
+        template< typename Arch >
+        constexpr typename Arch::optional_header_t* optional_header( ) const noexcept
+        {
+            return &reinterpret_cast< typename Arch::nt_headers_t* >( _nt_headers )->OptionalHeader;
+        }
+
+        /// <summary>
+        /// Gets the size of an absolute address in the image.
+        /// </summary>
+        constexpr std::size_t pointer_size( ) const noexcept
+        {
+            return _arch == arch_t::pe32 ? sizeof( pe32::pointer_t ) : sizeof( pe64::pointer_t );
+        }
+
         /// <summary>
         /// Gets the base address of the image.
         /// </summary>
         constexpr std::uintptr_t image_base( ) const noexcept
         {
-            return static_cast< std::uintptr_t >( _nt_headers->OptionalHeader.ImageBase );
+            return dispatch(
+                _arch, [ this ]< typename Arch >( Arch ) { return static_cast< std::uintptr_t >( optional_header< Arch >( )->ImageBase ); } );
+        }
+
+        /// <summary>
+        /// Gets the size of the image when mapped into memory.
+        /// </summary>
+        constexpr std::uint32_t size_of_image( ) const noexcept
+        {
+            return _nt_headers->OptionalHeader.SizeOfImage;
         }
 
         /// <summary>
-        /// Saves the image to a file.
+        /// Saves the image to a file. The checksum is updated first. An image that is built in place and saved to its own file is only
+        /// flushed.
         /// </summary>
         /// <param name="filepath">The path to save the image to.</param>
         /// <returns>True if the image was saved successfully, false otherwise.</returns>
@@ -141,7 +342,7 @@ namespace vulkan::pe
         /// Changes the base address of the image. It also parses the relocation directory and updates the image.
         /// </summary>
         /// <param name="base">The new base address.</param>
-        void rebase( std::uintptr_t base ) const noexcept;
+        void rebase( std::uintptr_t base ) noexcept;
     };
 
 }  // namespace vulkan::pe
\ No newline at end of file
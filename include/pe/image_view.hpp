@@ -0,0 +1,249 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "pe/arch.hpp"
+#include "pe/format.hpp"
+
+namespace vulkan::pe
+{
+    /// <summary>
+    /// A read-only snapshot of a PE image. Views are cheap to copy, as they share the underlying buffer, and all accessors are
+    /// bounds-checked, so any number of threads can analyze the same snapshot. A view of an image held in memory owns a copy and can be
+    /// read while the original image is being edited. A view of a streamed image shares its mapping, see `image::snapshot`.
+    /// </summary>
+    class image_view final
+    {
+        std::shared_ptr< const void > _owner;
+        std::span< const std::uint8_t > _buffer;
+
+        const nt_headers_t* _nt_headers = nullptr;
+        arch_t _arch = arch_t::unknown;
+        std::span< const section_header_t > _sections;
+
+        /// <summary>
+        /// Creates a new view of a buffer that is shared with the view.
+        /// </summary>
+        explicit image_view( std::shared_ptr< const std::vector< std::uint8_t > > buffer );
+
+       public:
+        /// <summary>
+        /// Creates an empty, invalid view.
+        /// </summary>
+        image_view( ) noexcept = default;
+
+        /// <summary>
+        /// Creates a new view that takes ownership of a buffer holding a mapped image.
+        /// </summary>
+        /// <param name="buffer">The buffer of the image.</param>
+        explicit image_view( std::vector< std::uint8_t >&& buffer );
+
+        /// <summary>
+        /// Creates a new view of bytes that are kept alive by another object, such as a file mapping. The bytes are not copied.
+        /// </summary>
+        /// <param name="owner">The object that owns the bytes.</param>
+        /// <param name="buffer">The bytes of the image.</param>
+        image_view( std::shared_ptr< const void > owner, std::span< const std::uint8_t > buffer );
+
+        /// <summary>
+        /// Returns whether the view holds a valid image.
+        /// </summary>
+        constexpr bool is_valid( ) const noexcept
+        {
+            return _nt_headers != nullptr;
+        }
+
+        /// <summary>
+        /// Returns the raw bytes of the image.
+        /// </summary>
+        std::span< const std::uint8_t > buffer( ) const noexcept;
+
+        /// <summary>
+        /// Gets the layout of the image.
+        /// </summary>
+        constexpr arch_t arch( ) const noexcept
+        {
+            return _arch;
+        }
+
+        /// <summary>
+        /// Gets the NT headers of the image. As with `image::nt_headers`, fields whose offset differs between PE32 and PE32+ have to be
+        /// read through `optional_header`.
+        /// </summary>
+        constexpr const nt_headers_t* nt_headers( ) const noexcept
+        {
+            return _nt_headers;
+        }
+
+        /// <summary>
+        /// Gets the optional header of the image in a specific layout. The layout must match `arch`.
+        /// </summary>
+        /// <typeparam name="Arch">The layout of the image.</typeparam>
+        template< typename Arch >
+        constexpr const typename Arch::optional_header_t* optional_header( ) const noexcept
+        {
+            return &reinterpret_cast< const typename Arch::nt_headers_t* >( _nt_headers )->OptionalHeader;
+        }
+
+        /// <summary>
+        /// Gets the section headers of the image. Headers that would extend past the end of the buffer are not included.
+        /// </summary>
+        constexpr std::span< const section_header_t > sections( ) const noexcept
+        {
+            return _sections;
+        }
+
+        /// <summary>
+        /// Returns the section header with the specified name.
+        /// </summary>
+        /// <param name="name">The name of the section.</param>
+        /// <returns>The section header, or a null pointer if there is no such section.</returns>
+        const section_header_t* find_section( std::string_view name ) const noexcept;
+
+        /// <summary>
+        /// Returns the section header containing a relative virtual address.
+        /// </summary>
+        /// <param name="rva">The relative virtual address.</param>
+        /// <returns>The section header, or a null pointer if the address is not inside a section.</returns>
+        const section_header_t* section_of( std::uint32_t rva ) const noexcept;
+
+        /// <summary>
+        /// Gets a data directory of the image.
+        /// </summary>
+        /// <param name="id">The ID of the data directory.</param>
+        /// <returns>The data directory, or an empty directory if the ID is out of range.</returns>
+        data_directory_t data_directory( std::uint32_t id ) const noexcept;
+
+        /// <summary>
+        /// Converts a relative virtual address to a buffer offset.
+        /// </summary>
+        /// <param name="rva">The relative virtual address.</param>
+        /// <returns>The offset, or zero if the address is not backed by a section.</returns>
+        std::uint32_t rva_to_offset( std::uint32_t rva ) const noexcept;
+
+        /// <summary>
+        /// Returns the bytes at a relative virtual address. The range must lie within the headers or within a single section.
+        /// </summary>
+        /// <param name="rva">The relative virtual address.</param>
+        /// <param name="size">The number of bytes.</param>
+        /// <returns>The bytes, or an empty span if the range is out of bounds.</returns>
+        std::span< const std::uint8_t > bytes( std::uint32_t rva, std::size_t size ) const noexcept;
+
+        /// <summary>
+        /// Returns the bytes referenced by a data directory.
+        /// </summary>
+        /// <param name="id">The ID of the data directory.</param>
+        /// <returns>The bytes, or an empty span if the directory is absent or out of bounds.</returns>
+        std::span< const std::uint8_t > directory( std::uint32_t id ) const noexcept;
+
+        /// <summary>
+        /// Returns an array of objects at a relative virtual address.
+        /// </summary>
+        /// <typeparam name="T">The type of the objects.</typeparam>
+        /// <param name="rva">The relative virtual address.</param>
+        /// <param name="count">The number of objects.</param>
+        /// <returns>The objects, or an empty span if the range is out of bounds.</returns>
+        template< typename T >
+        std::span< const T > array( std::uint32_t rva, std::size_t count ) const noexcept
+        {
+            const auto data = bytes( rva, count * sizeof( T ) );
+
+            if ( data.empty( ) )
+                return { };
+
+            return { reinterpret_cast< const T* >( data.data( ) ), count };
+        }
+
+        /// <summary>
+        /// Returns an object at a relative virtual address.
+        /// </summary>
+        /// <typeparam name="T">The type of the object.</typeparam>
+        /// <param name="rva">The relative virtual address.</param>
+        /// <returns>A pointer to the object, or a null pointer if it is out of bounds.</returns>
+        template< typename T >
+        const T* read( std::uint32_t rva ) const noexcept
+        {
+            const auto data = array< T >( rva, 1 );
+            return data.empty( ) ? nullptr : data.data( );
+        }
+
+        /// <summary>
+        /// Gets the entries of the exception directory.
+        /// </summary>
+        std::span< const runtime_function_t > runtime_functions( ) const noexcept;
+
+        /// <summary>
+        /// Gets the base address of the image.
+        /// </summary>
+        constexpr std::uintptr_t image_base( ) const noexcept
+        {
+            return dispatch(
+                _arch, [ this ]< typename Arch >( Arch ) { return static_cast< std::uintptr_t >( optional_header< Arch >( )->ImageBase ); } );
+        }
+
+        /// <summary>
+        /// Gets the size of the image when mapped into memory.
+        /// </summary>
+        constexpr std::uint32_t size_of_image( ) const noexcept
+        {
+            return _nt_headers->OptionalHeader.SizeOfImage;
+        }
+
+        /// <summary>
+        /// Computes the checksum of the snapshot.
+        /// </summary>
+        std::uint32_t compute_checksum( ) const noexcept;
+    };
+
+    /// <summary>
+    /// An explicit editing handle for a snapshot. The editor works on a private copy of the bytes and publishes the result as a new
+    /// snapshot, so existing views are never affected. The section layout of the base snapshot is fixed; use `image` to add sections.
+    /// </summary>
+    class image_editor final
+    {
+        image_view _base;
+        std::vector< std::uint8_t > _buffer;
+
+       public:
+        /// <summary>
+        /// Creates a new editor from a snapshot.
+        /// </summary>
+        /// <param name="base">The snapshot to edit.</param>
+        explicit image_editor( const image_view& base );
+
+        /// <summary>
+        /// Returns the writable bytes at a relative virtual address. The same bounds as `image_view::bytes` apply.
+        /// </summary>
+        /// <param name="rva">The relative virtual address.</param>
+        /// <param name="size">The number of bytes.</param>
+        /// <returns>The bytes, or an empty span if the range is out of bounds.</returns>
+        std::span< std::uint8_t > bytes( std::uint32_t rva, std::size_t size ) noexcept;
+
+        /// <summary>
+        /// Returns a writable object at a relative virtual address.
+        /// </summary>
+        /// <typeparam name="T">The type of the object.</typeparam>
+        /// <param name="rva">The relative virtual address.</param>
+        /// <returns>A pointer to the object, or a null pointer if it is out of bounds.</returns>
+        template< typename T >
+        T* write( std::uint32_t rva ) noexcept
+        {
+            const auto data = bytes( rva, sizeof( T ) );
+            return data.empty( ) ? nullptr : reinterpret_cast< T* >( data.data( ) );
+        }
+
+        /// <summary>
+        /// Publishes the edits as a new snapshot. The editor keeps its bytes, so editing can continue afterwards.
+        /// </summary>
+        image_view publish( ) const&;
+
+        /// <summary>
+        /// Publishes the edits as a new snapshot without copying. The editor is left empty.
+        /// </summary>
+        image_view publish( ) &&;
+    };
+}  // namespace vulkan::pe
\ No newline at end of file
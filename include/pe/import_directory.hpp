@@ -1,12 +1,16 @@
 #pragma once
 
-#include <windows.h>
-
+#include <list>
 #include <memory>
+#include <memory_resource>
 #include <string>
 #include <tuple>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
+
+#include "pe/arch.hpp"
+#include "pe/format.hpp"
 
 namespace vulkan::pe
 {
@@ -25,23 +29,30 @@ namespace vulkan::pe
         /// </summary>
         struct import_t
         {
+            using allocator_type = std::pmr::polymorphic_allocator< >;
+
             /// <summary>
             /// Creates a new import.
             /// </summary>
             /// <param name="module_name">The name of the module that the import is from.</param>
             /// <param name="import_name">The name of the import.</param>
             /// <param name="iat_rva">The relative virtual address of the import address table.</param>
-            explicit import_t( const std::string_view module_name, const std::string_view import_name, std::uintptr_t iat_rva ) noexcept;
+            /// <param name="allocator">The allocator of the names.</param>
+            explicit import_t(
+                const std::string_view module_name,
+                const std::string_view import_name,
+                std::uintptr_t iat_rva,
+                const allocator_type& allocator = { } ) noexcept;
 
             /// <summary>
             /// The name of the module that the import is from.
             /// </summary>
-            std::string module_name;
+            std::pmr::string module_name;
 
             /// <summary>
             /// The name of the import.
             /// </summary>
-            std::string import_name;
+            std::pmr::string import_name;
 
             /// <summary>
             /// The relative virtual address of the import address table.
@@ -50,13 +61,41 @@ namespace vulkan::pe
         };
 
        private:
-        std::unordered_map< std::string, std::list< std::shared_ptr< import_t > > > _imports;
+        /// <summary>
+        /// Hashes names, so that they can be looked up without copying them into a string first.
+        /// </summary>
+        struct name_hash
+        {
+            using is_transparent = void;
+
+            std::size_t operator( )( std::string_view name ) const noexcept
+            {
+                return std::hash< std::string_view >{ }( name );
+            }
+        };
 
-        PIMAGE_IMPORT_DESCRIPTOR _import_descriptor = nullptr;
-        std::uintptr_t *_iat = nullptr;
+        /// <summary>
+        /// The resource the imports are allocated from. It is kept alive for as long as the directory.
+        /// </summary>
+        std::shared_ptr< std::pmr::memory_resource > _resource;
 
-        PIMAGE_DATA_DIRECTORY _import_data_directory = nullptr;
-        PIMAGE_DATA_DIRECTORY _iat_data_directory = nullptr;
+        std::pmr::unordered_map< std::pmr::string, std::pmr::list< import_t >, name_hash, std::equal_to< > > _imports;
+
+        /// <summary>
+        /// The `module!import` keys of every added import, so that duplicates are found in constant time.
+        /// </summary>
+        std::pmr::unordered_set< std::pmr::string, name_hash, std::equal_to< > > _keys;
+
+        /// <summary>
+        /// The buffer the key of an import is built in before it is looked up. It is reused, so that duplicates allocate nothing.
+        /// </summary>
+        std::string _key;
+
+        import_descriptor_t* _import_descriptor = nullptr;
+        std::uint8_t *_iat = nullptr;
+
+        data_directory_t* _import_data_directory = nullptr;
+        data_directory_t* _iat_data_directory = nullptr;
 
         std::size_t _import_descriptor_count = 0;
 
@@ -64,18 +103,38 @@ namespace vulkan::pe
         std::size_t _api_and_module_names_size = 0;
         std::size_t _iat_size = 0;
 
+        /// <summary>
+        /// The size of an import address table entry, which depends on the layout of the image.
+        /// </summary>
+        std::size_t _thunk_size = sizeof( pe64::thunk_t );
+
         /// <summary>
         /// Creates a new import directory class instance.
         /// </summary>
-        explicit import_directory( ) noexcept;
+        /// <param name="resource">The resource to allocate the imports from, or a null pointer for the default resource.</param>
+        explicit import_directory( std::shared_ptr< std::pmr::memory_resource > resource = nullptr ) noexcept;
 
         /// <summary>
         /// Refreshes the import directory.
         /// </summary>
-        void refresh( image *img ) noexcept;
+        void refresh( const image *img ) noexcept;
+
+        /// <summary>
+        /// Parses the import descriptors of the image for a specific layout.
+        /// </summary>
+        /// <typeparam name="Arch">The layout of the image.</typeparam>
+        template< typename Arch >
+        void parse( const image *img ) noexcept;
+
+        /// <summary>
+        /// Writes the import directory into a new section for a specific layout.
+        /// </summary>
+        /// <typeparam name="Arch">The layout of the image.</typeparam>
+        template< typename Arch >
+        void emit( image *img, const std::string_view section_name ) noexcept;
 
         /// <summary>
-        /// Calculates the sizes of the import directory.
+        /// Calculates the sizes of the import directory from scratch. `add` updates the sizes incrementally.
         /// </summary>
         void calculate_import_sizes( ) noexcept;
 
@@ -83,17 +142,17 @@ namespace vulkan::pe
         /// <summary>
         /// Returns the IAT data directory.
         /// </summary>
-        PIMAGE_DATA_DIRECTORY iat_data_directory( ) const noexcept;
+        data_directory_t* iat_data_directory( ) const noexcept;
 
         /// <summary>
         /// Gets the import data directory.
         /// </summary>
-        PIMAGE_DATA_DIRECTORY import_data_directory( ) const noexcept;
+        data_directory_t* import_data_directory( ) const noexcept;
 
         /// <summary>
-        /// Returns the imports in the import directory.
+        /// Returns the imports in the import directory. They stay valid until the directory is cleared or parsed again.
         /// </summary>
-        const std::list< std::shared_ptr< import_t > > imports( ) noexcept;
+        std::pmr::vector< const import_t* > imports( ) const noexcept;
 
         /// <summary>
         /// Clears the import directory.
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "pe/format.hpp"
+
+namespace vulkan::pe
+{
+    class image;
+
+    /// <summary>
+    /// The abstract representation of the base relocation directory in a PE image.
+    /// </summary>
+    class relocation_directory final
+    {
+        friend class image;
+
+       public:
+        /// <summary>
+        /// A single base relocation.
+        /// </summary>
+        struct relocation_t
+        {
+            /// <summary>
+            /// The relative virtual address of the field to relocate.
+            /// </summary>
+            std::uint32_t rva;
+
+            /// <summary>
+            /// The type of the relocation (`IMAGE_REL_BASED_*`).
+            /// </summary>
+            std::uint8_t type;
+        };
+
+       private:
+        std::vector< relocation_t > _relocations;
+
+        bool _is_valid = false;
+
+        /// <summary>
+        /// Creates a new relocation directory class instance.
+        /// </summary>
+        explicit relocation_directory( ) noexcept;
+
+        /// <summary>
+        /// Refreshes the relocation directory by parsing the relocation blocks of the image.
+        /// </summary>
+        void refresh( const image *img ) noexcept;
+
+       public:
+        /// <summary>
+        /// Returns the relocations in the directory, sorted by address. Padding entries are not included.
+        /// </summary>
+        const std::vector< relocation_t > &relocations( ) const noexcept;
+
+        /// <summary>
+        /// Returns whether the image has a relocation directory that could be parsed completely. This is false if the directory is
+        /// absent, or if its contents were not readable when the image was dumped.
+        /// </summary>
+        constexpr bool is_valid( ) const noexcept
+        {
+            return _is_valid;
+        }
+
+        /// <summary>
+        /// Clears the relocation directory.
+        /// </summary>
+        void clear( ) noexcept;
+
+        /// <summary>
+        /// Adds a new relocation to the directory.
+        /// </summary>
+        /// <param name="rva">The relative virtual address of the field to relocate.</param>
+        /// <param name="type">The type of the relocation.</param>
+        void add( std::uint32_t rva, std::uint8_t type ) noexcept;
+
+        /// <summary>
+        /// Recompiles the relocation directory into a new section. One block is emitted per page.
+        /// </summary>
+        /// <param name="img">The image the relocation directory is associated with.</param>
+        /// <param name="section_name">The name of the section to recompile to.</param>
+        void recompile( image *img, const std::string_view section_name ) noexcept;
+    };
+}  // namespace vulkan::pe
\ No newline at end of file
@@ -1,9 +1,9 @@
 #pragma once
 
-#include <windows.h>
-
 #include <cstdint>
 
+#include "pe/format.hpp"
+
 namespace vulkan::pe
 {
     class image;
@@ -15,13 +15,13 @@ namespace vulkan::pe
     {
         friend class image;
 
-        PIMAGE_NT_HEADERS _nt_headers = nullptr;
+        nt_headers_t* _nt_headers = nullptr;
 
         /// <summary>
         /// Creates a new instance of the section headers class.
         /// </summary>
         /// <param name="nt_headers">The NT headers to use.</param>
-        explicit section_headers( PIMAGE_NT_HEADERS nt_headers ) noexcept;
+        explicit section_headers( nt_headers_t* nt_headers ) noexcept;
 
         /// <summary>
         /// Fixes the alignment of the section headers.
@@ -43,9 +43,9 @@ namespace vulkan::pe
         /// </summary>
         /// <param name="index">The index of the section header.</param>
         /// <returns>The section header.</returns>
-        constexpr PIMAGE_SECTION_HEADER at( std::uint16_t index ) const noexcept
+        section_header_t* at( std::uint16_t index ) const noexcept
         {
-            return IMAGE_FIRST_SECTION( _nt_headers ) + index;
+            return first_section( _nt_headers ) + index;
         }
 
         /// <summary>
@@ -53,7 +53,7 @@ namespace vulkan::pe
         /// </summary>
         /// <param name="index">The index of the section header.</param>
         /// <returns>The section header.</returns>
-        constexpr PIMAGE_SECTION_HEADER operator[]( std::uint16_t index ) const noexcept
+        section_header_t* operator[]( std::uint16_t index ) const noexcept
         {
             return at( index );
         }
@@ -61,7 +61,7 @@ namespace vulkan::pe
         /// <summary>
         /// Returns the last section header in the image.
         /// </summary>
-        constexpr PIMAGE_SECTION_HEADER last( ) const noexcept
+        section_header_t* last( ) const noexcept
         {
             return at( count( ) - 1 );
         }
@@ -69,7 +69,7 @@ namespace vulkan::pe
         /// <summary>
         /// Returns the first section header in the image.
         /// </summary>
-        constexpr PIMAGE_SECTION_HEADER first( ) const noexcept
+        section_header_t* first( ) const noexcept
         {
             return at( 0 );
         }
@@ -78,7 +78,7 @@ namespace vulkan::pe
         /// Appends a section header to the image.
         /// </summary>
         /// <param name="header">The section header to append.</param>
-        void append( IMAGE_SECTION_HEADER& header ) const noexcept;
+        void append( section_header_t& header ) const noexcept;
 
         /// <summary>
         /// Removes a section header from the image.
@@ -97,7 +97,7 @@ namespace vulkan::pe
         /// </summary>
         /// <param name="name">The name of the section header.</param>
         /// <returns>The section header.</returns>
-        PIMAGE_SECTION_HEADER find( const char* name ) const noexcept;
+        section_header_t* find( const char* name ) const noexcept;
     };
 
 }  // namespace vulkan::pe
\ No newline at end of file
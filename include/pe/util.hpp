@@ -2,6 +2,7 @@
 
 #include <concepts>
 #include <cstdint>
+#include <span>
 
 namespace vulkan::pe
 {
@@ -18,10 +19,37 @@ namespace vulkan::pe
     /// <param name="alignment">The alignment.</param>
     /// <returns>The aligned value.</returns>
     template< typename T >
-    constexpr __forceinline auto align( T value, std::uint32_t alignment ) noexcept
+    constexpr auto align( T value, std::uint32_t alignment ) noexcept
         requires std::unsigned_integral< T >
     {
         return ( value + alignment - 1 ) & ~static_cast< T >( alignment - 1 );
     }
 
+    /// <summary>
+    /// Computes the checksum of an image buffer.
+    /// </summary>
+    /// <param name="buffer">The buffer of the image.</param>
+    /// <returns>The checksum.</returns>
+    inline std::uint32_t compute_checksum( std::span< const std::uint8_t > buffer ) noexcept
+    {
+        std::uint32_t sum = 0;
+
+        const auto data = reinterpret_cast< const std::uint32_t* >( buffer.data( ) );
+        const auto size = buffer.size( ) / sizeof( std::uint32_t );
+
+        for ( std::size_t i = 0; i < size; ++i )
+        {
+            if ( ( sum += data[ i ] ) > 0xFFFF )
+                sum = ( sum & 0xFFFF ) + ( sum >> 0x10 );
+        }
+
+        if ( size % sizeof( std::uint32_t ) )
+        {
+            if ( ( sum += ( static_cast< std::uint16_t >( data[ size - 1 ] ) << 0x8 ) ) > 0xFFFF )
+                sum = ( sum & 0xFFFF ) + ( sum >> 0x10 );
+        }
+
+        return ~sum;
+    }
+
 }  // namespace vulkan::pe
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "sources/source.hpp"
+
+namespace vulkan::sources
+{
+    /// <summary>
+    /// Forwards to another source and adds images that were carved from its memory to its modules, so that images which are absent from
+    /// the module list, such as manually mapped ones, can be dumped like any other module.
+    /// </summary>
+    class carved_source final : public source
+    {
+        const source& _inner;
+        std::vector< module_t > _carved;
+
+       public:
+        /// <summary>
+        /// Creates a new carved source.
+        /// </summary>
+        /// <param name="inner">The source the images were carved from.</param>
+        /// <param name="carved">The carved images. Images already in the module list of the source are not added again.</param>
+        explicit carved_source( const source& inner, std::vector< module_t > carved );
+
+        bool is_live( ) const noexcept override;
+
+        std::chrono::steady_clock::time_point now( ) const override;
+
+        void wait_until( std::chrono::steady_clock::time_point time ) const override;
+
+        std::vector< module_t > modules( ) const override;
+
+        std::optional< region_t > query( std::uintptr_t address ) const override;
+
+        std::vector< region_t > regions( std::uintptr_t address, std::size_t size ) const override;
+
+        bool read( std::uintptr_t address, std::span< std::uint8_t > out ) const override;
+
+        std::vector< export_t > exports( const module_t& module ) const override;
+
+        std::vector< api_set_t > api_sets( ) const override;
+
+        std::vector< extent_t > extents( ) const override;
+    };
+}  // namespace vulkan::sources
\ No newline at end of file
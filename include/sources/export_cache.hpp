@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "sources/source.hpp"
+
+namespace vulkan::sources
+{
+    /// <summary>
+    /// Caches the exports of modules, so that dumps run in the same process do not enumerate the exports of the same system modules over
+    /// and over. Modules loaded from the same path at the same address with the same size, time stamp and checksum are assumed to be
+    /// identical. Minidumps list the time stamp and checksum of every module, so captures from machines with other builds of the system
+    /// modules do not share entries, even if ASLR placed them at the same address. The cache is safe to share between threads.
+    /// </summary>
+    class export_cache final
+    {
+        /// <summary>
+        /// The path (or the name, if the path is unknown), address, size, time stamp and checksum of a module.
+        /// </summary>
+        using key_t = std::tuple< std::string, std::uintptr_t, std::size_t, std::uint32_t, std::uint32_t >;
+
+        mutable std::shared_mutex _mutex;
+        std::map< key_t, std::shared_ptr< const std::vector< export_t > > > _entries;
+
+       public:
+        /// <summary>
+        /// Returns the exports of a module, enumerating them from the source if they are not cached yet.
+        /// </summary>
+        /// <param name="source">The source the module is loaded in.</param>
+        /// <param name="module">The module.</param>
+        /// <returns>The exports of the module.</returns>
+        std::shared_ptr< const std::vector< export_t > > exports( const source& source, const module_t& module );
+
+        /// <summary>
+        /// Returns the number of cached modules.
+        /// </summary>
+        std::size_t size( ) const noexcept;
+
+        /// <summary>
+        /// Drops all cached exports, for example after the system modules were updated.
+        /// </summary>
+        void clear( ) noexcept;
+    };
+}  // namespace vulkan::sources
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "sources/source.hpp"
+
+namespace vulkan::sources
+{
+    /// <summary>
+    /// Parses an API set schema, as mapped by the loader into every process. Only the schema of Windows 10 and later (version 6) is
+    /// supported; other versions yield nothing.
+    /// </summary>
+    /// <param name="schema">The bytes of the schema.</param>
+    /// <returns>The contracts of the schema with their default host.</returns>
+    std::vector< api_set_t > parse_api_sets( std::span< const std::uint8_t > schema );
+
+    /// <summary>
+    /// Resolves the addresses in an import address table to the names of the imports they were bound to. The forwarder chains of all
+    /// exports are followed once, through API set contracts to their host, and the results are kept in a table sorted by the address the
+    /// chains end at. Looking up an address is a single binary search, regardless of how many exports lead to it.
+    ///
+    /// When several exports end at the same address, the one that forwards over the most steps is the canonical one, since that is the
+    /// name programs link against (`kernel32!HeapAlloc` rather than `ntdll!RtlAllocateHeap`). Ties go to the module that comes first.
+    /// Exports of API set contracts are never canonical, and forwarders by ordinal are not followed.
+    /// </summary>
+    class export_resolver final
+    {
+        /// <summary>
+        /// The maximum number of forwarders followed from an export, which also breaks forwarder cycles.
+        /// </summary>
+        static constexpr std::size_t MAX_FORWARDER_DEPTH = 16;
+
+        std::vector< std::uintptr_t > _addresses;
+        std::vector< export_t > _exports;
+
+       public:
+        /// <summary>
+        /// Builds the resolution table.
+        /// </summary>
+        /// <param name="tables">The exports of every module, in load order.</param>
+        /// <param name="api_sets">The API set contracts of the system. Contracts that are missing are resolved to a module that exports
+        /// the requested name itself.</param>
+        export_resolver( std::span< const std::span< const export_t > > tables, std::span< const api_set_t > api_sets );
+
+        /// <summary>
+        /// Finds the canonical export at an address.
+        /// </summary>
+        /// <param name="address">The address, such as the value of an import address table entry.</param>
+        /// <returns>The export, with the address it resolves to, or a null pointer if no export resolves to the address.</returns>
+        const export_t* find( std::uintptr_t address ) const noexcept;
+
+        /// <summary>
+        /// Returns the number of addresses in the table.
+        /// </summary>
+        std::size_t size( ) const noexcept;
+    };
+}  // namespace vulkan::sources
\ No newline at end of file
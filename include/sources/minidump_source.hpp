@@ -0,0 +1,37 @@
+#pragma once
+
+#include "minidump/reader.hpp"
+#include "sources/source.hpp"
+
+namespace vulkan::sources
+{
+    /// <summary>
+    /// Reads from a minidump, such as one written with `--minidump`. The dump should contain the full memory of the process.
+    /// </summary>
+    class minidump_source final : public source
+    {
+        minidump::reader _reader;
+
+       public:
+        /// <summary>
+        /// Opens a minidump.
+        /// </summary>
+        /// <param name="path">The path of the minidump.</param>
+        explicit minidump_source( std::string_view path ) noexcept;
+
+        /// <summary>
+        /// Returns whether the minidump could be opened and parsed.
+        /// </summary>
+        bool is_valid( ) const noexcept;
+
+        bool is_live( ) const noexcept override;
+
+        std::vector< module_t > modules( ) const override;
+
+        std::optional< region_t > query( std::uintptr_t address ) const override;
+
+        bool read( std::uintptr_t address, std::span< std::uint8_t > out ) const override;
+
+        std::vector< extent_t > extents( ) const override;
+    };
+}  // namespace vulkan::sources
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string_view>
+#include <wincpp/process.hpp>
+
+#include "sources/source.hpp"
+
+namespace vulkan::sources
+{
+    /// <summary>
+    /// Reads from a live process. Dumps of a live process can also create a minidump of it (`dumper::options::minidump_path`), through a
+    /// pass that is registered with the dumper by this source, since only builds that can read live processes are able to write one.
+    /// </summary>
+    class process_source final : public source
+    {
+        wincpp::process_t& _process;
+
+       public:
+        /// <summary>
+        /// Creates a new source for a live process.
+        /// </summary>
+        /// <param name="process">The process to read from.</param>
+        explicit process_source( wincpp::process_t& process ) noexcept;
+
+        /// <summary>
+        /// Returns the underlying process.
+        /// </summary>
+        wincpp::process_t& process( ) const noexcept;
+
+        bool is_live( ) const noexcept override;
+
+        std::vector< module_t > modules( ) const override;
+
+        std::optional< region_t > query( std::uintptr_t address ) const override;
+
+        bool read( std::uintptr_t address, std::span< std::uint8_t > out ) const override;
+
+        /// <summary>
+        /// Returns the API set contracts of the system, from the schema the loader mapped into this process. The schema is the same for
+        /// every process of a boot session.
+        /// </summary>
+        std::vector< api_set_t > api_sets( ) const override;
+
+        /// <summary>
+        /// Creates and saves a minidump of the process.
+        /// </summary>
+        /// <param name="path">The path to save the minidump to.</param>
+        void save_minidump( std::string_view path ) const;
+    };
+}  // namespace vulkan::sources
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+
+#include "sources/source.hpp"
+#include "trace/format.hpp"
+
+namespace vulkan::sources
+{
+    /// <summary>
+    /// Forwards to another source and records every poll, change of page accessibility and successful read into a trace, along with the
+    /// time it happened. The trace can be played back with a `replay_source`.
+    /// </summary>
+    class recording_source final : public source
+    {
+        /// <summary>
+        /// The number of pages of a queried region whose accessibility is recorded, counting from the queried address.
+        /// </summary>
+        static constexpr std::size_t MAX_REGION_PAGES = 0x4000;
+
+        const source& _inner;
+
+        mutable std::ofstream _file;
+        mutable std::mutex _mutex;
+
+        /// <summary>
+        /// The last observed accessibility of every polled page.
+        /// </summary>
+        mutable std::unordered_map< std::uintptr_t, bool > _readable;
+
+        mutable bool _modules_recorded = false;
+        mutable bool _api_sets_recorded = false;
+
+        std::chrono::steady_clock::time_point _start;
+        mutable std::chrono::steady_clock::time_point _last;
+
+        /// <summary>
+        /// Writes the header of an event. Must be called with the mutex held.
+        /// </summary>
+        void begin_event( trace::event_t kind ) const;
+
+       public:
+        /// <summary>
+        /// Creates a new recording source.
+        /// </summary>
+        /// <param name="inner">The source to record.</param>
+        /// <param name="path">The path of the trace to write.</param>
+        explicit recording_source( const source& inner, std::string_view path );
+
+        /// <summary>
+        /// Returns whether the trace file could be created.
+        /// </summary>
+        bool is_valid( ) const noexcept;
+
+        bool is_live( ) const noexcept override;
+
+        std::chrono::steady_clock::time_point now( ) const override;
+
+        void wait_until( std::chrono::steady_clock::time_point time ) const override;
+
+        std::vector< module_t > modules( ) const override;
+
+        std::optional< region_t > query( std::uintptr_t address ) const override;
+
+        bool read( std::uintptr_t address, std::span< std::uint8_t > out ) const override;
+
+        std::vector< export_t > exports( const module_t& module ) const override;
+
+        std::vector< api_set_t > api_sets( ) const override;
+    };
+}  // namespace vulkan::sources
\ No newline at end of file
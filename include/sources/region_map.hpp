@@ -0,0 +1,95 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "sources/source.hpp"
+
+namespace vulkan::sources
+{
+    /// <summary>
+    /// A snapshot of the regions of a range of a source, so that the accessibility of a page costs a lookup in a sorted table instead of
+    /// a query. The range is walked once up front. After that, `refresh` walks again only the regions that are due. A region that
+    /// changed is due again soon, while a region that stayed the same waits twice as long as before. Regions that are already readable
+    /// have nothing left to gain, so they always wait the longest. The map is not safe to use from several threads at once.
+    /// </summary>
+    class region_map final
+    {
+        /// <summary>
+        /// A region of the range, or a gap between regions.
+        /// </summary>
+        struct entry_t
+        {
+            region_t region;
+            bool mapped;
+
+            /// <summary>
+            /// The time of the source at which the entry is walked again.
+            /// </summary>
+            std::chrono::steady_clock::time_point due;
+
+            /// <summary>
+            /// The time the entry waited after its last refresh.
+            /// </summary>
+            std::chrono::steady_clock::duration interval;
+        };
+
+        const source& _source;
+        std::uintptr_t _address;
+        std::size_t _size;
+
+        std::chrono::steady_clock::duration _min_interval;
+        std::chrono::steady_clock::duration _max_interval;
+
+        /// <summary>
+        /// The entries, sorted by address. They cover the whole range without overlapping.
+        /// </summary>
+        std::vector< entry_t > _entries;
+
+        /// <summary>
+        /// Walks a part of the range and returns its entries, clipped to the part and with the gaps filled in.
+        /// </summary>
+        std::vector< entry_t > walk( std::uintptr_t address, std::size_t size ) const;
+
+       public:
+        /// <summary>
+        /// Walks the regions of a range of a source.
+        /// </summary>
+        /// <param name="source">The source. It must outlive the map.</param>
+        /// <param name="address">The start of the range.</param>
+        /// <param name="size">The size of the range.</param>
+        /// <param name="min_interval">The time a region waits after it changed, or after it was first walked.</param>
+        /// <param name="max_interval">The longest time a region waits.</param>
+        explicit region_map(
+            const source& source,
+            std::uintptr_t address,
+            std::size_t size,
+            std::chrono::steady_clock::duration min_interval = std::chrono::milliseconds( 1 ),
+            std::chrono::steady_clock::duration max_interval = std::chrono::milliseconds( 100 ) );
+
+        /// <summary>
+        /// Returns the region that contains an address, as of its last refresh.
+        /// </summary>
+        /// <param name="address">The address.</param>
+        /// <returns>The region clipped to the range, or nothing if the address is not mapped or outside the range.</returns>
+        std::optional< region_t > find( std::uintptr_t address ) const noexcept;
+
+        /// <summary>
+        /// Walks the regions that are due at the current time of the source again. Static sources never change, so nothing is walked.
+        /// </summary>
+        /// <returns>The number of regions that changed.</returns>
+        std::size_t refresh( );
+
+        /// <summary>
+        /// Returns the earliest time a region is due again, or the current time of the source if the map is empty.
+        /// </summary>
+        std::chrono::steady_clock::time_point next_due( ) const;
+
+        /// <summary>
+        /// Returns the number of regions and gaps in the map.
+        /// </summary>
+        std::size_t size( ) const noexcept;
+    };
+}  // namespace vulkan::sources
\ No newline at end of file
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <unordered_map>
+
+#include "io/mapped_file.hpp"
+#include "sources/source.hpp"
+
+namespace vulkan::sources
+{
+    /// <summary>
+    /// Plays back a trace written by a `recording_source`. The source runs on a virtual clock that advances by a fixed step on every
+    /// query and read, so a given acquisition strategy always observes the same timeline. Pages become readable (and get their
+    /// contents) at the times they did in the recording. The source stops being live once the clock passes the end of the trace.
+    /// </summary>
+    class replay_source final : public source
+    {
+        /// <summary>
+        /// A successful read from the recording.
+        /// </summary>
+        struct chunk_t
+        {
+            std::int64_t time;
+            std::uintptr_t address;
+            std::size_t size;
+
+            /// <summary>
+            /// The offset of the bytes in the trace file.
+            /// </summary>
+            std::size_t offset;
+        };
+
+        /// <summary>
+        /// The recorded timeline of a single page.
+        /// </summary>
+        struct page_t
+        {
+            std::vector< std::pair< std::int64_t, bool > > protect;
+            std::vector< std::size_t > chunks;
+        };
+
+        io::mapped_file _file;
+
+        std::vector< module_t > _modules;
+        std::unordered_map< std::string, std::vector< export_t > > _exports;
+        std::vector< api_set_t > _api_sets;
+        std::vector< chunk_t > _chunks;
+        std::unordered_map< std::uintptr_t, page_t > _pages;
+
+        std::int64_t _duration = 0;
+        std::int64_t _step = 0;
+        mutable std::atomic< std::int64_t > _now = 0;
+
+        bool _is_valid = false;
+
+        /// <summary>
+        /// Parses the events of the trace.
+        /// </summary>
+        bool parse( ) noexcept;
+
+        /// <summary>
+        /// Advances the virtual clock by one step and returns the new time in nanoseconds.
+        /// </summary>
+        std::int64_t tick( ) const noexcept;
+
+        /// <summary>
+        /// Returns whether a page is readable at the given time.
+        /// </summary>
+        bool is_readable( const page_t& page, std::int64_t time ) const noexcept;
+
+       public:
+        /// <summary>
+        /// Opens a trace for playback.
+        /// </summary>
+        /// <param name="path">The path of the trace.</param>
+        /// <param name="step">The time every query and read takes. If zero, the average time per operation of the recording is used.</param>
+        explicit replay_source( std::string_view path, std::chrono::nanoseconds step = { } ) noexcept;
+
+        /// <summary>
+        /// Returns whether the trace could be opened and parsed.
+        /// </summary>
+        bool is_valid( ) const noexcept;
+
+        /// <summary>
+        /// Returns the length of the recording.
+        /// </summary>
+        std::chrono::nanoseconds duration( ) const noexcept;
+
+        bool is_live( ) const noexcept override;
+
+        std::chrono::steady_clock::time_point now( ) const override;
+
+        void wait_until( std::chrono::steady_clock::time_point time ) const override;
+
+        std::vector< module_t > modules( ) const override;
+
+        std::optional< region_t > query( std::uintptr_t address ) const override;
+
+        bool read( std::uintptr_t address, std::span< std::uint8_t > out ) const override;
+
+        std::vector< export_t > exports( const module_t& module ) const override;
+
+        /// <summary>
+        /// Returns the API set schema of the recording, so that imports resolve the same way they did when it was recorded. Traces of
+        /// version 2 and earlier have none.
+        /// </summary>
+        std::vector< api_set_t > api_sets( ) const override;
+    };
+}  // namespace vulkan::sources
\ No newline at end of file
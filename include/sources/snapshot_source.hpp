@@ -0,0 +1,42 @@
+#pragma once
+
+#include "io/mapped_file.hpp"
+#include "sources/source.hpp"
+
+namespace vulkan::sources
+{
+    /// <summary>
+    /// Reads from a raw memory snapshot: a file holding a single contiguous range of memory, typically a copy of a mapped module. The
+    /// snapshot is exposed as a single module at the given base address.
+    /// </summary>
+    class snapshot_source final : public source
+    {
+        io::mapped_file _file;
+        std::string _name;
+        std::uintptr_t _base;
+
+       public:
+        /// <summary>
+        /// Opens a raw snapshot.
+        /// </summary>
+        /// <param name="path">The path of the snapshot.</param>
+        /// <param name="name">The name of the module in the snapshot.</param>
+        /// <param name="base">The address the snapshot was taken at.</param>
+        explicit snapshot_source( std::string_view path, std::string_view name, std::uintptr_t base ) noexcept;
+
+        /// <summary>
+        /// Returns whether the snapshot could be opened.
+        /// </summary>
+        bool is_valid( ) const noexcept;
+
+        bool is_live( ) const noexcept override;
+
+        std::vector< module_t > modules( ) const override;
+
+        std::optional< region_t > query( std::uintptr_t address ) const override;
+
+        bool read( std::uintptr_t address, std::span< std::uint8_t > out ) const override;
+
+        std::vector< extent_t > extents( ) const override;
+    };
+}  // namespace vulkan::sources
\ No newline at end of file
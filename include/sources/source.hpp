@@ -0,0 +1,159 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vulkan::sources
+{
+    /// <summary>
+    /// A module loaded in the address space of a source.
+    /// </summary>
+    struct module_t
+    {
+        std::string name;
+        std::string path;
+        std::uintptr_t address;
+        std::size_t size;
+
+        /// <summary>
+        /// The `TimeDateStamp` and `CheckSum` of the module's headers, as listed by sources that record them, such as minidumps. Zero if
+        /// the source does not know them.
+        /// </summary>
+        std::uint32_t time_date_stamp;
+        std::uint32_t checksum;
+    };
+
+    /// <summary>
+    /// A function exported by a module of a source.
+    /// </summary>
+    struct export_t
+    {
+        std::string module_name;
+        std::string name;
+
+        /// <summary>
+        /// The address of the export. Zero if the export is forwarded.
+        /// </summary>
+        std::uintptr_t address;
+
+        /// <summary>
+        /// The forwarder string (`module.function` or `module.#ordinal`), if the export is forwarded.
+        /// </summary>
+        std::string forwarder;
+    };
+
+    /// <summary>
+    /// An API set contract and the module that hosts it, such as `api-ms-win-core-synch-l1-2-0` and `kernelbase.dll`.
+    /// </summary>
+    struct api_set_t
+    {
+        std::string contract;
+        std::string host;
+    };
+
+    /// <summary>
+    /// A region of memory with uniform accessibility.
+    /// </summary>
+    struct region_t
+    {
+        std::uintptr_t address;
+        std::size_t size;
+        bool readable;
+    };
+
+    /// <summary>
+    /// A range of captured memory whose contents are directly addressable, such as a memory range of a mapped minidump.
+    /// </summary>
+    struct extent_t
+    {
+        std::uintptr_t address;
+        std::span< const std::uint8_t > bytes;
+    };
+
+    /// <summary>
+    /// An address space the dumper can read a module from. This is either a live process, or a capture of one that can be processed
+    /// later (and elsewhere).
+    /// </summary>
+    class source
+    {
+       public:
+        virtual ~source( ) = default;
+
+        /// <summary>
+        /// Returns whether the contents of the source can change between reads. Pages of a static source are never polled again.
+        /// </summary>
+        virtual bool is_live( ) const noexcept = 0;
+
+        /// <summary>
+        /// Returns the current time of the source. Timings of the dumper are taken from this clock, so that replayed sources can run on
+        /// a virtual one. The default implementation returns the steady clock.
+        /// </summary>
+        virtual std::chrono::steady_clock::time_point now( ) const;
+
+        /// <summary>
+        /// Waits until the clock of the source reaches a time. The default implementation sleeps, while replayed sources advance their
+        /// virtual clock instead, since it would never get there on its own.
+        /// </summary>
+        /// <param name="time">The time to wait for.</param>
+        virtual void wait_until( std::chrono::steady_clock::time_point time ) const;
+
+        /// <summary>
+        /// Returns the modules of the source.
+        /// </summary>
+        virtual std::vector< module_t > modules( ) const = 0;
+
+        /// <summary>
+        /// Returns the region that contains an address.
+        /// </summary>
+        /// <param name="address">The address.</param>
+        /// <returns>The region, or nothing if the address is not mapped.</returns>
+        virtual std::optional< region_t > query( std::uintptr_t address ) const = 0;
+
+        /// <summary>
+        /// Returns the regions that overlap a range of addresses, sorted by address. Unmapped parts of the range are left out. The default
+        /// implementation walks the range with one query per region.
+        /// </summary>
+        /// <param name="address">The start of the range.</param>
+        /// <param name="size">The size of the range.</param>
+        virtual std::vector< region_t > regions( std::uintptr_t address, std::size_t size ) const;
+
+        /// <summary>
+        /// Reads memory from the source. Reads are all-or-nothing.
+        /// </summary>
+        /// <param name="address">The address to read from.</param>
+        /// <param name="out">The buffer to read into.</param>
+        /// <returns>True if the whole buffer was read, false otherwise.</returns>
+        virtual bool read( std::uintptr_t address, std::span< std::uint8_t > out ) const = 0;
+
+        /// <summary>
+        /// Returns the named exports of a module, including forwarded ones. The default implementation parses the export directory of the
+        /// module from memory, reading only the pages of the headers and of the directory.
+        /// </summary>
+        /// <param name="module">The module.</param>
+        virtual std::vector< export_t > exports( const module_t& module ) const;
+
+        /// <summary>
+        /// Returns the API set contracts of the system the source was taken from. The default implementation returns nothing, in which
+        /// case contracts are resolved to a loaded module that exports the requested name.
+        /// </summary>
+        virtual std::vector< api_set_t > api_sets( ) const;
+
+        /// <summary>
+        /// Returns the captured memory of the source, sorted by address, so that it can be scanned without copying. Only sources backed by
+        /// a mapped capture have any; the default implementation returns nothing.
+        /// </summary>
+        virtual std::vector< extent_t > extents( ) const;
+
+        /// <summary>
+        /// Finds the module with the given name. The comparison is case insensitive.
+        /// </summary>
+        /// <param name="name">The name of the module.</param>
+        /// <returns>The module, or nothing if there is no such module.</returns>
+        std::optional< module_t > find_module( std::string_view name ) const;
+    };
+}  // namespace vulkan::sources
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#include "sources/source.hpp"
+
+namespace vulkan::store
+{
+    /// <summary>
+    /// The number of pages of read-only data that are hashed into the fingerprint of a module.
+    /// </summary>
+    static constexpr std::size_t FINGERPRINT_SAMPLES = 16;
+
+    /// <summary>
+    /// Identifies the build of a loaded module, so that dumps of a module that did not change can be recognized without reading it.
+    /// </summary>
+    struct fingerprint_t
+    {
+        /// <summary>
+        /// A hash of the address of the module, its time stamp, its size and its section table.
+        /// </summary>
+        std::uint64_t headers;
+
+        /// <summary>
+        /// A hash of pages sampled evenly from the sections that are neither writable nor executable. Time stamps are not always set
+        /// (reproducible builds), and these pages tell such builds apart.
+        /// </summary>
+        std::uint64_t pages;
+
+        bool operator==( const fingerprint_t& ) const noexcept = default;
+    };
+
+    /// <summary>
+    /// Hashes bytes with 64-bit FNV-1a.
+    /// </summary>
+    /// <param name="bytes">The bytes to hash.</param>
+    /// <param name="seed">The hash to continue from.</param>
+    std::uint64_t hash( std::span< const std::uint8_t > bytes, std::uint64_t seed = 0xCBF29CE484222325 ) noexcept;
+
+    /// <summary>
+    /// Computes the fingerprint of a module. Only the headers and up to `FINGERPRINT_SAMPLES` pages are read. Code is left out, since its
+    /// pages may still be encrypted, and so are writable pages, which change while the module runs.
+    /// </summary>
+    /// <param name="source">The source the module is loaded in.</param>
+    /// <param name="module">The module.</param>
+    /// <returns>The fingerprint, or nothing if the headers could not be read.</returns>
+    std::optional< fingerprint_t > fingerprint( const sources::source& source, const sources::module_t& module );
+}  // namespace vulkan::store
\ No newline at end of file
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "pe/image.hpp"
+#include "store/fingerprint.hpp"
+
+namespace vulkan::store
+{
+    /// <summary>
+    /// A directory of finished dumps, keyed by the fingerprint of the module they were taken from and the options that shaped them. Every
+    /// entry holds the saved image (`<key>.image`), the raw code pages that were acquired for it as a delta file (`<key>.pages`), and a
+    /// text file with the number of code pages that were missing (`<key>.entry`). Files are written under temporary names and renamed
+    /// into place, and the entry file is renamed last, so that processes sharing a store never see half of an entry.
+    /// </summary>
+    class result_store final
+    {
+        std::filesystem::path _directory;
+
+        /// <summary>
+        /// Returns the path of a file of an entry.
+        /// </summary>
+        std::filesystem::path path( std::string_view key, std::string_view extension ) const;
+
+       public:
+        /// <summary>
+        /// A stored dump.
+        /// </summary>
+        struct entry_t
+        {
+            std::filesystem::path image;
+            std::filesystem::path pages;
+
+            /// <summary>
+            /// The number of code pages that were never read. An entry without missing pages can be reused as is.
+            /// </summary>
+            std::size_t missing_pages;
+        };
+
+        /// <summary>
+        /// Opens a store, creating its directory if it does not exist.
+        /// </summary>
+        /// <param name="directory">The directory of the store.</param>
+        explicit result_store( std::filesystem::path directory );
+
+        /// <summary>
+        /// Builds the key of a dump.
+        /// </summary>
+        /// <param name="module_name">The name of the module.</param>
+        /// <param name="fingerprint">The fingerprint of the module.</param>
+        /// <param name="options">A hash of the options of the dump that change its output.</param>
+        static std::string key( std::string_view module_name, const fingerprint_t& fingerprint, std::uint64_t options );
+
+        /// <summary>
+        /// Finds the entry of a dump.
+        /// </summary>
+        /// <param name="key">The key of the dump.</param>
+        /// <returns>The entry, or nothing if the dump is not stored.</returns>
+        std::optional< entry_t > find( std::string_view key ) const;
+
+        /// <summary>
+        /// Loads the image of an entry.
+        /// </summary>
+        /// <param name="entry">The entry.</param>
+        /// <returns>The image, or a null pointer if it could not be read.</returns>
+        std::unique_ptr< pe::image > load( const entry_t& entry ) const;
+
+        /// <summary>
+        /// Writes the acquired code pages of a dump to a temporary file. Must be called before the image is post-processed, since the
+        /// pages are used to seed later dumps.
+        /// </summary>
+        /// <param name="key">The key of the dump.</param>
+        /// <param name="address">The address the module is loaded at.</param>
+        /// <param name="image">The image.</param>
+        /// <param name="pages">The relative virtual addresses of the code pages that were read, sorted.</param>
+        /// <returns>The path of the temporary file, or nothing if it could not be written.</returns>
+        std::optional< std::filesystem::path >
+        stage( std::string_view key, std::uintptr_t address, const pe::image& image, std::span< const std::uint32_t > pages ) const;
+
+        /// <summary>
+        /// Saves a finished dump, replacing an earlier entry with the same key.
+        /// </summary>
+        /// <param name="key">The key of the dump.</param>
+        /// <param name="image">The finished image.</param>
+        /// <param name="staged">The code pages, as returned by `stage`.</param>
+        /// <param name="missing_pages">The number of code pages that were never read.</param>
+        /// <returns>True if the entry was saved, false otherwise.</returns>
+        bool commit( std::string_view key, pe::image& image, const std::filesystem::path& staged, std::size_t missing_pages ) const;
+    };
+}  // namespace vulkan::store
\ No newline at end of file
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+
+/// The binary format of page-arrival traces. A trace is a header followed by a stream of events. Every event starts with its kind and
+/// the time since the previous event in microseconds, followed by a kind specific payload. Integers are LEB128 varints and strings are
+/// prefixed with their length.
+namespace vulkan::trace
+{
+    /// <summary>
+    /// The signature of a trace file ("VTRC").
+    /// </summary>
+    static constexpr std::uint32_t SIGNATURE = 0x43525456;
+
+    /// <summary>
+    /// The version of the trace format. Version 1 traces, which have no forwarder strings in their exports, and version 2 traces, which
+    /// have no API sets, are still read.
+    /// </summary>
+    static constexpr std::uint32_t VERSION = 3;
+
+    /// <summary>
+    /// The kinds of events in a trace.
+    /// </summary>
+    enum class event_t : std::uint8_t
+    {
+        /// <summary>
+        /// A module of the source: address, size, name and path.
+        /// </summary>
+        module = 1,
+
+        /// <summary>
+        /// A query of the page that contains an address: address.
+        /// </summary>
+        poll = 2,
+
+        /// <summary>
+        /// The accessibility of a page changed since it was last polled: page address and a readable flag (one byte).
+        /// </summary>
+        protect = 3,
+
+        /// <summary>
+        /// A successful read: address, size and the bytes that were read.
+        /// </summary>
+        read = 4,
+
+        /// <summary>
+        /// The exports of a module: module name, count and the name, address and forwarder string of every export.
+        /// </summary>
+        exports = 5,
+
+        /// <summary>
+        /// The API set schema of the source: count and the contract and host of every entry.
+        /// </summary>
+        api_sets = 6,
+    };
+
+    /// <summary>
+    /// Writes an unsigned LEB128 varint.
+    /// </summary>
+    inline void write_varint( std::ostream& out, std::uint64_t value )
+    {
+        do
+        {
+            const auto byte = static_cast< std::uint8_t >( ( value & 0x7F ) | ( value > 0x7F ? 0x80 : 0 ) );
+            out.put( static_cast< char >( byte ) );
+            value >>= 7;
+        } while ( value );
+    }
+
+    /// <summary>
+    /// Writes a length-prefixed string.
+    /// </summary>
+    inline void write_string( std::ostream& out, std::string_view value )
+    {
+        write_varint( out, value.size( ) );
+        out.write( value.data( ), static_cast< std::streamsize >( value.size( ) ) );
+    }
+
+    /// <summary>
+    /// Reads an unsigned LEB128 varint.
+    /// </summary>
+    /// <param name="data">The data to read from.</param>
+    /// <param name="offset">The offset to read at. It is advanced past the varint.</param>
+    /// <param name="value">The value that was read.</param>
+    /// <returns>False if the data ends before the varint does.</returns>
+    inline bool read_varint( std::span< const std::uint8_t > data, std::size_t& offset, std::uint64_t& value ) noexcept
+    {
+        value = 0;
+
+        for ( std::uint32_t shift = 0; shift < 64 && offset < data.size( ); shift += 7 )
+        {
+            const auto byte = data[ offset++ ];
+            value |= static_cast< std::uint64_t >( byte & 0x7F ) << shift;
+
+            if ( !( byte & 0x80 ) )
+                return true;
+        }
+
+        return false;
+    }
+
+    /// <summary>
+    /// Reads a length-prefixed string.
+    /// </summary>
+    /// <returns>False if the data ends before the string does.</returns>
+    inline bool read_string( std::span< const std::uint8_t > data, std::size_t& offset, std::string& value )
+    {
+        std::uint64_t size = 0;
+
+        if ( !read_varint( data, offset, size ) || size > data.size( ) - offset )
+            return false;
+
+        value.assign( reinterpret_cast< const char* >( data.data( ) + offset ), static_cast< std::size_t >( size ) );
+        offset += static_cast< std::size_t >( size );
+        return true;
+    }
+}  // namespace vulkan::trace
\ No newline at end of file
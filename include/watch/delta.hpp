@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "pe/image.hpp"
+
+/// The binary format of the delta files written in watch mode. A delta file holds the pages of an image that changed since the previous
+/// delta (or since the image was first saved). It starts with the signature, the version, the address the module is loaded at, the
+/// sequence number of the delta and the number of pages, followed by the relative virtual address and the 4096 bytes of every page.
+/// All integers are little endian: the first five are 32, 32, 64, 64 and 64 bits wide, and the address of a page is 32 bits.
+namespace vulkan::watch
+{
+    /// <summary>
+    /// The signature of a delta file ("VDLT").
+    /// </summary>
+    static constexpr std::uint32_t DELTA_SIGNATURE = 0x544C4456;
+
+    /// <summary>
+    /// The version of the delta format.
+    /// </summary>
+    static constexpr std::uint32_t DELTA_VERSION = 1;
+
+    /// <summary>
+    /// The contents of a delta file.
+    /// </summary>
+    struct delta_t
+    {
+        std::uintptr_t address;
+        std::uint64_t sequence;
+
+        /// <summary>
+        /// The relative virtual addresses of the pages, in the order they were written.
+        /// </summary>
+        std::vector< std::uint32_t > pages;
+
+        /// <summary>
+        /// The bytes of the pages, one page after the other.
+        /// </summary>
+        std::vector< std::uint8_t > bytes;
+
+        /// <summary>
+        /// Gets the bytes of the page at an index of `pages`.
+        /// </summary>
+        std::span< const std::uint8_t > page( std::size_t index ) const noexcept;
+    };
+
+    /// <summary>
+    /// Writes the current contents of some pages of an image to a delta file.
+    /// </summary>
+    /// <param name="path">The path of the delta file.</param>
+    /// <param name="address">The address the module is loaded at.</param>
+    /// <param name="sequence">The sequence number of the delta, starting at one.</param>
+    /// <param name="image">The image.</param>
+    /// <param name="pages">The relative virtual addresses of the pages.</param>
+    /// <returns>True if the file was written, false otherwise.</returns>
+    bool write_delta(
+        std::string_view path,
+        std::uintptr_t address,
+        std::uint64_t sequence,
+        const pe::image& image,
+        std::span< const std::uint32_t > pages );
+
+    /// <summary>
+    /// Reads a delta file.
+    /// </summary>
+    /// <param name="path">The path of the delta file.</param>
+    /// <returns>The pages of the delta, or nothing if the file could not be read or is not a delta file.</returns>
+    std::optional< delta_t > read_delta( std::string_view path );
+}  // namespace vulkan::watch
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "pe/image.hpp"
+#include "pe/util.hpp"
+#include "sources/region_map.hpp"
+
+namespace vulkan::watch
+{
+    /// <summary>
+    /// Watches the code pages of a dumped module for changes, such as code that is unpacked or patched long after the dump. Every page
+    /// is split into windows, and a hash of every window is kept. Each poll hashes a single window of every readable page, moving on to
+    /// the next window on every poll. Only a page whose window changed, or which was not read before and has become readable, is read
+    /// again in full. A change is therefore caught within as many polls as a page has windows, and a poll reads a fraction of the pages
+    /// that is one over the number of windows, plus the pages that changed.
+    /// </summary>
+    class watcher final
+    {
+        /// <summary>
+        /// The size of a window.
+        /// </summary>
+        static constexpr std::size_t WINDOW_SIZE = 256;
+
+        /// <summary>
+        /// The number of windows of a page.
+        /// </summary>
+        static constexpr std::size_t WINDOW_COUNT = pe::PAGE_SIZE / WINDOW_SIZE;
+
+        /// <summary>
+        /// A watched page.
+        /// </summary>
+        struct page_t
+        {
+            std::uint32_t rva;
+
+            /// <summary>
+            /// Whether the page was read, in which case the hashes are those of the bytes that were read.
+            /// </summary>
+            bool known;
+
+            std::array< std::uint64_t, WINDOW_COUNT > hashes;
+        };
+
+        const sources::source& _source;
+        std::uintptr_t _address;
+        pe::image& _image;
+
+        sources::region_map _regions;
+        std::vector< page_t > _pages;
+
+        std::size_t _round = 0;
+
+        /// <summary>
+        /// Copies a page that changed into the image and updates its hashes.
+        /// </summary>
+        void update( page_t& page, std::span< const std::uint8_t > bytes );
+
+       public:
+        /// <summary>
+        /// Starts watching code pages of an image. Must be called before the image is post-processed, since the hashes of the pages that
+        /// were read are taken from the image.
+        /// </summary>
+        /// <param name="source">The source the image was read from. It must outlive the watcher.</param>
+        /// <param name="address">The address the module is loaded at.</param>
+        /// <param name="image">The image. It must outlive the watcher.</param>
+        /// <param name="pages">The relative virtual addresses of the code pages to watch.</param>
+        /// <param name="read_pages">The relative virtual addresses of the code pages that were read.</param>
+        explicit watcher(
+            const sources::source& source,
+            std::uintptr_t address,
+            pe::image& image,
+            std::span< const std::uint32_t > pages,
+            std::span< const std::uint32_t > read_pages );
+
+        /// <summary>
+        /// Checks the pages for changes, and copies the pages that changed into the image.
+        /// </summary>
+        /// <returns>The relative virtual addresses of the pages that changed, in ascending order.</returns>
+        std::vector< std::uint32_t > poll( );
+
+        /// <summary>
+        /// Returns the number of watched pages.
+        /// </summary>
+        std::size_t size( ) const noexcept;
+
+        /// <summary>
+        /// Hashes a window. Four independent lanes of 64-bit words are mixed, so that the multiplications of neighboring words overlap.
+        /// </summary>
+        static std::uint64_t hash( std::span< const std::uint8_t > window ) noexcept;
+    };
+}  // namespace vulkan::watch
\ No newline at end of file
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+
+namespace vulkan::x86
+{
+    /// <summary>
+    /// The architectural limit of an x86 instruction in bytes.
+    /// </summary>
+    static constexpr std::size_t MAX_INSTRUCTION_LENGTH = 15;
+
+    /// <summary>
+    /// The opcode map an instruction was decoded from.
+    /// </summary>
+    enum class opcode_map_t : std::uint8_t
+    {
+        primary,
+        secondary,  // 0F
+        map_0f38,   // 0F 38
+        map_0f3a,   // 0F 3A
+        other       // XOP and EVEX-only maps
+    };
+
+    /// <summary>
+    /// The result of decoding a single instruction. Only the information required for locating references is kept.
+    /// </summary>
+    struct instruction_t
+    {
+        /// <summary>
+        /// The total length of the instruction in bytes.
+        /// </summary>
+        std::uint8_t length = 0;
+
+        /// <summary>
+        /// The opcode map of the instruction.
+        /// </summary>
+        opcode_map_t map = opcode_map_t::primary;
+
+        /// <summary>
+        /// The final opcode byte.
+        /// </summary>
+        std::uint8_t opcode = 0;
+
+        /// <summary>
+        /// The ModR/M byte, only valid if `has_modrm` is set.
+        /// </summary>
+        std::uint8_t modrm = 0;
+
+        /// <summary>
+        /// Whether the instruction has a ModR/M byte.
+        /// </summary>
+        bool has_modrm = false;
+
+        /// <summary>
+        /// Whether the instruction has a RIP-relative memory operand.
+        /// </summary>
+        bool rip_relative = false;
+
+        /// <summary>
+        /// Whether the instruction is a relative branch (call, jmp, jcc, loop).
+        /// </summary>
+        bool relative_branch = false;
+
+        /// <summary>
+        /// The offset of the displacement (or branch immediate) within the instruction.
+        /// </summary>
+        std::uint8_t disp_offset = 0;
+
+        /// <summary>
+        /// The size of the displacement (or branch immediate) in bytes.
+        /// </summary>
+        std::uint8_t disp_size = 0;
+
+        /// <summary>
+        /// The sign-extended displacement of a RIP-relative operand or relative branch.
+        /// </summary>
+        std::int32_t disp = 0;
+
+        /// <summary>
+        /// Returns the ModR/M reg field (without REX extension).
+        /// </summary>
+        constexpr std::uint8_t reg( ) const noexcept
+        {
+            return ( modrm >> 3 ) & 7;
+        }
+
+        /// <summary>
+        /// Returns whether this is a `call` instruction (direct or indirect).
+        /// </summary>
+        constexpr bool is_call( ) const noexcept
+        {
+            return map == opcode_map_t::primary && ( opcode == 0xE8 || ( opcode == 0xFF && ( reg( ) == 2 || reg( ) == 3 ) ) );
+        }
+
+        /// <summary>
+        /// Returns whether this is an unconditional or conditional jump (direct or indirect).
+        /// </summary>
+        constexpr bool is_jump( ) const noexcept
+        {
+            if ( map == opcode_map_t::secondary )
+                return opcode >= 0x80 && opcode <= 0x8F;
+
+            return map == opcode_map_t::primary &&
+                   ( opcode == 0xE9 || opcode == 0xEB || ( opcode >= 0x70 && opcode <= 0x7F ) || ( opcode >= 0xE0 && opcode <= 0xE3 ) ||
+                     ( opcode == 0xFF && ( reg( ) == 4 || reg( ) == 5 ) ) );
+        }
+
+        /// <summary>
+        /// Returns the absolute target of a RIP-relative operand or relative branch.
+        /// </summary>
+        /// <param name="address">The address of the instruction.</param>
+        constexpr std::uint64_t target( std::uint64_t address ) const noexcept
+        {
+            return address + length + static_cast< std::int64_t >( disp );
+        }
+    };
+
+    /// <summary>
+    /// Decodes the length and operand layout of a single 64-bit mode instruction.
+    /// </summary>
+    /// <param name="code">The bytes to decode. At most 15 bytes are read.</param>
+    /// <returns>The decoded instruction, or nothing if the bytes do not form a valid instruction.</returns>
+    std::optional< instruction_t > decode( std::span< const std::uint8_t > code ) noexcept;
+}  // namespace vulkan::x86
\ No newline at end of file
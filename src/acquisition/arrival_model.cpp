@@ -0,0 +1,89 @@
+#include "acquisition/arrival_model.hpp"
+
+#include <cmath>
+
+namespace vulkan::acquisition
+{
+    arrival_model::arrival_model( std::size_t total, clock::time_point start, std::size_t arrived, std::chrono::duration< double > smoothing ) noexcept
+        : _total( total ),
+          _arrived( arrived ),
+          _start( start ),
+          _last( start ),
+          _smoothing( smoothing.count( ) )
+    {
+    }
+
+    void arrival_model::observe( clock::time_point now, std::size_t arrived ) noexcept
+    {
+        const auto dt = std::chrono::duration< double >( now - _last ).count( );
+
+        // Observations closer together than the resolution of the clock carry no rate information, so accumulate them.
+        if ( dt <= 0.0 )
+            return;
+
+        const auto instantaneous = static_cast< double >( arrived - _arrived ) / dt;
+
+        // The weight of the new sample depends on the time it covers, so that the average is independent of how often the model is
+        // updated.
+        const auto alpha = _has_rate ? 1.0 - std::exp( -dt / _smoothing ) : 1.0;
+
+        _rate += alpha * ( instantaneous - _rate );
+        _has_rate = true;
+
+        _arrived = arrived;
+        _last = now;
+    }
+
+    double arrival_model::coverage( ) const noexcept
+    {
+        return _total ? static_cast< double >( _arrived ) / _total : 1.0;
+    }
+
+    std::chrono::duration< double > arrival_model::elapsed( ) const noexcept
+    {
+        return _last - _start;
+    }
+
+    bool arrival_model::is_warm( ) const noexcept
+    {
+        return _has_rate && elapsed( ).count( ) >= _smoothing;
+    }
+
+    double arrival_model::rate( ) const noexcept
+    {
+        return _rate;
+    }
+
+    double arrival_model::gain_per_second( ) const noexcept
+    {
+        return _total ? _rate / _total : 0.0;
+    }
+
+    double arrival_model::predict( std::chrono::duration< double > horizon ) const noexcept
+    {
+        const auto remaining = _total - _arrived;
+
+        if ( !remaining || _rate <= 0.0 )
+            return coverage( );
+
+        const auto lambda = _rate / remaining;
+
+        return coverage( ) + ( static_cast< double >( remaining ) / _total ) * ( 1.0 - std::exp( -lambda * horizon.count( ) ) );
+    }
+
+    std::optional< std::chrono::duration< double > > arrival_model::time_to( double coverage ) const noexcept
+    {
+        if ( coverage <= this->coverage( ) )
+            return std::chrono::duration< double >( 0.0 );
+
+        const auto remaining = _total - _arrived;
+        const auto needed = ( coverage - this->coverage( ) ) * _total;
+
+        if ( !remaining || _rate <= 0.0 || needed >= remaining )
+            return std::nullopt;
+
+        const auto lambda = _rate / remaining;
+
+        return std::chrono::duration< double >( -std::log( 1.0 - needed / remaining ) / lambda );
+    }
+}  // namespace vulkan::acquisition
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include "acquisition/page_weights.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+#include "pe/util.hpp"
+
+namespace vulkan::acquisition
+{
+    page_weights::page_weights(
+        std::uint32_t rva,
+        std::size_t count,
+        std::span< const std::uint32_t > function_starts,
+        std::span< const std::uint32_t > entry_points )
+        : _weights( count, 1.0 )
+    {
+        const auto page_of = [ & ]( std::uint32_t address ) -> std::size_t
+        { return address >= rva && ( address - rva ) / pe::PAGE_SIZE < count ? ( address - rva ) / pe::PAGE_SIZE : count; };
+
+        for ( const auto address : function_starts )
+        {
+            if ( const auto page = page_of( address ); page < count )
+                _weights[ page ] += 1.0;
+        }
+
+        for ( const auto address : entry_points )
+        {
+            if ( const auto page = page_of( address ); page < count )
+                _weights[ page ] += ENTRY_POINT_WEIGHT;
+        }
+
+        _total = std::accumulate( _weights.begin( ), _weights.end( ), 0.0 );
+    }
+
+    double page_weights::operator[]( std::size_t page ) const noexcept
+    {
+        return _weights[ page ];
+    }
+
+    double page_weights::total( ) const noexcept
+    {
+        return _total;
+    }
+
+    std::vector< std::size_t > page_weights::order( ) const
+    {
+        std::vector< std::size_t > pages( _weights.size( ) );
+        std::iota( pages.begin( ), pages.end( ), 0 );
+
+        std::stable_sort( pages.begin( ), pages.end( ), [ this ]( std::size_t a, std::size_t b ) { return _weights[ a ] > _weights[ b ]; } );
+
+        return pages;
+    }
+}  // namespace vulkan::acquisition
\ No newline at end of file
@@ -0,0 +1,36 @@
+#include "acquisition/termination.hpp"
+
+namespace vulkan::acquisition
+{
+    std::string_view to_string( stop_reason_t reason ) noexcept
+    {
+        switch ( reason )
+        {
+            case stop_reason_t::complete: return "complete";
+            case stop_reason_t::target_reached: return "target coverage reached";
+            case stop_reason_t::gain_too_low: return "coverage gain too low";
+            case stop_reason_t::deadline: return "deadline reached";
+            case stop_reason_t::exhausted: return "source exhausted";
+            case stop_reason_t::cancelled: return "cancelled";
+            default: return "running";
+        }
+    }
+
+    stop_reason_t termination_policy::evaluate( const arrival_model& model ) const noexcept
+    {
+        if ( model.coverage( ) >= 1.0 )
+            return stop_reason_t::complete;
+
+        if ( model.coverage( ) >= target )
+            return stop_reason_t::target_reached;
+
+        if ( deadline.count( ) > 0.0 && model.elapsed( ) >= deadline )
+            return stop_reason_t::deadline;
+
+        // The gain is only meaningful once the moving average has settled.
+        if ( min_gain_rate > 0.0 && model.is_warm( ) && model.gain_per_second( ) < min_gain_rate )
+            return stop_reason_t::gain_too_low;
+
+        return stop_reason_t::none;
+    }
+}  // namespace vulkan::acquisition
\ No newline at end of file
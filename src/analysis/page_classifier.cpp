@@ -0,0 +1,258 @@
+#include "analysis/page_classifier.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <format>
+#include <fstream>
+
+#include "parallel.hpp"
+#include "pe/util.hpp"
+
+#if defined( _M_X64 ) || defined( __x86_64__ )
+#include <emmintrin.h>
+#endif
+
+namespace vulkan::analysis
+{
+    namespace
+    {
+        /// <summary>
+        /// Random data has an entropy of almost 8 bits per byte, while compiled code rarely exceeds 6.5.
+        /// </summary>
+        static constexpr float ENCRYPTED_ENTROPY = 7.0f;
+
+        /// <summary>
+        /// The common bytes make up roughly 10% of random data, and well over a third of compiled code.
+        /// </summary>
+        static constexpr float CODE_PLAUSIBILITY = 0.2f;
+
+        /// <summary>
+        /// The bytes that are most frequent in x64 code: REX prefixes, `mov`, `lea`, `call`, `jcc`, `test`, `cmp`, padding, and the
+        /// ModR/M and SIB bytes of stack accesses.
+        /// </summary>
+        static constexpr auto COMMON_BYTES = []( )
+        {
+            std::array< bool, 256 > common = { };
+
+            for ( const auto value : { 0x00, 0x08, 0x0F, 0x10, 0x20, 0x24, 0x28, 0x30, 0x40, 0x41, 0x44, 0x48, 0x49, 0x4C, 0x74, 0x75,
+                                       0x83, 0x84, 0x85, 0x89, 0x8B, 0x8D, 0xC3, 0xC7, 0xCC, 0xE8, 0xE9, 0xEB, 0xFF } )
+                common[ value ] = true;
+
+            return common;
+        }( );
+
+        /// <summary>
+        /// `n * log2( n )` for every count a page can have, so that the entropy of a page takes no logarithms.
+        /// </summary>
+        const std::array< float, pe::PAGE_SIZE + 1 >& n_log_n( ) noexcept
+        {
+            static const auto table = []( )
+            {
+                std::array< float, pe::PAGE_SIZE + 1 > values = { };
+
+                for ( std::size_t n = 1; n < values.size( ); ++n )
+                    values[ n ] = static_cast< float >( n * std::log2( static_cast< double >( n ) ) );
+
+                return values;
+            }( );
+
+            return table;
+        }
+
+        /// <summary>
+        /// Counts the bytes of a buffer. Four interleaved histograms keep repeated bytes from stalling on the same counter.
+        /// </summary>
+        std::array< std::uint32_t, 256 > histogram( std::span< const std::uint8_t > data ) noexcept
+        {
+            std::array< std::array< std::uint32_t, 256 >, 4 > partial = { };
+
+            std::size_t i = 0;
+
+            for ( ; i + 4 <= data.size( ); i += 4 )
+            {
+                ++partial[ 0 ][ data[ i ] ];
+                ++partial[ 1 ][ data[ i + 1 ] ];
+                ++partial[ 2 ][ data[ i + 2 ] ];
+                ++partial[ 3 ][ data[ i + 3 ] ];
+            }
+
+            for ( ; i < data.size( ); ++i )
+                ++partial[ 0 ][ data[ i ] ];
+
+            for ( std::size_t value = 0; value < 256; ++value )
+                partial[ 0 ][ value ] += partial[ 1 ][ value ] + partial[ 2 ][ value ] + partial[ 3 ][ value ];
+
+            return partial[ 0 ];
+        }
+
+        /// <summary>
+        /// Returns the length of the longest run of a byte. Sixteen bytes are compared at once with SSE2, and blocks that match entirely
+        /// only extend the current run.
+        /// </summary>
+        std::uint32_t longest_run( std::span< const std::uint8_t > data, std::uint8_t value ) noexcept
+        {
+            std::uint32_t best = 0, current = 0;
+            std::size_t i = 0;
+
+#if defined( _M_X64 ) || defined( __x86_64__ )
+            const auto needle = _mm_set1_epi8( static_cast< char >( value ) );
+
+            for ( ; i + 16 <= data.size( ); i += 16 )
+            {
+                const auto block = _mm_loadu_si128( reinterpret_cast< const __m128i* >( data.data( ) + i ) );
+                const auto mask = static_cast< std::uint16_t >( _mm_movemask_epi8( _mm_cmpeq_epi8( block, needle ) ) );
+
+                if ( mask == 0xFFFF )
+                {
+                    current += 16;
+                    continue;
+                }
+
+                // The current run ends at the first mismatch.
+                best = std::max< std::uint32_t >( best, current + std::countr_one( mask ) );
+
+                // Runs that lie entirely inside the block. Every step shortens all runs of the mask by one.
+                std::uint32_t inner = 0;
+
+                for ( auto bits = mask; bits; bits &= bits >> 1 )
+                    ++inner;
+
+                best = std::max( best, inner );
+
+                // A new run starts after the last mismatch.
+                current = std::countl_one( mask );
+            }
+#endif
+
+            for ( ; i < data.size( ); ++i )
+            {
+                if ( data[ i ] == value )
+                    best = std::max( best, ++current );
+                else
+                    current = 0;
+            }
+
+            return std::max( best, current );
+        }
+    }  // namespace
+
+    std::string_view to_string( page_class_t type ) noexcept
+    {
+        switch ( type )
+        {
+            case page_class_t::filler: return "filler";
+            case page_class_t::zero: return "zero";
+            case page_class_t::code: return "code";
+            case page_class_t::data: return "data";
+            case page_class_t::encrypted: return "encrypted";
+            default: return "unknown";
+        }
+    }
+
+    page_profile_t classify_page( std::span< const std::uint8_t > page ) noexcept
+    {
+        page_profile_t profile = { page_class_t::filler, 0.0f, 0.0f, 0, 0 };
+
+        if ( page.empty( ) )
+            return profile;
+
+        profile.filler_run = longest_run( page, 0x90 );
+
+        if ( profile.filler_run == page.size( ) )
+            return profile;
+
+        profile.zero_run = longest_run( page, 0x00 );
+
+        if ( profile.zero_run == page.size( ) )
+        {
+            profile.type = page_class_t::zero;
+            return profile;
+        }
+
+        const auto counts = histogram( page );
+        const auto size = static_cast< float >( page.size( ) );
+
+        // H = log2( N ) - sum( c * log2( c ) ) / N
+        float sum = 0.0f;
+        std::size_t common = 0;
+
+        for ( std::size_t value = 0; value < counts.size( ); ++value )
+        {
+            const auto count = counts[ value ];
+
+            sum += count <= pe::PAGE_SIZE ? n_log_n( )[ count ] : static_cast< float >( count * std::log2( static_cast< double >( count ) ) );
+
+            if ( COMMON_BYTES[ value ] )
+                common += count;
+        }
+
+        profile.entropy = std::log2( size ) - sum / size;
+        profile.plausibility = static_cast< float >( common ) / size;
+
+        if ( profile.plausibility >= CODE_PLAUSIBILITY )
+            profile.type = page_class_t::code;
+        else if ( profile.entropy >= ENCRYPTED_ENTROPY )
+            profile.type = page_class_t::encrypted;
+        else
+            profile.type = page_class_t::data;
+
+        return profile;
+    }
+
+    std::vector< page_coverage_t > classify_pages( const pe::image_view& image )
+    {
+        std::vector< page_coverage_t > pages;
+
+        for ( const auto& section : image.sections( ) )
+        {
+            if ( !( section.Characteristics & pe::SCN_CNT_CODE ) )
+                continue;
+
+            for ( std::uint32_t offset = 0; offset < section.Misc.VirtualSize; offset += pe::PAGE_SIZE )
+                pages.push_back( { section.VirtualAddress + offset, { }, false } );
+        }
+
+        const auto chunks = split( pages.size( ), 64 );
+
+        parallel_for(
+            chunks,
+            [ & ]( std::size_t, std::size_t begin, std::size_t end )
+            {
+                for ( auto i = begin; i < end; ++i )
+                {
+                    const auto section = image.section_of( pages[ i ].rva );
+                    const auto size =
+                        std::min< std::uint32_t >( pe::PAGE_SIZE, section->VirtualAddress + section->Misc.VirtualSize - pages[ i ].rva );
+
+                    pages[ i ].profile = classify_page( image.bytes( pages[ i ].rva, size ) );
+                }
+            } );
+
+        return pages;
+    }
+
+    bool save_coverage_map( std::string_view path, std::span< const page_coverage_t > pages )
+    {
+        std::ofstream file{ std::string( path ) };
+
+        if ( !file.is_open( ) )
+            return false;
+
+        file << "# rva class entropy plausibility filler-run zero-run accepted\n";
+
+        for ( const auto& [ rva, profile, accepted ] : pages )
+            file << std::format(
+                "0x{:08X} {} {:.3f} {:.3f} {} {} {}\n",
+                rva,
+                to_string( profile.type ),
+                profile.entropy,
+                profile.plausibility,
+                profile.filler_run,
+                profile.zero_run,
+                accepted ? 1 : 0 );
+
+        return file.good( );
+    }
+}  // namespace vulkan::analysis
\ No newline at end of file
@@ -0,0 +1,217 @@
+#include "analysis/pointer_scan.hpp"
+
+#include <algorithm>
+
+#include "parallel.hpp"
+#include "pe/util.hpp"
+
+#if defined( _M_X64 ) || defined( __x86_64__ )
+#include <emmintrin.h>
+#endif
+
+namespace vulkan::analysis
+{
+    namespace
+    {
+        /// <summary>
+        /// The number of pointer-sized values processed by a single task.
+        /// </summary>
+        static constexpr std::size_t BLOCK_SIZE = 0x2000;
+
+        /// <summary>
+        /// A block of data to scan, in relative virtual addresses and the matching values.
+        /// </summary>
+        template< typename Pointer >
+        struct block_t
+        {
+            std::uint32_t rva;
+            const Pointer* data;
+            std::uint32_t count;
+        };
+
+        /// <summary>
+        /// Appends the index of every value in the range where `value - base < size`. The comparison is done with SSE2, which is always
+        /// available on x64. Since the size of an image fits in 32 bits, a 64-bit value is in range if the upper half of the difference is
+        /// zero and the lower half is below the size. 32-bit values are compared directly, four per vector.
+        /// </summary>
+        template< typename Pointer >
+        void scan_range( const Pointer* data, std::size_t count, Pointer base, std::uint32_t size, std::vector< std::uint32_t >& out )
+        {
+            std::size_t i = 0;
+
+#if defined( _M_X64 ) || defined( __x86_64__ )
+            const auto bias = _mm_set1_epi32( static_cast< int >( 0x80000000 ) );
+            const auto limit = _mm_set1_epi32( static_cast< int >( size ^ 0x80000000 ) );
+
+            if constexpr ( sizeof( Pointer ) == sizeof( std::uint64_t ) )
+            {
+                const auto vbase = _mm_set1_epi64x( static_cast< long long >( base ) );
+                const auto zero = _mm_setzero_si128( );
+
+                const auto in_range = [ & ]( __m128i value )
+                {
+                    const auto delta = _mm_sub_epi64( value, vbase );
+                    const auto below = _mm_cmplt_epi32( _mm_xor_si128( delta, bias ), limit );
+                    const auto high_zero = _mm_srli_epi64( _mm_cmpeq_epi32( delta, zero ), 32 );
+
+                    return _mm_and_si128( below, high_zero );
+                };
+
+                for ( ; i + 4 <= count; i += 4 )
+                {
+                    const auto a = in_range( _mm_loadu_si128( reinterpret_cast< const __m128i* >( data + i ) ) );
+                    const auto b = in_range( _mm_loadu_si128( reinterpret_cast< const __m128i* >( data + i + 2 ) ) );
+
+                    // Almost every value is out of range, so only fall back to scalar code when one of the four is a candidate.
+                    if ( !( _mm_movemask_epi8( _mm_or_si128( a, b ) ) & 0x0F0F ) )
+                        continue;
+
+                    for ( auto j = i; j < i + 4; ++j )
+                    {
+                        if ( data[ j ] - base < size )
+                            out.push_back( static_cast< std::uint32_t >( j ) );
+                    }
+                }
+            }
+            else
+            {
+                const auto vbase = _mm_set1_epi32( static_cast< int >( base ) );
+
+                const auto in_range = [ & ]( __m128i value )
+                { return _mm_cmplt_epi32( _mm_xor_si128( _mm_sub_epi32( value, vbase ), bias ), limit ); };
+
+                for ( ; i + 8 <= count; i += 8 )
+                {
+                    const auto a = in_range( _mm_loadu_si128( reinterpret_cast< const __m128i* >( data + i ) ) );
+                    const auto b = in_range( _mm_loadu_si128( reinterpret_cast< const __m128i* >( data + i + 4 ) ) );
+
+                    if ( !_mm_movemask_epi8( _mm_or_si128( a, b ) ) )
+                        continue;
+
+                    for ( auto j = i; j < i + 8; ++j )
+                    {
+                        if ( static_cast< Pointer >( data[ j ] - base ) < size )
+                            out.push_back( static_cast< std::uint32_t >( j ) );
+                    }
+                }
+            }
+#endif
+
+            for ( ; i < count; ++i )
+            {
+                if ( static_cast< Pointer >( data[ i ] - base ) < size )
+                    out.push_back( static_cast< std::uint32_t >( i ) );
+            }
+        }
+
+        /// <summary>
+        /// Scans the data sections of an image for pointers of its architecture.
+        /// </summary>
+        template< typename Arch >
+        std::vector< std::uint32_t > scan( const pe::image_view& image, const xref_table& xrefs )
+        {
+            using pointer_t = typename Arch::pointer_t;
+
+            const auto relocation_directory = image.data_directory( pe::DIRECTORY_ENTRY_BASERELOC );
+
+            std::vector< block_t< pointer_t > > blocks;
+
+            // Executable ranges, used to validate pointers into code.
+            std::vector< std::pair< std::uint32_t, std::uint32_t > > code_ranges;
+
+            for ( const auto& header : image.sections( ) )
+            {
+                const auto section = &header;
+
+                if ( section->Characteristics & ( pe::SCN_CNT_CODE | pe::SCN_MEM_EXECUTE ) )
+                {
+                    code_ranges.emplace_back( section->VirtualAddress, section->VirtualAddress + section->Misc.VirtualSize );
+                    continue;
+                }
+
+                // Skip uninitialized data and the (possibly stale) relocation directory itself.
+                if ( !( section->Characteristics & pe::SCN_CNT_INITIALIZED_DATA ) || !section->SizeOfRawData ||
+                     ( relocation_directory.VirtualAddress >= section->VirtualAddress &&
+                       relocation_directory.VirtualAddress < section->VirtualAddress + section->Misc.VirtualSize ) )
+                    continue;
+
+                const auto begin = pe::align< std::uint32_t >( section->VirtualAddress, sizeof( pointer_t ) );
+                const auto end = section->VirtualAddress + std::min< std::uint32_t >( section->Misc.VirtualSize, section->SizeOfRawData );
+
+                for ( auto rva = begin; rva + sizeof( pointer_t ) <= end; rva += BLOCK_SIZE * sizeof( pointer_t ) )
+                {
+                    const auto count = std::min< std::size_t >( BLOCK_SIZE, ( end - rva ) / sizeof( pointer_t ) );
+                    const auto data = image.array< pointer_t >( rva, count );
+
+                    if ( data.empty( ) )
+                        break;
+
+                    blocks.push_back( { rva, data.data( ), static_cast< std::uint32_t >( count ) } );
+                }
+            }
+
+            // Valid targets inside code: function starts and the targets of code references.
+            std::vector< std::uint32_t > code_targets;
+
+            for ( const auto& entry : image.runtime_functions( ) )
+                code_targets.push_back( entry.BeginAddress );
+
+            for ( const auto& xref : xrefs.xrefs( ) )
+                code_targets.push_back( xref.target );
+
+            std::sort( code_targets.begin( ), code_targets.end( ) );
+
+            const auto base = static_cast< pointer_t >( image.image_base( ) );
+            const auto size = image.size_of_image( );
+
+            const auto is_code = [ & ]( std::uint32_t rva )
+            {
+                return std::any_of(
+                    code_ranges.begin( ), code_ranges.end( ), [ rva ]( const auto& range ) { return rva >= range.first && rva < range.second; } );
+            };
+
+            const auto chunks = split( blocks.size( ) );
+            std::vector< std::vector< std::uint32_t > > results( chunks.size( ) );
+
+            parallel_for(
+                chunks,
+                [ & ]( std::size_t index, std::size_t first, std::size_t last )
+                {
+                    std::vector< std::uint32_t > hits;
+
+                    for ( auto b = first; b < last; ++b )
+                    {
+                        const auto& block = blocks[ b ];
+                        const auto data = block.data;
+
+                        hits.clear( );
+                        scan_range( data, block.count, base, size, hits );
+
+                        for ( const auto hit : hits )
+                        {
+                            const auto target = static_cast< std::uint32_t >( data[ hit ] - base );
+
+                            // Pointers into code must be corroborated by the code itself.
+                            if ( is_code( target ) && !std::binary_search( code_targets.begin( ), code_targets.end( ), target ) )
+                                continue;
+
+                            results[ index ].push_back( block.rva + hit * static_cast< std::uint32_t >( sizeof( pointer_t ) ) );
+                        }
+                    }
+                } );
+
+            std::vector< std::uint32_t > pointers;
+
+            for ( const auto& result : results )
+                pointers.insert( pointers.end( ), result.begin( ), result.end( ) );
+
+            // Blocks are split in ascending order, so the result is already sorted.
+            return pointers;
+        }
+    }  // namespace
+
+    std::vector< std::uint32_t > scan_pointers( const pe::image_view& image, const xref_table& xrefs )
+    {
+        return pe::dispatch( image.arch( ), [ & ]< typename Arch >( Arch ) { return scan< Arch >( image, xrefs ); } );
+    }
+}  // namespace vulkan::analysis
\ No newline at end of file
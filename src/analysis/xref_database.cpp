@@ -0,0 +1,359 @@
+#include "analysis/xref_database.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <tuple>
+
+#include "trace/format.hpp"
+
+namespace vulkan::analysis
+{
+    namespace
+    {
+        /// <summary>
+        /// The header of a cross reference database.
+        /// </summary>
+        struct header_t
+        {
+            std::uint32_t signature;
+            std::uint32_t version;
+            std::uint32_t count;
+            std::uint32_t block_size;
+            std::uint32_t import_count;
+            std::uint32_t imports_offset;
+            std::uint32_t source_index_offset;
+            std::uint32_t target_index_offset;
+        };
+
+        /// <summary>
+        /// A reference in one of the orders of the database, with the address it is sorted by as its key.
+        /// </summary>
+        struct row_t
+        {
+            std::uint32_t key;
+            std::uint32_t other;
+            std::uint8_t flags;
+
+            /// <summary>
+            /// The index of the import plus one, or zero.
+            /// </summary>
+            std::uint32_t import;
+        };
+
+        std::uint64_t zigzag( std::int64_t value ) noexcept
+        {
+            return ( static_cast< std::uint64_t >( value ) << 1 ) ^ static_cast< std::uint64_t >( value >> 63 );
+        }
+
+        std::int64_t unzigzag( std::uint64_t value ) noexcept
+        {
+            return static_cast< std::int64_t >( value >> 1 ) ^ -static_cast< std::int64_t >( value & 1 );
+        }
+
+        /// <summary>
+        /// Encodes rows that are sorted by their key into blocks, and returns the first key and offset of every block.
+        /// </summary>
+        template< typename Block >
+        std::vector< Block > encode( std::span< const row_t > rows, std::uint32_t base, std::ostringstream& out )
+        {
+            std::vector< Block > blocks;
+
+            for ( std::size_t first = 0; first < rows.size( ); first += XREF_DATABASE_BLOCK_SIZE )
+            {
+                const auto block = rows.subspan( first, std::min< std::size_t >( XREF_DATABASE_BLOCK_SIZE, rows.size( ) - first ) );
+
+                blocks.push_back( { block.front( ).key, base + static_cast< std::uint32_t >( out.tellp( ) ) } );
+
+                auto previous = block.front( ).key;
+
+                for ( const auto& row : block )
+                {
+                    trace::write_varint( out, row.key - previous );
+                    previous = row.key;
+                }
+
+                for ( const auto& row : block )
+                    trace::write_varint( out, zigzag( static_cast< std::int64_t >( row.other ) - row.key ) );
+
+                for ( const auto& row : block )
+                    out.put( static_cast< char >( row.flags ) );
+
+                for ( const auto& row : block )
+                    trace::write_varint( out, row.import );
+            }
+
+            return blocks;
+        }
+    }  // namespace
+
+    bool save_xref_database( std::string_view path, std::span< const xref_t > xrefs, std::span< const xref_import_t > imports )
+    {
+        using block_t = xref_database::block_t;
+        using import_entry_t = xref_database::import_entry_t;
+
+        std::vector< xref_import_t > sorted( imports.begin( ), imports.end( ) );
+        std::sort( sorted.begin( ), sorted.end( ), []( const xref_import_t& a, const xref_import_t& b ) { return a.slot < b.slot; } );
+
+        std::vector< row_t > rows;
+        rows.reserve( xrefs.size( ) );
+
+        for ( const auto& xref : xrefs )
+        {
+            std::uint32_t import = 0;
+
+            // Only memory operands go through an import address table entry.
+            if ( xref.indirect )
+            {
+                const auto it = std::lower_bound(
+                    sorted.begin( ),
+                    sorted.end( ),
+                    xref.target,
+                    []( const xref_import_t& entry, std::uint32_t slot ) { return entry.slot < slot; } );
+
+                if ( it != sorted.end( ) && it->slot == xref.target )
+                    import = static_cast< std::uint32_t >( it - sorted.begin( ) ) + 1;
+            }
+
+            const auto flags = static_cast< std::uint8_t >( static_cast< std::uint8_t >( xref.kind ) | ( xref.indirect ? 4 : 0 ) );
+
+            rows.push_back( { xref.source, xref.target, flags, import } );
+        }
+
+        const auto by_key = []( const row_t& a, const row_t& b ) { return std::tie( a.key, a.other ) < std::tie( b.key, b.other ); };
+
+        std::sort( rows.begin( ), rows.end( ), by_key );
+
+        const auto block_count = ( rows.size( ) + XREF_DATABASE_BLOCK_SIZE - 1 ) / XREF_DATABASE_BLOCK_SIZE;
+
+        header_t header = { };
+
+        header.signature = XREF_DATABASE_SIGNATURE;
+        header.version = XREF_DATABASE_VERSION;
+        header.count = static_cast< std::uint32_t >( rows.size( ) );
+        header.block_size = XREF_DATABASE_BLOCK_SIZE;
+        header.import_count = static_cast< std::uint32_t >( sorted.size( ) );
+        header.imports_offset = sizeof( header_t );
+        header.source_index_offset = header.imports_offset + static_cast< std::uint32_t >( sorted.size( ) * sizeof( import_entry_t ) );
+        header.target_index_offset = header.source_index_offset + static_cast< std::uint32_t >( block_count * sizeof( block_t ) );
+
+        // The names follow the block tables, and the blocks follow the names.
+        auto offset = header.target_index_offset + static_cast< std::uint32_t >( block_count * sizeof( block_t ) );
+
+        std::vector< import_entry_t > entries;
+        entries.reserve( sorted.size( ) );
+
+        for ( const auto& import : sorted )
+        {
+            entries.push_back( { import.slot, offset, static_cast< std::uint32_t >( import.name.size( ) ) } );
+            offset += static_cast< std::uint32_t >( import.name.size( ) );
+        }
+
+        std::ostringstream data;
+
+        const auto by_source = encode< block_t >( rows, offset, data );
+
+        for ( auto& row : rows )
+            std::swap( row.key, row.other );
+
+        std::sort( rows.begin( ), rows.end( ), by_key );
+
+        const auto by_target = encode< block_t >( rows, offset, data );
+
+        std::ofstream file( std::string( path ), std::ios::binary );
+
+        if ( !file )
+            return false;
+
+        const auto write = [ & ]< typename T >( std::span< const T > values )
+        { file.write( reinterpret_cast< const char* >( values.data( ) ), static_cast< std::streamsize >( values.size_bytes( ) ) ); };
+
+        write( std::span< const header_t >( &header, 1 ) );
+        write( std::span< const import_entry_t >( entries ) );
+        write( std::span< const block_t >( by_source ) );
+        write( std::span< const block_t >( by_target ) );
+
+        for ( const auto& import : sorted )
+            file.write( import.name.data( ), static_cast< std::streamsize >( import.name.size( ) ) );
+
+        const auto blocks = std::move( data ).str( );
+        file.write( blocks.data( ), static_cast< std::streamsize >( blocks.size( ) ) );
+
+        return file.good( );
+    }
+
+    xref_database::xref_database( std::string_view path ) noexcept : _file( path )
+    {
+        const auto data = _file.data( );
+
+        header_t header;
+
+        if ( !_file.is_valid( ) || data.size( ) < sizeof( header ) )
+            return;
+
+        std::memcpy( &header, data.data( ), sizeof( header ) );
+
+        if ( header.signature != XREF_DATABASE_SIGNATURE || header.version != XREF_DATABASE_VERSION || !header.block_size )
+            return;
+
+        const std::size_t block_count = ( static_cast< std::size_t >( header.count ) + header.block_size - 1 ) / header.block_size;
+
+        const auto table = [ & ]< typename T >( std::uint32_t offset, std::size_t count, std::span< const T >& out )
+        {
+            if ( offset % alignof( T ) || offset > data.size( ) || count > ( data.size( ) - offset ) / sizeof( T ) )
+                return false;
+
+            out = { reinterpret_cast< const T* >( data.data( ) + offset ), count };
+            return true;
+        };
+
+        if ( !table( header.imports_offset, header.import_count, _imports ) || !table( header.source_index_offset, block_count, _by_source ) ||
+             !table( header.target_index_offset, block_count, _by_target ) )
+            return;
+
+        for ( const auto& import : _imports )
+        {
+            if ( import.name_offset > data.size( ) || import.name_size > data.size( ) - import.name_offset )
+                return;
+        }
+
+        _count = header.count;
+        _block_size = header.block_size;
+    }
+
+    bool xref_database::decode( std::span< const block_t > blocks, std::size_t index, std::vector< xref_record_t >& out ) const
+    {
+        const auto data = _file.data( );
+        const auto count = std::min( _block_size, _count - index * _block_size );
+        const auto first = out.size( );
+
+        out.resize( first + count );
+
+        const auto records = std::span( out ).subspan( first );
+
+        std::size_t offset = blocks[ index ].offset;
+        std::uint64_t value = 0;
+
+        auto key = blocks[ index ].first_key;
+
+        for ( auto& record : records )
+        {
+            if ( !trace::read_varint( data, offset, value ) )
+                return false;
+
+            record.source = key += static_cast< std::uint32_t >( value );
+        }
+
+        for ( auto& record : records )
+        {
+            if ( !trace::read_varint( data, offset, value ) )
+                return false;
+
+            record.target = static_cast< std::uint32_t >( record.source + unzigzag( value ) );
+        }
+
+        if ( count > data.size( ) - std::min( offset, data.size( ) ) )
+            return false;
+
+        for ( auto& record : records )
+        {
+            const auto flags = data[ offset++ ];
+
+            record.kind = static_cast< xref_kind_t >( flags & 3 );
+            record.indirect = flags & 4;
+        }
+
+        for ( auto& record : records )
+        {
+            if ( !trace::read_varint( data, offset, value ) || value > _imports.size( ) )
+                return false;
+
+            if ( value )
+            {
+                const auto& import = _imports[ value - 1 ];
+                record.import = { reinterpret_cast< const char* >( data.data( ) + import.name_offset ), import.name_size };
+            }
+        }
+
+        return true;
+    }
+
+    std::vector< xref_record_t > xref_database::find( std::span< const block_t > blocks, std::uint32_t key, bool by_target ) const
+    {
+        std::vector< xref_record_t > result, block;
+
+        // The first block that starts at or after the key. The block before it may still end with the key.
+        auto index = static_cast< std::size_t >(
+            std::lower_bound( blocks.begin( ), blocks.end( ), key, []( const block_t& b, std::uint32_t k ) { return b.first_key < k; } ) -
+            blocks.begin( ) );
+
+        if ( index )
+            --index;
+
+        for ( ; index < blocks.size( ) && blocks[ index ].first_key <= key; ++index )
+        {
+            block.clear( );
+
+            if ( !decode( blocks, index, block ) )
+                break;
+
+            for ( auto& record : block )
+            {
+                if ( record.source != key )
+                    continue;
+
+                if ( by_target )
+                    std::swap( record.source, record.target );
+
+                result.push_back( record );
+            }
+
+            if ( block.back( ).source > key )
+                break;
+        }
+
+        return result;
+    }
+
+    bool xref_database::is_valid( ) const noexcept
+    {
+        return _block_size != 0;
+    }
+
+    std::size_t xref_database::size( ) const noexcept
+    {
+        return _count;
+    }
+
+    std::vector< xref_record_t > xref_database::from( std::uint32_t source ) const
+    {
+        return find( _by_source, source, false );
+    }
+
+    std::vector< xref_record_t > xref_database::to( std::uint32_t target ) const
+    {
+        return find( _by_target, target, true );
+    }
+
+    std::vector< xref_record_t > xref_database::to_import( std::string_view name ) const
+    {
+        if ( const auto address = slot( name ) )
+            return to( *address );
+
+        return { };
+    }
+
+    std::optional< std::uint32_t > xref_database::slot( std::string_view name ) const noexcept
+    {
+        const auto data = _file.data( );
+
+        for ( const auto& import : _imports )
+        {
+            if ( std::string_view( reinterpret_cast< const char* >( data.data( ) + import.name_offset ), import.name_size ) == name )
+                return import.slot;
+        }
+
+        return std::nullopt;
+    }
+}  // namespace vulkan::analysis
\ No newline at end of file
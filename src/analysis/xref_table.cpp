@@ -0,0 +1,161 @@
+#include "analysis/xref_table.hpp"
+
+#include <algorithm>
+
+#include "parallel.hpp"
+#include "x86/decoder.hpp"
+
+namespace vulkan::analysis
+{
+    namespace
+    {
+        /// <summary>
+        /// A range of code to sweep, in relative virtual addresses and the matching bytes.
+        /// </summary>
+        struct code_range_t
+        {
+            std::uint32_t begin;
+            std::uint32_t end;
+            const std::uint8_t* data;
+        };
+
+        /// <summary>
+        /// Collects the ranges of code to sweep. Functions from the exception directory are preferred, as they only cover code that
+        /// is actually reachable.
+        /// </summary>
+        std::vector< code_range_t > collect_code_ranges( const pe::image_view& image )
+        {
+            std::vector< code_range_t > ranges;
+
+            // Validates a range. The whole range must be backed by the same section.
+            const auto add_range = [ & ]( std::uint32_t begin, std::uint32_t end )
+            {
+                if ( begin >= end )
+                    return;
+
+                if ( const auto data = image.bytes( begin, end - begin ); !data.empty( ) )
+                    ranges.push_back( { begin, end, data.data( ) } );
+            };
+
+            for ( const auto& entry : image.runtime_functions( ) )
+                add_range( entry.BeginAddress, entry.EndAddress );
+
+            if ( !ranges.empty( ) )
+                return ranges;
+
+            // No exception directory, so fall back to sweeping every executable section.
+            for ( const auto& section : image.sections( ) )
+            {
+                if ( section.Characteristics & ( pe::SCN_CNT_CODE | pe::SCN_MEM_EXECUTE ) )
+                    add_range( section.VirtualAddress, section.VirtualAddress + section.Misc.VirtualSize );
+            }
+
+            return ranges;
+        }
+
+        /// <summary>
+        /// Decodes a range of code and appends every reference to the output.
+        /// </summary>
+        void sweep( const pe::image_view& image, const code_range_t& range, std::vector< xref_t >& out )
+        {
+            const auto data = range.data;
+            const auto size_of_image = image.size_of_image( );
+
+            for ( std::uint32_t rva = range.begin; rva < range.end; )
+            {
+                const auto remaining = std::min< std::size_t >( range.end - rva, x86::MAX_INSTRUCTION_LENGTH );
+                const auto insn = x86::decode( { data + ( rva - range.begin ), remaining } );
+
+                // Resynchronize on the next byte if the bytes do not form an instruction.
+                if ( !insn )
+                {
+                    ++rva;
+                    continue;
+                }
+
+                if ( insn->rip_relative || insn->relative_branch )
+                {
+                    const auto target = static_cast< std::int64_t >( rva ) + insn->length + insn->disp;
+
+                    if ( target >= 0 && target < size_of_image )
+                    {
+                        auto kind = xref_kind_t::data;
+
+                        if ( insn->is_call( ) )
+                            kind = xref_kind_t::call;
+                        else if ( insn->is_jump( ) )
+                            kind = xref_kind_t::jump;
+
+                        out.push_back( { rva, static_cast< std::uint32_t >( target ), insn->length, insn->disp_offset, kind, insn->rip_relative } );
+                    }
+                }
+
+                rva += insn->length;
+            }
+        }
+    }  // namespace
+
+    xref_table::xref_table( std::vector< xref_t >&& xrefs ) noexcept : _xrefs( std::move( xrefs ) )
+    {
+    }
+
+    xref_table xref_table::build( const pe::image_view& image )
+    {
+        // The decoder only knows 64-bit code, and sweeping 32-bit code with it would yield references that do not exist.
+        if ( image.arch( ) != pe::arch_t::pe64 )
+            return xref_table( { } );
+
+        const auto ranges = collect_code_ranges( image );
+        const auto chunks = split( ranges.size( ), 64 );
+
+        std::vector< std::vector< xref_t > > results( chunks.size( ) );
+
+        parallel_for(
+            chunks,
+            [ & ]( std::size_t index, std::size_t begin, std::size_t end )
+            {
+                for ( auto i = begin; i < end; ++i )
+                    sweep( image, ranges[ i ], results[ index ] );
+            } );
+
+        std::size_t total = 0;
+
+        for ( const auto& result : results )
+            total += result.size( );
+
+        std::vector< xref_t > xrefs;
+        xrefs.reserve( total );
+
+        for ( const auto& result : results )
+            xrefs.insert( xrefs.end( ), result.begin( ), result.end( ) );
+
+        std::sort( xrefs.begin( ), xrefs.end( ), []( const xref_t& a, const xref_t& b ) { return a.source < b.source; } );
+
+        // Chained unwind entries may describe the same code twice, so drop any duplicates.
+        xrefs.erase(
+            std::unique( xrefs.begin( ), xrefs.end( ), []( const xref_t& a, const xref_t& b ) { return a.source == b.source; } ), xrefs.end( ) );
+
+        return xref_table( std::move( xrefs ) );
+    }
+
+    std::span< const xref_t > xref_table::xrefs( ) const noexcept
+    {
+        return _xrefs;
+    }
+
+    void xref_table::retarget( std::size_t index, std::uint32_t target ) noexcept
+    {
+        _xrefs[ index ].target = target;
+    }
+
+    std::span< const xref_t > xref_table::from( std::uint32_t source ) const noexcept
+    {
+        const auto [ first, last ] = std::equal_range(
+            _xrefs.begin( ),
+            _xrefs.end( ),
+            xref_t{ source, 0, 0, 0, xref_kind_t::call, false },
+            []( const xref_t& a, const xref_t& b ) { return a.source < b.source; } );
+
+        return { first, last };
+    }
+}  // namespace vulkan::analysis
\ No newline at end of file
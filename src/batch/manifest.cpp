@@ -0,0 +1,174 @@
+#include "batch/manifest.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <format>
+#include <ranges>
+#include <utility>
+
+namespace vulkan::batch
+{
+    namespace
+    {
+        /// <summary>
+        /// The names of the statuses, as written to the results manifest.
+        /// </summary>
+        constexpr std::string_view STATUS_NAMES[] = { "done", "failed", "cancelled" };
+
+        /// <summary>
+        /// Splits a line into its tab separated fields.
+        /// </summary>
+        std::vector< std::string_view > split( std::string_view line )
+        {
+            std::vector< std::string_view > fields;
+
+            for ( const auto field : line | std::views::split( '\t' ) )
+                fields.emplace_back( field.begin( ), field.end( ) );
+
+            return fields;
+        }
+
+        /// <summary>
+        /// Replaces the characters that would break a line of the results manifest.
+        /// </summary>
+        std::string sanitize( std::string_view text )
+        {
+            std::string result( text );
+            std::ranges::replace_if( result, []( char c ) { return c == '\t' || c == '\r' || c == '\n'; }, ' ' );
+
+            return result;
+        }
+    }  // namespace
+
+    std::string input_t::key( ) const
+    {
+        if ( module_name.empty( ) )
+            return path.string( );
+
+        return std::format( "{}!{}", path.string( ), module_name );
+    }
+
+    std::optional< std::vector< input_t > > read_inputs( const std::filesystem::path& path )
+    {
+        std::error_code error;
+        std::vector< input_t > inputs;
+
+        if ( std::filesystem::is_directory( path, error ) )
+        {
+            for ( const auto& entry : std::filesystem::directory_iterator( path, error ) )
+            {
+                if ( entry.is_regular_file( error ) && entry.path( ).extension( ) == ".dmp" )
+                    inputs.push_back( { entry.path( ), std::nullopt, { } } );
+            }
+
+            if ( error )
+                return std::nullopt;
+
+            std::ranges::sort( inputs, { }, &input_t::path );
+            return inputs;
+        }
+
+        std::ifstream file( path );
+
+        if ( !file )
+            return std::nullopt;
+
+        for ( std::string line; std::getline( file, line ); )
+        {
+            if ( !line.empty( ) && line.back( ) == '\r' )
+                line.pop_back( );
+
+            if ( line.empty( ) || line.front( ) == '#' )
+                continue;
+
+            const auto fields = split( line );
+
+            if ( fields.size( ) > 3 || fields[ 0 ].empty( ) )
+                return std::nullopt;
+
+            input_t input = { path.parent_path( ) / fields[ 0 ], std::nullopt, { } };
+
+            if ( fields.size( ) > 1 && !fields[ 1 ].empty( ) )
+            {
+                auto text = fields[ 1 ];
+
+                if ( text.starts_with( "0x" ) || text.starts_with( "0X" ) )
+                    text.remove_prefix( 2 );
+
+                std::uintptr_t base = 0;
+                const auto [ end, result ] = std::from_chars( text.data( ), text.data( ) + text.size( ), base, 16 );
+
+                if ( result != std::errc( ) || end != text.data( ) + text.size( ) )
+                    return std::nullopt;
+
+                input.base = base;
+            }
+
+            if ( fields.size( ) > 2 )
+                input.module_name = fields[ 2 ];
+
+            inputs.push_back( std::move( input ) );
+        }
+
+        return inputs;
+    }
+
+    result_log::result_log( const std::filesystem::path& path )
+    {
+        std::error_code error;
+        const auto exists = std::filesystem::exists( path, error );
+
+        if ( exists )
+        {
+            std::ifstream file( path );
+
+            // Later lines win, so an input that failed once and was done by a later run counts as done, and the other way around.
+            for ( std::string line; std::getline( file, line ); )
+            {
+                const auto fields = split( line );
+
+                if ( fields.size( ) < 4 )
+                    continue;
+
+                const std::string input( fields[ 0 ] );
+
+                if ( fields[ 1 ] == STATUS_NAMES[ std::to_underlying( status_t::done ) ] &&
+                     std::filesystem::is_regular_file( fields[ 3 ], error ) )
+                    _done.insert( input );
+                else
+                    _done.erase( input );
+            }
+        }
+
+        _file.open( path, std::ios::app );
+
+        if ( !exists )
+            _file << "input\tstatus\tseconds\toutput\tmessage\n" << std::flush;
+    }
+
+    bool result_log::is_valid( ) const noexcept
+    {
+        return _file.is_open( ) && _file.good( );
+    }
+
+    bool result_log::is_done( std::string_view input ) const
+    {
+        return _done.contains( std::string( input ) );
+    }
+
+    void result_log::append( const result_t& result )
+    {
+        const auto line = std::format(
+            "{}\t{}\t{:.3f}\t{}\t{}\n",
+            sanitize( result.input ),
+            STATUS_NAMES[ std::to_underlying( result.status ) ],
+            result.seconds,
+            sanitize( result.output ),
+            sanitize( result.message ) );
+
+        std::lock_guard lock( _mutex );
+
+        // Flushed right away, so that the manifest is complete up to the last finished job if the batch is killed.
+        _file << line << std::flush;
+    }
+}  // namespace vulkan::batch
\ No newline at end of file
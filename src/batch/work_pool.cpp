@@ -0,0 +1,140 @@
+#include "batch/work_pool.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace vulkan::batch
+{
+    work_pool::work_pool( std::size_t workers, std::size_t memory_budget ) noexcept
+        : _workers( workers ? workers : std::max( 1u, std::thread::hardware_concurrency( ) ) ),
+          _memory_budget( memory_budget )
+    {
+    }
+
+    std::size_t work_pool::workers( ) const noexcept
+    {
+        return _workers;
+    }
+
+    bool work_pool::admit( std::size_t cost, std::stop_token stop_token )
+    {
+        std::unique_lock lock( _mutex );
+
+        const auto fits = [ & ]( ) { return !_memory_budget || !_running || _memory_used + cost <= _memory_budget; };
+
+        if ( !_released.wait( lock, stop_token, fits ) )
+            return false;
+
+        _memory_used += cost;
+        ++_running;
+        return true;
+    }
+
+    void work_pool::release( std::size_t cost )
+    {
+        {
+            std::lock_guard lock( _mutex );
+
+            _memory_used -= cost;
+            --_running;
+        }
+
+        _released.notify_all( );
+    }
+
+    void work_pool::run( std::span< task_t > tasks, std::stop_token stop_token )
+    {
+        /// The tasks of a worker, as indices into `tasks`.
+        struct queue_t
+        {
+            std::mutex mutex;
+            std::deque< std::size_t > tasks;
+        };
+
+        const auto workers = std::min( _workers, std::max< std::size_t >( tasks.size( ), 1 ) );
+
+        std::vector< std::unique_ptr< queue_t > > queues;
+        queues.reserve( workers );
+
+        for ( std::size_t i = 0; i < workers; ++i )
+            queues.push_back( std::make_unique< queue_t >( ) );
+
+        // Tasks are dealt out smallest first, so that every worker finds its largest task at the back of its queue.
+        std::vector< std::size_t > order( tasks.size( ) );
+        std::iota( order.begin( ), order.end( ), 0 );
+        std::stable_sort( order.begin( ), order.end( ), [ & ]( std::size_t a, std::size_t b ) { return tasks[ a ].cost < tasks[ b ].cost; } );
+
+        for ( std::size_t i = 0; i < order.size( ); ++i )
+            queues[ i % workers ]->tasks.push_back( order[ i ] );
+
+        // Takes from the back of the own queue, and steals from the front of the others, where the small tasks are.
+        const auto next = [ & ]( std::size_t self ) -> std::optional< std::size_t >
+        {
+            for ( std::size_t i = 0; i < workers; ++i )
+            {
+                auto& queue = *queues[ ( self + i ) % workers ];
+
+                std::lock_guard lock( queue.mutex );
+
+                if ( queue.tasks.empty( ) )
+                    continue;
+
+                std::size_t task;
+
+                if ( i == 0 )
+                {
+                    task = queue.tasks.back( );
+                    queue.tasks.pop_back( );
+                }
+                else
+                {
+                    task = queue.tasks.front( );
+                    queue.tasks.pop_front( );
+                }
+
+                return task;
+            }
+
+            // Tasks are never added while the batch runs, so empty queues mean the batch is done.
+            return std::nullopt;
+        };
+
+        const auto work = [ & ]( std::size_t self )
+        {
+            while ( !stop_token.stop_requested( ) )
+            {
+                const auto index = next( self );
+
+                if ( !index )
+                    break;
+
+                auto& task = tasks[ *index ];
+
+                if ( !admit( task.cost, stop_token ) )
+                    break;
+
+                // Tasks report their own failures, and one that throws must not take the rest of the batch down.
+                try
+                {
+                    task.run( stop_token );
+                }
+                catch ( ... )
+                {
+                }
+
+                release( task.cost );
+            }
+        };
+
+        std::vector< std::jthread > threads;
+        threads.reserve( workers );
+
+        for ( std::size_t i = 0; i < workers; ++i )
+            threads.emplace_back( work, i );
+    }
+}  // namespace vulkan::batch
\ No newline at end of file
@@ -0,0 +1,276 @@
+#include "carve/carver.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+
+#include "parallel.hpp"
+#include "pe/util.hpp"
+
+#if defined( _M_X64 ) || defined( __x86_64__ )
+#include <emmintrin.h>
+#endif
+
+namespace vulkan::carve
+{
+    namespace
+    {
+        /// <summary>
+        /// The loader refuses images with more sections than this.
+        /// </summary>
+        static constexpr std::uint16_t MAX_SECTIONS = 96;
+
+        /// <summary>
+        /// At least this many pages are scanned by every worker, so that small captures are not split needlessly.
+        /// </summary>
+        static constexpr std::size_t PAGE_GRAIN = 4096;
+
+        /// <summary>
+        /// Returns the offset of the first page boundary in an extent.
+        /// </summary>
+        constexpr std::size_t first_page_offset( const sources::extent_t& extent ) noexcept
+        {
+            return ( pe::PAGE_SIZE - extent.address % pe::PAGE_SIZE ) % pe::PAGE_SIZE;
+        }
+
+        /// <summary>
+        /// Returns the number of page boundaries in an extent.
+        /// </summary>
+        constexpr std::size_t page_count( const sources::extent_t& extent ) noexcept
+        {
+            const auto skip = first_page_offset( extent );
+
+            return extent.bytes.size( ) > skip ? ( extent.bytes.size( ) - skip + pe::PAGE_SIZE - 1 ) / pe::PAGE_SIZE : 0;
+        }
+
+        /// <summary>
+        /// Validates the headers at a page of an extent and collects the image if they are plausible.
+        /// </summary>
+        void inspect( const sources::extent_t& extent, std::size_t offset, std::vector< image_t >& images )
+        {
+            const auto size = std::min< std::size_t >( pe::PAGE_SIZE, extent.bytes.size( ) - offset );
+
+            if ( auto image = parse_headers( extent.bytes.subspan( offset, size ) ) )
+            {
+                image->address = extent.address + offset;
+                images.push_back( *image );
+            }
+        }
+
+        /// <summary>
+        /// Scans a run of pages of an extent for images.
+        /// </summary>
+        void scan( const sources::extent_t& extent, std::size_t begin, std::size_t end, std::stop_token stop_token, std::vector< image_t >& images )
+        {
+            const auto data = extent.bytes.data( );
+            const auto size = extent.bytes.size( );
+            const auto skip = first_page_offset( extent );
+
+            // Only the last page of an extent can be shorter than the signature.
+            if ( end > begin && skip + ( end - 1 ) * pe::PAGE_SIZE + sizeof( std::uint16_t ) > size )
+                --end;
+
+            const auto word = [ & ]( std::size_t page )
+            {
+                std::uint16_t value;
+                std::memcpy( &value, data + skip + page * pe::PAGE_SIZE, sizeof( value ) );
+                return value;
+            };
+
+            auto page = begin;
+
+#if defined( _M_X64 ) || defined( __x86_64__ )
+            const auto needle = _mm_set1_epi16( static_cast< short >( pe::DOS_SIGNATURE ) );
+
+            for ( ; page + 8 <= end; page += 8 )
+            {
+                if ( page % 1024 == 0 && stop_token.stop_requested( ) )
+                    return;
+
+                const auto words = _mm_setr_epi16(
+                    static_cast< short >( word( page ) ),
+                    static_cast< short >( word( page + 1 ) ),
+                    static_cast< short >( word( page + 2 ) ),
+                    static_cast< short >( word( page + 3 ) ),
+                    static_cast< short >( word( page + 4 ) ),
+                    static_cast< short >( word( page + 5 ) ),
+                    static_cast< short >( word( page + 6 ) ),
+                    static_cast< short >( word( page + 7 ) ) );
+
+                auto mask = static_cast< std::uint32_t >( _mm_movemask_epi8( _mm_cmpeq_epi16( words, needle ) ) );
+
+                // Every matching word sets two bits of the mask.
+                while ( mask )
+                {
+                    const auto lane = static_cast< std::size_t >( std::countr_zero( mask ) ) / 2;
+
+                    inspect( extent, skip + ( page + lane ) * pe::PAGE_SIZE, images );
+
+                    mask &= ~( 3u << ( lane * 2 ) );
+                }
+            }
+#endif
+
+            for ( ; page < end; ++page )
+            {
+                if ( word( page ) == pe::DOS_SIGNATURE )
+                    inspect( extent, skip + page * pe::PAGE_SIZE, images );
+            }
+        }
+
+        /// <summary>
+        /// Returns the number of bytes that were captured contiguously from an address.
+        /// </summary>
+        std::uint64_t mapped_size( std::span< const sources::extent_t > extents, std::uintptr_t address ) noexcept
+        {
+            auto it = std::upper_bound(
+                extents.begin( ),
+                extents.end( ),
+                address,
+                []( std::uintptr_t value, const sources::extent_t& extent ) { return value < extent.address; } );
+
+            if ( it == extents.begin( ) || address - ( --it )->address >= it->bytes.size( ) )
+                return 0;
+
+            std::uint64_t size = it->address + it->bytes.size( ) - address;
+
+            // Regions with different protections are captured separately, so keep going as long as they are adjacent.
+            for ( auto next = it + 1; next != extents.end( ) && next->address == address + size; ++next )
+                size += next->bytes.size( );
+
+            return size;
+        }
+    }  // namespace
+
+    std::optional< image_t > parse_headers( std::span< const std::uint8_t > headers ) noexcept
+    {
+        if ( headers.size( ) < sizeof( pe::dos_header_t ) )
+            return std::nullopt;
+
+        const auto dos_header = reinterpret_cast< const pe::dos_header_t* >( headers.data( ) );
+
+        if ( dos_header->e_magic != pe::DOS_SIGNATURE || dos_header->e_lfanew < static_cast< std::int32_t >( sizeof( pe::dos_header_t ) ) ||
+             dos_header->e_lfanew % sizeof( std::uint32_t ) ||
+             static_cast< std::size_t >( dos_header->e_lfanew ) + sizeof( pe::nt_headers32_t ) > headers.size( ) )
+            return std::nullopt;
+
+        const auto nt_headers = reinterpret_cast< const pe::nt_headers_t* >( headers.data( ) + dos_header->e_lfanew );
+        const auto arch = pe::arch_of( nt_headers->OptionalHeader.Magic );
+
+        if ( nt_headers->Signature != pe::NT_SIGNATURE || arch == pe::arch_t::unknown )
+            return std::nullopt;
+
+        return pe::dispatch(
+            arch,
+            [ & ]< typename Arch >( Arch ) -> std::optional< image_t >
+            {
+                using nt_headers_t = typename Arch::nt_headers_t;
+
+                if ( static_cast< std::size_t >( dos_header->e_lfanew ) + sizeof( nt_headers_t ) > headers.size( ) )
+                    return std::nullopt;
+
+                const auto& file_header = reinterpret_cast< const nt_headers_t* >( nt_headers )->FileHeader;
+                const auto& optional_header = reinterpret_cast< const nt_headers_t* >( nt_headers )->OptionalHeader;
+
+                const auto section_alignment = optional_header.SectionAlignment;
+                const auto file_alignment = optional_header.FileAlignment;
+
+                if ( !( file_header.Characteristics & pe::FILE_EXECUTABLE_IMAGE ) || !file_header.NumberOfSections ||
+                     file_header.NumberOfSections > MAX_SECTIONS ||
+                     file_header.SizeOfOptionalHeader < offsetof( typename Arch::optional_header_t, DataDirectory ) ||
+                     !std::has_single_bit( section_alignment ) || !std::has_single_bit( file_alignment ) || file_alignment > section_alignment )
+                    return std::nullopt;
+
+                const auto sections_offset =
+                    static_cast< std::size_t >( dos_header->e_lfanew ) + offsetof( nt_headers_t, OptionalHeader ) + file_header.SizeOfOptionalHeader;
+
+                if ( sections_offset + file_header.NumberOfSections * sizeof( pe::section_header_t ) > headers.size( ) )
+                    return std::nullopt;
+
+                const auto sections = reinterpret_cast< const pe::section_header_t* >( headers.data( ) + sections_offset );
+
+                // The loader requires the sections to follow each other in ascending order.
+                std::uint64_t end = optional_header.SizeOfHeaders;
+
+                for ( std::uint16_t i = 0; i < file_header.NumberOfSections; ++i )
+                {
+                    const auto& section = sections[ i ];
+                    const auto virtual_size = section.Misc.VirtualSize ? section.Misc.VirtualSize : section.SizeOfRawData;
+
+                    if ( section.VirtualAddress < end || section.VirtualAddress % section_alignment )
+                        return std::nullopt;
+
+                    end = section.VirtualAddress + pe::align< std::uint64_t >( virtual_size, section_alignment );
+                }
+
+                if ( end > std::numeric_limits< std::uint32_t >::max( ) )
+                    return std::nullopt;
+
+                return image_t{ 0,
+                                arch,
+                                file_header.Machine,
+                                file_header.Characteristics,
+                                file_header.TimeDateStamp,
+                                optional_header.SizeOfImage,
+                                static_cast< std::uint32_t >( end ),
+                                0 };
+            } );
+    }
+
+    std::vector< image_t > carve( std::span< const sources::extent_t > extents, std::stop_token stop_token )
+    {
+        // Number the page boundaries of all extents, so that the work can be split evenly no matter how the capture is fragmented.
+        std::vector< std::size_t > first_page( extents.size( ) + 1, 0 );
+
+        for ( std::size_t i = 0; i < extents.size( ); ++i )
+            first_page[ i + 1 ] = first_page[ i ] + page_count( extents[ i ] );
+
+        const auto chunks = split( first_page.back( ), PAGE_GRAIN );
+
+        std::vector< std::vector< image_t > > found( chunks.size( ) );
+
+        parallel_for(
+            chunks,
+            [ & ]( std::size_t index, std::size_t begin, std::size_t end )
+            {
+                auto extent = static_cast< std::size_t >( std::upper_bound( first_page.begin( ), first_page.end( ), begin ) - first_page.begin( ) );
+
+                --extent;
+
+                for ( auto page = begin; page < end && !stop_token.stop_requested( ); ++extent )
+                {
+                    const auto last = std::min( end, first_page[ extent + 1 ] );
+
+                    scan( extents[ extent ], page - first_page[ extent ], last - first_page[ extent ], stop_token, found[ index ] );
+
+                    page = last;
+                }
+            } );
+
+        std::vector< image_t > images;
+
+        for ( auto& chunk : found )
+            images.insert( images.end( ), chunk.begin( ), chunk.end( ) );
+
+        std::sort( images.begin( ), images.end( ), []( const image_t& a, const image_t& b ) { return a.address < b.address; } );
+
+        std::vector< image_t > result;
+        std::uintptr_t covered = 0;
+
+        for ( auto& image : images )
+        {
+            if ( image.address < covered )
+                continue;
+
+            image.mapped_size = mapped_size( extents, image.address );
+            image.size = static_cast< std::uint32_t >( std::min< std::uint64_t >( image.size, image.mapped_size ) );
+
+            covered = image.address + image.size;
+            result.push_back( image );
+        }
+
+        return result;
+    }
+}  // namespace vulkan::carve
\ No newline at end of file
@@ -0,0 +1,549 @@
+#include "diff/image_diff.hpp"
+
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+#include <format>
+#include <optional>
+#include <unordered_map>
+
+#include "analysis/xref_table.hpp"
+#include "parallel.hpp"
+#include "pe/util.hpp"
+
+#if defined( _M_X64 ) || defined( __x86_64__ )
+#include <emmintrin.h>
+#endif
+
+namespace vulkan::diff
+{
+    namespace
+    {
+        /// <summary>
+        /// The size of the blocks matched by the rolling hash.
+        /// </summary>
+        static constexpr std::uint32_t BLOCK_SIZE = 64;
+
+        /// <summary>
+        /// The maximum number of blocks with the same hash that are compared with a window.
+        /// </summary>
+        static constexpr std::size_t MAX_CANDIDATES = 8;
+
+        /// <summary>
+        /// Compares two buffers, 64 bytes at a time with SSE2.
+        /// </summary>
+        bool equal( const std::uint8_t* a, const std::uint8_t* b, std::size_t size ) noexcept
+        {
+            std::size_t i = 0;
+
+#if defined( _M_X64 ) || defined( __x86_64__ )
+            const auto load = []( const std::uint8_t* data ) { return _mm_loadu_si128( reinterpret_cast< const __m128i* >( data ) ); };
+
+            for ( ; i + 64 <= size; i += 64 )
+            {
+                const auto x = _mm_and_si128( _mm_cmpeq_epi8( load( a + i ), load( b + i ) ), _mm_cmpeq_epi8( load( a + i + 16 ), load( b + i + 16 ) ) );
+                const auto y =
+                    _mm_and_si128( _mm_cmpeq_epi8( load( a + i + 32 ), load( b + i + 32 ) ), _mm_cmpeq_epi8( load( a + i + 48 ), load( b + i + 48 ) ) );
+
+                if ( _mm_movemask_epi8( _mm_and_si128( x, y ) ) != 0xFFFF )
+                    return false;
+            }
+#endif
+
+            return !std::memcmp( a + i, b + i, size - i );
+        }
+
+        /// <summary>
+        /// The weak rolling checksum of rsync. It can be moved forward by one byte in constant time. Both sums fit the value without
+        /// truncation, since a block is only 64 bytes.
+        /// </summary>
+        class rolling_hash_t final
+        {
+            std::uint32_t _a = 0, _b = 0;
+
+           public:
+            explicit rolling_hash_t( const std::uint8_t* data ) noexcept
+            {
+                for ( std::uint32_t i = 0; i < BLOCK_SIZE; ++i )
+                {
+                    _a += data[ i ];
+                    _b += ( BLOCK_SIZE - i ) * data[ i ];
+                }
+            }
+
+            /// <summary>
+            /// Moves the window forward by one byte.
+            /// </summary>
+            void roll( std::uint8_t out, std::uint8_t in ) noexcept
+            {
+                _a += in - out;
+                _b += _a - BLOCK_SIZE * out;
+            }
+
+            std::uint64_t value( ) const noexcept
+            {
+                return ( static_cast< std::uint64_t >( _b ) << 32 ) | _a;
+            }
+        };
+
+        /// <summary>
+        /// Returns the bytes of a section that are backed by the file.
+        /// </summary>
+        std::span< const std::uint8_t > contents( const pe::image_view& image, const pe::section_header_t& section ) noexcept
+        {
+            return image.bytes( section.VirtualAddress, std::min( section.Misc.VirtualSize, section.SizeOfRawData ) );
+        }
+
+        /// <summary>
+        /// Returns the name of a section.
+        /// </summary>
+        std::string name_of( const pe::section_header_t& section )
+        {
+            const auto name = reinterpret_cast< const char* >( section.Name );
+
+            return { name, std::find( name, name + pe::SIZEOF_SHORT_NAME, '\0' ) };
+        }
+
+        /// <summary>
+        /// Returns a copy of an image in which every field that depends on the image base or on import resolution is zeroed: relocated
+        /// fields, the import address table, and the displacements of instructions that reference the import address table.
+        /// </summary>
+        pe::image_view normalize( const pe::image_view& image )
+        {
+            pe::image_editor editor( image );
+
+            const auto mask = [ & ]( std::uint32_t rva, std::size_t size )
+            {
+                const auto bytes = editor.bytes( rva, size );
+                std::fill( bytes.begin( ), bytes.end( ), 0 );
+            };
+
+            const auto relocations = image.directory( pe::DIRECTORY_ENTRY_BASERELOC );
+
+            for ( std::size_t offset = 0; offset + sizeof( pe::base_relocation_t ) <= relocations.size( ); )
+            {
+                const auto block = reinterpret_cast< const pe::base_relocation_t* >( relocations.data( ) + offset );
+
+                if ( block->SizeOfBlock < sizeof( pe::base_relocation_t ) || offset + block->SizeOfBlock > relocations.size( ) )
+                    break;
+
+                const auto entries = reinterpret_cast< const std::uint16_t* >( block + 1 );
+                const auto count = ( block->SizeOfBlock - sizeof( pe::base_relocation_t ) ) / sizeof( std::uint16_t );
+
+                for ( std::size_t i = 0; i < count; ++i )
+                {
+                    const auto rva = block->VirtualAddress + ( entries[ i ] & 0xFFF );
+
+                    switch ( entries[ i ] >> 12 )
+                    {
+                        case pe::REL_BASED_HIGHLOW: mask( rva, sizeof( std::uint32_t ) ); break;
+                        case pe::REL_BASED_DIR64: mask( rva, sizeof( std::uint64_t ) ); break;
+                        default: break;
+                    }
+                }
+
+                offset += block->SizeOfBlock;
+            }
+
+            // The import address table holds the resolved addresses of the imports, which differ between every run.
+            std::vector< range_t > iat;
+
+            if ( const auto directory = image.data_directory( pe::DIRECTORY_ENTRY_IAT ); directory.VirtualAddress && directory.Size )
+                iat.push_back( { directory.VirtualAddress, directory.Size } );
+
+            const auto imports = image.directory( pe::DIRECTORY_ENTRY_IMPORT );
+
+            for ( std::size_t offset = 0; offset + sizeof( pe::import_descriptor_t ) <= imports.size( ); offset += sizeof( pe::import_descriptor_t ) )
+            {
+                const auto descriptor = reinterpret_cast< const pe::import_descriptor_t* >( imports.data( ) + offset );
+
+                if ( !descriptor->FirstThunk )
+                    break;
+
+                // Thunks are as wide as a pointer of the image.
+                const auto size = pe::dispatch(
+                    image.arch( ),
+                    [ & ]< typename Arch >( Arch )
+                    {
+                        using pointer_t = typename Arch::pointer_t;
+
+                        std::uint32_t size = 0;
+
+                        while ( const auto thunk = image.read< pointer_t >( descriptor->FirstThunk + size ) )
+                        {
+                            if ( !*thunk )
+                                break;
+
+                            size += sizeof( pointer_t );
+                        }
+
+                        return size;
+                    } );
+
+                iat.push_back( { descriptor->FirstThunk, size } );
+            }
+
+            for ( const auto& range : iat )
+                mask( range.rva, range.size );
+
+            const auto in_iat = [ & ]( std::uint32_t rva )
+            { return std::any_of( iat.begin( ), iat.end( ), [ rva ]( const range_t& range ) { return rva - range.rva < range.size; } ); };
+
+            if ( !iat.empty( ) )
+            {
+                for ( const auto& xref : analysis::xref_table::build( image ).xrefs( ) )
+                {
+                    if ( xref.indirect && in_iat( xref.target ) )
+                        mask( xref.source + xref.operand, sizeof( std::uint32_t ) );
+                }
+            }
+
+            return std::move( editor ).publish( );
+        }
+
+        /// <summary>
+        /// A page of a section that exists in both images.
+        /// </summary>
+        struct page_t
+        {
+            std::size_t section;
+            std::uint32_t offset;
+        };
+
+        /// <summary>
+        /// A section that exists in both images, and the index of the blocks of its old contents.
+        /// </summary>
+        struct pair_t
+        {
+            std::size_t report;
+            std::uint32_t rva;
+            std::span< const std::uint8_t > old_data;
+            std::span< const std::uint8_t > new_data;
+            std::unordered_multimap< std::uint64_t, std::uint32_t > blocks;
+        };
+
+        /// <summary>
+        /// Indexes the aligned blocks of a buffer by their rolling hash.
+        /// </summary>
+        std::unordered_multimap< std::uint64_t, std::uint32_t > index_blocks( std::span< const std::uint8_t > data )
+        {
+            std::unordered_multimap< std::uint64_t, std::uint32_t > blocks;
+            blocks.reserve( data.size( ) / BLOCK_SIZE );
+
+            for ( std::uint32_t offset = 0; offset + BLOCK_SIZE <= data.size( ); offset += BLOCK_SIZE )
+                blocks.emplace( rolling_hash_t( data.data( ) + offset ).value( ), offset );
+
+            return blocks;
+        }
+
+        /// <summary>
+        /// Finds the bytes of a page of the new section that exist somewhere in the old section. A window is rolled over the page and
+        /// looked up among the blocks of the old section, so shifted contents are found at any alignment. A match is extended for as long as
+        /// the contents agree at the same shift, and rolling resumes just before the first difference. Windows may start before the page,
+        /// so that blocks that straddle its start are found as well.
+        /// </summary>
+        std::bitset< pe::PAGE_SIZE > match_page( const pair_t& pair, std::uint32_t offset, std::uint32_t size ) noexcept
+        {
+            std::bitset< pe::PAGE_SIZE > covered;
+
+            const auto data = pair.new_data.data( );
+            const auto end = static_cast< std::uint32_t >( pair.new_data.size( ) );
+            const auto first = offset >= BLOCK_SIZE ? offset - BLOCK_SIZE + 1 : 0;
+
+            // Returns the offset of a block of the old section with the same contents as the window, if there is one.
+            const auto find = [ & ]( std::uint64_t hash, std::uint32_t i ) -> std::optional< std::uint32_t >
+            {
+                auto [ it, last ] = pair.blocks.equal_range( hash );
+
+                for ( std::size_t n = 0; it != last && n < MAX_CANDIDATES; ++it, ++n )
+                {
+                    if ( equal( pair.old_data.data( ) + it->second, data + i, BLOCK_SIZE ) )
+                        return it->second;
+                }
+
+                return std::nullopt;
+            };
+
+            if ( first + BLOCK_SIZE > end )
+                return covered;
+
+            rolling_hash_t hash( data + first );
+
+            for ( auto i = first;; )
+            {
+                if ( const auto match = find( hash.value( ), i ) )
+                {
+                    auto k = i + BLOCK_SIZE;
+
+                    for ( auto o = *match + BLOCK_SIZE; k < offset + size && o < pair.old_data.size( ) && data[ k ] == pair.old_data[ o ]; ++o )
+                        ++k;
+
+                    for ( auto j = std::max( i, offset ); j < std::min( k, offset + size ); ++j )
+                        covered.set( j - offset );
+
+                    // Windows that overlap the difference may still match at another shift.
+                    const auto next = std::max( i + 1, k - BLOCK_SIZE + 1 );
+
+                    if ( k >= offset + size || next + BLOCK_SIZE > end )
+                        break;
+
+                    hash = rolling_hash_t( data + next );
+                    i = next;
+                    continue;
+                }
+
+                if ( i + 1 >= offset + size || i + 1 + BLOCK_SIZE > end )
+                    break;
+
+                hash.roll( data[ i ], data[ i + BLOCK_SIZE ] );
+                ++i;
+            }
+
+            // Bytes that did not move are unchanged too. This also covers the ends of the page that no window reached.
+            for ( std::uint32_t j = 0; j < size; ++j )
+            {
+                if ( offset + j < pair.old_data.size( ) && pair.old_data[ offset + j ] == data[ offset + j ] )
+                    covered.set( j );
+            }
+
+            return covered;
+        }
+
+        /// <summary>
+        /// The results of a worker.
+        /// </summary>
+        struct partial_t
+        {
+            std::vector< range_t > ranges;
+            std::vector< page_t > changed;
+        };
+    }  // namespace
+
+    report_t compare( const pe::image_view& old_image, const pe::image_view& new_image )
+    {
+        const auto old_normalized = normalize( old_image );
+        const auto new_normalized = normalize( new_image );
+
+        report_t report;
+        std::vector< pair_t > pairs;
+
+        for ( const auto& section : new_normalized.sections( ) )
+        {
+            const auto name = name_of( section );
+            const auto old_section = old_normalized.find_section( name );
+
+            section_diff_t entry = { name, old_section ? old_section->Misc.VirtualSize : 0, section.Misc.VirtualSize };
+            entry.pages = pe::align( section.Misc.VirtualSize, pe::PAGE_SIZE ) / pe::PAGE_SIZE;
+
+            if ( old_section )
+                pairs.push_back(
+                    { report.sections.size( ), section.VirtualAddress, contents( old_normalized, *old_section ), contents( new_normalized, section ), { } } );
+            else
+            {
+                // Everything in an added section is new.
+                entry.changed_pages = entry.pages;
+                entry.changed_bytes = section.Misc.VirtualSize;
+                report.ranges.push_back( { section.VirtualAddress, section.Misc.VirtualSize } );
+            }
+
+            report.sections.push_back( std::move( entry ) );
+        }
+
+        for ( const auto& section : old_normalized.sections( ) )
+        {
+            const auto name = name_of( section );
+
+            if ( !new_normalized.find_section( name ) )
+                report.sections.push_back( { name, section.Misc.VirtualSize, 0 } );
+        }
+
+        std::vector< page_t > pages;
+
+        for ( std::size_t i = 0; i < pairs.size( ); ++i )
+        {
+            for ( std::uint32_t offset = 0; offset < pairs[ i ].new_data.size( ); offset += pe::PAGE_SIZE )
+                pages.push_back( { i, offset } );
+        }
+
+        const auto page_size = [ & ]( const page_t& page )
+        { return std::min< std::uint32_t >( pe::PAGE_SIZE, static_cast< std::uint32_t >( pairs[ page.section ].new_data.size( ) ) - page.offset ); };
+
+        // First compare every page with the page at the same offset. Most pages of two dumps of similar builds are identical.
+        auto chunks = split( pages.size( ), 64 );
+        std::vector< partial_t > partials( chunks.size( ) );
+
+        parallel_for(
+            chunks,
+            [ & ]( std::size_t chunk, std::size_t begin, std::size_t end )
+            {
+                for ( auto i = begin; i < end; ++i )
+                {
+                    const auto& pair = pairs[ pages[ i ].section ];
+                    const auto offset = pages[ i ].offset;
+                    const auto size = page_size( pages[ i ] );
+
+                    if ( offset + size > pair.old_data.size( ) || !equal( pair.old_data.data( ) + offset, pair.new_data.data( ) + offset, size ) )
+                        partials[ chunk ].changed.push_back( pages[ i ] );
+                }
+            } );
+
+        std::vector< page_t > changed;
+
+        for ( auto& partial : partials )
+            changed.insert( changed.end( ), partial.changed.begin( ), partial.changed.end( ) );
+
+        for ( const auto& page : pages )
+            ++report.sections[ pairs[ page.section ].report ].identical_pages;
+
+        for ( const auto& page : changed )
+            --report.sections[ pairs[ page.section ].report ].identical_pages;
+
+        // Then match the pages that differ against the whole old section. Only sections with differences are indexed.
+        std::vector< bool > indexed( pairs.size( ) );
+
+        for ( const auto& page : changed )
+        {
+            if ( !indexed[ page.section ] )
+            {
+                pairs[ page.section ].blocks = index_blocks( pairs[ page.section ].old_data );
+                indexed[ page.section ] = true;
+            }
+        }
+
+        chunks = split( changed.size( ) );
+        partials.assign( chunks.size( ), { } );
+
+        // Whether every byte of a changed page was found elsewhere, indexed like `changed`.
+        std::vector< std::uint8_t > moved( changed.size( ) );
+
+        parallel_for(
+            chunks,
+            [ & ]( std::size_t chunk, std::size_t begin, std::size_t end )
+            {
+                for ( auto i = begin; i < end; ++i )
+                {
+                    const auto& pair = pairs[ changed[ i ].section ];
+                    const auto offset = changed[ i ].offset;
+                    const auto size = page_size( changed[ i ] );
+                    const auto covered = match_page( pair, offset, size );
+
+                    if ( covered.count( ) == size )
+                    {
+                        moved[ i ] = true;
+                        continue;
+                    }
+
+                    // Turn the bytes that were not found into ranges.
+                    for ( std::uint32_t j = 0; j < size; )
+                    {
+                        if ( covered.test( j ) )
+                        {
+                            ++j;
+                            continue;
+                        }
+
+                        const auto start = j;
+
+                        while ( j < size && !covered.test( j ) )
+                            ++j;
+
+                        partials[ chunk ].ranges.push_back( { pair.rva + offset + start, j - start } );
+                    }
+                }
+            } );
+
+        for ( std::size_t i = 0; i < changed.size( ); ++i )
+        {
+            auto& entry = report.sections[ pairs[ changed[ i ].section ].report ];
+
+            if ( moved[ i ] )
+                ++entry.moved_pages;
+            else
+                ++entry.changed_pages;
+        }
+
+        for ( const auto& partial : partials )
+            report.ranges.insert( report.ranges.end( ), partial.ranges.begin( ), partial.ranges.end( ) );
+
+        std::sort( report.ranges.begin( ), report.ranges.end( ), []( const range_t& a, const range_t& b ) { return a.rva < b.rva; } );
+
+        // Merge ranges that were split by page boundaries.
+        std::vector< range_t > ranges;
+
+        for ( const auto& range : report.ranges )
+        {
+            if ( !ranges.empty( ) && ranges.back( ).rva + ranges.back( ).size == range.rva )
+                ranges.back( ).size += range.size;
+            else
+                ranges.push_back( range );
+
+            if ( const auto section = new_normalized.section_of( range.rva ) )
+            {
+                const auto name = name_of( *section );
+                const auto entry = std::find_if( report.sections.begin( ), report.sections.end( ), [ & ]( const auto& s ) { return s.name == name; } );
+
+                // Added sections were already counted in full.
+                if ( entry != report.sections.end( ) && entry->old_size )
+                    entry->changed_bytes += range.size;
+            }
+        }
+
+        report.ranges = std::move( ranges );
+
+        // Map the ranges to the functions they overlap. Both are sorted, so a single pass suffices.
+        const auto functions = new_normalized.runtime_functions( );
+        std::size_t first = 0;
+
+        for ( const auto& range : report.ranges )
+        {
+            while ( first < functions.size( ) && functions[ first ].EndAddress <= range.rva )
+                ++first;
+
+            for ( auto i = first; i < functions.size( ) && functions[ i ].BeginAddress < range.rva + range.size; ++i )
+            {
+                const auto overlap = std::min( functions[ i ].EndAddress, range.rva + range.size ) - std::max( functions[ i ].BeginAddress, range.rva );
+
+                if ( !report.functions.empty( ) && report.functions.back( ).begin == functions[ i ].BeginAddress )
+                    report.functions.back( ).changed_bytes += overlap;
+                else
+                    report.functions.push_back( { functions[ i ].BeginAddress, functions[ i ].EndAddress, overlap } );
+            }
+        }
+
+        return report;
+    }
+
+    void write_report( std::ostream& stream, const report_t& report )
+    {
+        stream << "sections:\n";
+
+        for ( const auto& section : report.sections )
+        {
+            if ( !section.old_size )
+                stream << std::format( "  {:<8} added ({} bytes)\n", section.name, section.new_size );
+            else if ( !section.new_size )
+                stream << std::format( "  {:<8} removed ({} bytes)\n", section.name, section.old_size );
+            else
+                stream << std::format(
+                    "  {:<8} {} -> {} bytes, {} pages: {} identical, {} moved, {} changed ({} bytes)\n",
+                    section.name,
+                    section.old_size,
+                    section.new_size,
+                    section.pages,
+                    section.identical_pages,
+                    section.moved_pages,
+                    section.changed_pages,
+                    section.changed_bytes );
+        }
+
+        stream << std::format( "ranges: {}\n", report.ranges.size( ) );
+
+        for ( const auto& range : report.ranges )
+            stream << std::format( "  0x{:08X} +{}\n", range.rva, range.size );
+
+        stream << std::format( "functions: {}\n", report.functions.size( ) );
+
+        for ( const auto& function : report.functions )
+            stream << std::format( "  0x{:08X}-0x{:08X} {} bytes changed\n", function.begin, function.end, function.changed_bytes );
+    }
+}  // namespace vulkan::diff
\ No newline at end of file
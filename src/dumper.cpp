@@ -3,124 +3,580 @@
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstring>
+#include <format>
+#include <memory_resource>
+#include <mutex>
 #include <print>
+#include <type_traits>
 #include <unordered_map>
-#include <wincpp/patterns/scanner.hpp>
+#include <unordered_set>
+
+#include "acquisition/arrival_model.hpp"
+#include "acquisition/page_weights.hpp"
+#include "acquisition/termination.hpp"
+#include "analysis/page_classifier.hpp"
+#include "analysis/pointer_scan.hpp"
+#include "analysis/xref_database.hpp"
+#include "analysis/xref_table.hpp"
+#include "pe/util.hpp"
+#include "sources/export_resolver.hpp"
+#include "sources/region_map.hpp"
+#include "store/fingerprint.hpp"
+#include "watch/delta.hpp"
 
-// clang-format off
+namespace vulkan
+{
+    namespace
+    {
+        /// <summary>
+        /// Guards the registry of passes, since passes can be registered while other threads start dumps.
+        /// </summary>
+        std::mutex registry_mutex;
+
+        /// <summary>
+        /// The number of times in a row a page that looks encrypted must be read with the same contents before it is kept as read. Some
+        /// pages are random by nature (compressed or encrypted data in a code section), and would be polled forever otherwise.
+        /// </summary>
+        constexpr std::uint32_t STABLE_READS = 3;
+
+        /// <summary>
+        /// The number of times a page that looks encrypted is read before it is kept as read, even if its contents keep changing.
+        /// </summary>
+        constexpr std::uint32_t MAX_ENCRYPTED_READS = 16;
+
+        /// <summary>
+        /// A readable code page that looked encrypted when it was read.
+        /// </summary>
+        struct suspect_page_t
+        {
+            std::uint64_t hash;
+            std::uint32_t repeats;
+            std::uint32_t reads;
+        };
 
-#include <DbgHelp.h>
-#pragma comment( lib, "Dbghelp.lib" )
+        /// <summary>
+        /// Hashes the options that change the output of a dump, so that dumps taken with different options are stored apart.
+        /// </summary>
+        std::uint64_t options_hash( dumper::options options )
+        {
+            auto text = std::format( "{}|{}|{:X}|", options.resolve_imports( ), options.rebuild_relocations( ), options.image_base( ) );
 
-// clang-format on
+            for ( const auto& section : options.ignore_sections( ) )
+                text += std::format( "i:{}|", section );
 
-#undef max
+            for ( const auto& section : options.targets( ).sections )
+                text += std::format( "s:{}|", section );
 
-namespace vulkan
-{
-    dumper::dumper( const wincpp::modules::module_t& module, const dumper::options& options )
-        : _module( module ),
-          _file( module.path( ), std::ios::binary ),
+            for ( const auto function : options.targets( ).functions )
+                text += std::format( "f:{:X}|", function );
+
+            for ( const auto& [ rva, size ] : options.targets( ).ranges )
+                text += std::format( "r:{:X}:{:X}|", rva, size );
+
+            return store::hash( { reinterpret_cast< const std::uint8_t* >( text.data( ) ), text.size( ) } );
+        }
+    }  // namespace
+
+    dumper::dumper( const sources::source& source, const sources::module_t& module, const dumper::options& options )
+        : _source( source ),
+          _module( module ),
+          _file( module.path, std::ios::binary ),
           _options( options )
     {
-        spdlog::debug( "Module: \"{}\" @ 0x{:X} - {} bytes", _module.name( ), _module.address( ), _module.size( ) );
+        spdlog::debug( "Module: \"{}\" @ 0x{:X} - {} bytes", _module.name, _module.address, _module.size );
 
-        _image = pe::image::create( _module );
+        // Exports are needed by more than one pass, so they are always enumerated through a cache, even if the caller did not share one.
+        if ( !_options.export_cache( ) )
+            _options.export_cache( std::make_shared< sources::export_cache >( ) );
 
-        // Create the file only if we're rebasing the image. This is because we may reference the `.reloc` section
-        // when rebasing the image. If we don't, we can just use the original file.
-        if ( _file && options.image_base( ) != -1 )
+        if ( _module.size < pe::PAGE_SIZE )
+            throw std::runtime_error( "failed to read the headers of the module" );
+
+        if ( !options.stream_path( ).empty( ) )
         {
-            _file.seekg( 0, std::ios::end );
+            const auto output = std::make_shared< io::mapped_output >( options.stream_path( ), _module.size );
+
+            if ( !output->is_valid( ) )
+                throw std::runtime_error( std::format( "failed to map the output file \"{}\"", options.stream_path( ) ) );
+
+            // The headers are the first page of the module.
+            if ( !_source.read( _module.address, output->data( ).first( pe::PAGE_SIZE ) ) )
+                throw std::runtime_error( "failed to read the headers of the module" );
+
+            spdlog::debug( "Streaming to \"{}\" with a budget of {} bytes", options.stream_path( ), options.memory_budget( ) );
 
-            const auto file_size = _file.tellg( );
+            _image = std::make_unique< pe::image >( output, true );
+        }
+        else
+        {
+            std::vector< std::uint8_t > buffer( _module.size );
 
-            _file.seekg( 0, std::ios::beg );
+            // The headers are the first page of the module.
+            if ( !_source.read( _module.address, { buffer.data( ), pe::PAGE_SIZE } ) )
+                throw std::runtime_error( "failed to read the headers of the module" );
 
-            std::vector< std::uint8_t > buffer( file_size );
+            _image = std::make_unique< pe::image >( buffer, true );
+        }
 
-            if ( _file.read( reinterpret_cast< char* >( buffer.data( ) ), file_size ) )
+        // Create the file only if we're rebasing the image. This is because we may reference the `.reloc` section
+        // when rebasing the image. If we don't, we can just use the original file.
+        if ( _file && options.image_base( ) != -1 )
+        {
+            // Only the headers are needed to locate the `.reloc` section, which is read straight from the file when it is.
+            std::vector< std::uint8_t > buffer( pe::PAGE_SIZE );
+
+            if ( _file.read( reinterpret_cast< char* >( buffer.data( ) ), buffer.size( ) ) )
                 _physical_image = std::make_unique< pe::image >( buffer, false );
         }
     }
 
-    std::list< std::pair< std::uintptr_t, std::shared_ptr< wincpp::modules::module_t::export_t > > > dumper::get_imports(
-        const std::vector< std::shared_ptr< wincpp::modules::module_t > >& modules )
+    std::pmr::vector< std::pair< std::uintptr_t, sources::export_t > > dumper::get_imports( const std::vector< sources::module_t >& modules )
     {
-        std::list< std::pair< std::uintptr_t, std::shared_ptr< wincpp::modules::module_t::export_t > > > imports;
+        std::pmr::vector< std::pair< std::uintptr_t, sources::export_t > > imports( _arena.get( ) );
+
+        // The exports of every module. They are referenced by the resolver, so they are kept until the imports are copied out.
+        std::pmr::vector< std::shared_ptr< const std::vector< sources::export_t > > > tables( _arena.get( ) );
+        std::pmr::vector< std::span< const sources::export_t > > spans( _arena.get( ) );
 
-        // Export map for resolving addresses
-        std::unordered_map< std::uintptr_t, std::shared_ptr< wincpp::modules::module_t::export_t > > export_map;
+        tables.reserve( modules.size( ) );
+        spans.reserve( modules.size( ) );
 
-        // Populate the export map
         for ( const auto& module : modules )
         {
-            for ( const auto& e : module->exports( ) )
-            {
-                export_map[ e->address( ) ] = e;
-            }
+            tables.push_back( _options.export_cache( )->exports( _source, module ) );
+            spans.push_back( *tables.back( ) );
         }
 
+        // Forwarder chains and API set contracts are resolved once, so that every address maps to its canonical export directly.
+        const auto api_sets = _source.api_sets( );
+        const sources::export_resolver resolver( spans, api_sets );
+
+        spdlog::debug( "Resolved the exports of {} modules to {} addresses", modules.size( ), resolver.size( ) );
+
         // Get the .rdata section
-        if ( const auto& rdata = _module.fetch_section( ".rdata" ) )
+        if ( const auto& rdata = _image->section_headers( )->find( ".rdata" ) )
         {
+            std::pmr::vector< std::uint8_t > buffer( rdata->Misc.VirtualSize, _arena.get( ) );
+
             // Read the entire section
-            const auto& buffer = rdata->read( );
+            if ( buffer.size( ) < _image->pointer_size( ) || !_source.read( _module.address + rdata->VirtualAddress, buffer ) )
+                return imports;
 
-            // Iterate over each address in the section
-            for ( std::size_t i = 0; i < rdata->size( ); ++i )
-            {
-                const auto& address = *reinterpret_cast< std::uintptr_t* >( buffer.get( ) + i );
+            // Addresses are as wide as the pointers of the image, so the scan is specialized for its layout.
+            pe::dispatch(
+                _image->arch( ),
+                [ & ]< typename Arch >( Arch )
+                {
+                    using pointer_t = typename Arch::pointer_t;
 
-                if ( !address )
-                    continue;
+                    // Iterate over each address in the section
+                    for ( std::size_t i = 0; i + sizeof( pointer_t ) <= buffer.size( ); ++i )
+                    {
+                        const auto address = static_cast< std::uintptr_t >( *reinterpret_cast< const pointer_t* >( buffer.data( ) + i ) );
 
-                // Check if the address is in the export map
-                if ( const auto& e = export_map.find( address ); e != export_map.end( ) )
-                    imports.push_back( { address, e->second } );
-            }
+                        if ( !address )
+                            continue;
+
+                        // Check if the address is exported
+                        if ( const auto e = resolver.find( address ) )
+                            imports.emplace_back( address, *e );
+                    }
+                } );
         }
 
         return imports;
     }
 
-    std::unique_ptr< pe::image >
-    dumper::dump( const std::unique_ptr< wincpp::process_t >& process, const dumper::options& options, std::stop_token stop_token )
+    void dumper::charge( std::size_t size ) noexcept
+    {
+        if ( !_image->mapping( ) || ( _resident += size ) <= _options.memory_budget( ) )
+            return;
+
+        _image->release( );
+        _resident = 0;
+    }
+
+    void dumper::report( const progress_t& progress ) const
+    {
+        if ( _options.progress( ) )
+            _options.progress( )( progress );
+    }
+
+    std::vector< bool > dumper::select_pages( std::span< const pe::runtime_function_t > functions ) const
     {
-        const auto& m = process->module_factory[ options.module_name( ) ];
+        const auto& targets = _options.targets( );
 
-        std::unique_ptr< dumper > d( new dumper( m, options ) );
+        if ( targets.empty( ) )
+            return { };
 
-        d->resolve_sections( stop_token );
+        std::vector< bool > pages( pe::align< std::size_t >( _module.size, pe::PAGE_SIZE ) / pe::PAGE_SIZE, false );
 
-        if ( options.resolve_imports( ) )
-            d->resolve_imports( process->module_factory.modules( ) );
+        const auto select = [ & ]( std::uint64_t rva, std::uint64_t size )
+        {
+            for ( auto page = rva / pe::PAGE_SIZE; page < pages.size( ) && page * pe::PAGE_SIZE < rva + std::max< std::uint64_t >( size, 1 ); ++page )
+                pages[ page ] = true;
+        };
+
+        // The headers are always read.
+        select( 0, pe::PAGE_SIZE );
+
+        for ( const auto& [ rva, size ] : targets.ranges )
+            select( rva, size );
 
-        d->resolve_runtime_functions( );
+        for ( const auto& name : targets.sections )
+        {
+            if ( const auto section = _image->section_headers( )->find( name.c_str( ) ) )
+                select( section->VirtualAddress, section->Misc.VirtualSize );
+            else
+                spdlog::warn( "Targeted section \"{}\" does not exist", name );
+        }
 
-        if ( options.image_base( ) != -1 )
+        for ( const auto rva : targets.functions )
         {
-            spdlog::info( "Rebasing image to 0x{:X}", options.image_base( ) );
+            const auto function = std::find_if(
+                functions.begin( ), functions.end( ), [ rva ]( const pe::runtime_function_t& entry ) { return entry.BeginAddress == rva; } );
 
-            d->_image->rebase( options.image_base( ) );
+            if ( function != functions.end( ) && function->EndAddress > function->BeginAddress )
+            {
+                select( function->BeginAddress, function->EndAddress - function->BeginAddress );
+                continue;
+            }
+
+            spdlog::warn( "Targeted function @ 0x{:X} is not in the exception directory, only its first page is read", rva );
+            select( rva, 1 );
         }
 
-        if ( !options.minidump_path( ).empty( ) )
+        // Directories point at names and tables around them, so the sections that hold them are read whole. The resource directory is
+        // left out, since it is rarely needed and often huge, and the security directory holds a file offset instead of an address.
+        for ( std::uint32_t id = 0; id < pe::NUMBEROF_DIRECTORY_ENTRIES; ++id )
         {
-            spdlog::info( "Creating minidump at \"{}\"", options.minidump_path( ) );
+            if ( id == pe::DIRECTORY_ENTRY_RESOURCE || id == pe::DIRECTORY_ENTRY_SECURITY )
+                continue;
 
-            // Create a minidump of the process.
-            d->save_minidump( process, options.minidump_path( ) );
+            if ( const auto directory = _image->data_directory( id ); directory->VirtualAddress && directory->Size )
+                select( directory->VirtualAddress, directory->Size );
         }
 
-        // Refresh the image one last time. This will recalculate the checksum.
-        d->_image->refresh( );
+        spdlog::info( "Targeting {} of {} pages", std::count( pages.begin( ), pages.end( ), true ), pages.size( ) );
+
+        return pages;
+    }
+
+    pass_manager& dumper::pass_registry( )
+    {
+        static pass_manager registry = []( )
+        {
+            pass_manager manager;
+
+            manager.add( { "sections",
+                           resource_t::memory,
+                           resource_t::sections | resource_t::headers,
+                           { },
+                           []( dumper& d, std::stop_token stop_token )
+                           {
+                               d.resolve_sections( stop_token );
+                           } } );
+
+            manager.add( { "imports",
+                           resource_t::memory | resource_t::sections | resource_t::headers,
+                           resource_t::sections | resource_t::headers | resource_t::imports | resource_t::xrefs,
+                           []( const dumper& d ) { return d._options.resolve_imports( ); },
+                           []( dumper& d, std::stop_token )
+                           {
+                               d.resolve_imports( d._source.modules( ) );
+                           } } );
+
+            manager.add( { "runtime-functions",
+                           resource_t::sections | resource_t::exceptions,
+                           resource_t::sections | resource_t::exceptions,
+                           { },
+                           []( dumper& d, std::stop_token )
+                           {
+                               d.resolve_runtime_functions( );
+                           } } );
+
+            manager.add( { "relocations",
+                           resource_t::sections | resource_t::headers | resource_t::relocations | resource_t::exceptions,
+                           resource_t::sections | resource_t::headers | resource_t::relocations | resource_t::xrefs,
+                           []( const dumper& d ) { return d._options.rebuild_relocations( ) || d._options.image_base( ) != -1; },
+                           []( dumper& d, std::stop_token )
+                           {
+                               d.resolve_relocations( );
+                           } } );
+
+            manager.add( { "rebase",
+                           resource_t::sections | resource_t::headers | resource_t::relocations,
+                           resource_t::sections | resource_t::headers,
+                           []( const dumper& d ) { return d._options.image_base( ) != -1; },
+                           []( dumper& d, std::stop_token )
+                           {
+                               spdlog::info( "Rebasing image to 0x{:X}", d._options.image_base( ) );
+
+                               d._image->rebase( d._options.image_base( ) );
+                               d._image->release( );
+                           } } );
+
+            // Write the checksum one last time. It is only recomputed if the image changed since it was last computed.
+            manager.add( { "checksum",
+                           resource_t::sections | resource_t::headers,
+                           resource_t::headers,
+                           { },
+                           []( dumper& d, std::stop_token )
+                           {
+                               d._image->update_checksum( );
+                           } } );
+
+            manager.add( { "coverage",
+                           resource_t::sections | resource_t::headers,
+                           resource_t::none,
+                           []( const dumper& d ) { return !d._options.coverage_path( ).empty( ); },
+                           []( dumper& d, std::stop_token )
+                           {
+                               // No pass that writes the sections runs alongside this one, so even the live view of a streamed image
+                               // holds still while it is classified.
+                               auto pages = analysis::classify_pages( d._image->snapshot( ) );
+
+                               for ( auto& page : pages )
+                                   page.accepted = d._accepted_pages.contains( page.rva );
+
+                               std::array< std::size_t, 5 > counts = { };
+
+                               for ( const auto& page : pages )
+                                   ++counts[ static_cast< std::size_t >( page.profile.type ) ];
+
+                               spdlog::info(
+                                   "Code pages: {} code, {} data, {} encrypted, {} zero, {} unread",
+                                   counts[ static_cast< std::size_t >( analysis::page_class_t::code ) ],
+                                   counts[ static_cast< std::size_t >( analysis::page_class_t::data ) ],
+                                   counts[ static_cast< std::size_t >( analysis::page_class_t::encrypted ) ],
+                                   counts[ static_cast< std::size_t >( analysis::page_class_t::zero ) ],
+                                   counts[ static_cast< std::size_t >( analysis::page_class_t::filler ) ] );
+
+                               if ( !analysis::save_coverage_map( d._options.coverage_path( ), pages ) )
+                                   spdlog::error( "Failed to write coverage map \"{}\"", d._options.coverage_path( ) );
+                           } } );
+
+            manager.add( { "xrefs",
+                           resource_t::sections | resource_t::imports | resource_t::exceptions,
+                           resource_t::xrefs,
+                           []( const dumper& d ) { return !d._options.xref_path( ).empty( ); },
+                           []( dumper& d, std::stop_token )
+                           {
+                               d.save_xref_database( );
+                           } } );
+
+            // The result is stored once every pass that changes the image is done. Saving brings the checksum up to date.
+            manager.add( { "store",
+                           resource_t::sections | resource_t::headers | resource_t::imports | resource_t::relocations | resource_t::exceptions,
+                           resource_t::headers,
+                           []( const dumper& d ) { return !d._store_key.empty( ); },
+                           []( dumper& d, std::stop_token stop_token )
+                           {
+                               // Cancelled dumps may have skipped passes, so they are not stored.
+                               if ( !d._staged || stop_token.stop_requested( ) )
+                                   return;
+
+                               if ( d._options.result_store( )->commit( d._store_key, *d._image, *d._staged, d._missing_pages ) )
+                                   spdlog::info( "Stored the dump with {} missing code pages", d._missing_pages );
+                               else
+                                   spdlog::error( "Failed to store the dump" );
+                           } } );
+
+            return manager;
+        }( );
+
+        return registry;
+    }
+
+    std::unique_ptr< pe::image > dumper::dump( const sources::source& source, const dumper::options& options, std::stop_token stop_token )
+    {
+        const auto& m = source.find_module( options.module_name( ) );
+
+        if ( !m )
+            throw std::runtime_error( std::format( "module \"{}\" not found", options.module_name( ) ) );
+
+        // Delta files hold the pages as they are mapped at the address of the module, which a rebased image no longer matches.
+        if ( options.watch_interval( ).count( ) > 0 && options.image_base( ) != -1 )
+            throw std::runtime_error( "a watched image cannot be rebased" );
+
+        // Dumps of a build that was dumped before with the same options are taken from the result store.
+        std::string key;
+        std::optional< store::result_store::entry_t > entry;
+
+        if ( const auto& results = options.result_store( ) )
+        {
+            if ( const auto fingerprint = store::fingerprint( source, *m ) )
+            {
+                key = store::result_store::key( m->name, *fingerprint, options_hash( options ) );
+                entry = results->find( key );
+            }
+
+            // Side outputs and watching need the passes to run, so only plain dumps are reused as they are.
+            const auto plain = options.coverage_path( ).empty( ) && options.xref_path( ).empty( ) && options.minidump_path( ).empty( ) &&
+                               options.watch_interval( ).count( ) <= 0;
+
+            if ( entry && !entry->missing_pages && plain )
+            {
+                if ( auto image = results->load( *entry ) )
+                {
+                    spdlog::info( "Reusing the dump of \"{}\" from \"{}\"", m->name, entry->image.string( ) );
+                    return image;
+                }
+            }
+        }
+
+        std::unique_ptr< dumper > d( new dumper( source, *m, options ) );
+
+        d->_store_key = std::move( key );
+
+        // Otherwise the code pages that were acquired last time seed the dump, and only the missing ones are polled.
+        if ( entry )
+        {
+            if ( auto seed = watch::read_delta( entry->pages.string( ) ); seed && seed->address == m->address )
+                d->_seed = std::move( seed );
+        }
+
+        // Every dump gets its own copy of the passes, so that the timings of concurrent dumps are not shared.
+        auto passes = [ ]( )
+        {
+            std::lock_guard lock( registry_mutex );
+            return pass_registry( );
+        }( );
+        passes.run( *d, stop_token, [ & ]( const pass_t& pass ) { d->report( { pass.name, { }, 0, 0 } ); } );
+
+        d->watch( stop_token );
+
+#ifndef NDEBUG
+        const auto stats = d->_arena->stats( );
+
+        spdlog::debug( "Arena served {} allocations ({} bytes)", stats.allocations, stats.bytes );
+#endif
 
         return std::move( d->_image );
     }
 
+    void dumper::register_pass( pass_t pass )
+    {
+        std::lock_guard lock( registry_mutex );
+
+        pass_registry( ).add( std::move( pass ) );
+    }
+
+    const dumper::options& dumper::settings( ) const noexcept
+    {
+        return _options;
+    }
+
+    const sources::source& dumper::source( ) const noexcept
+    {
+        return _source;
+    }
+
+    const std::unique_ptr< pe::image >& dumper::image( ) const noexcept
+    {
+        return _image;
+    }
+
+    analysis::xref_table& dumper::cross_references( )
+    {
+        if ( !_xrefs )
+            _xrefs = analysis::xref_table::build( _image->snapshot( ) );
+
+        return *_xrefs;
+    }
+
+    void dumper::watch( std::stop_token stop_token )
+    {
+        if ( !_watcher || stop_token.stop_requested( ) )
+            return;
+
+        if ( !_image->save_to_file( _options.watch_path( ) ) )
+            throw std::runtime_error( std::format( "failed to save \"{}\"", _options.watch_path( ) ) );
+
+        spdlog::info( "Watching {} code pages every {:.3f} s", _watcher->size( ), _options.watch_interval( ).count( ) );
+
+        std::mutex mutex;
+        std::condition_variable_any condition;
+        std::unique_lock lock( mutex );
+
+        for ( std::uint64_t sequence = 1;; )
+        {
+            // Nothing ever notifies the condition, so the wait only ends once the interval passed or the dump was stopped.
+            condition.wait_for( lock, stop_token, _options.watch_interval( ), [ ] { return false; } );
+
+            if ( stop_token.stop_requested( ) )
+                break;
+
+            const auto changed = _watcher->poll( );
+
+            report( { "watch", { }, changed.size( ), _watcher->size( ) } );
+
+            if ( changed.empty( ) )
+                continue;
+
+            const auto path = std::format( "{}.{}.delta", _options.watch_path( ), sequence );
+
+            // A failed delta still takes up its sequence number, so that the gap shows that pages are missing.
+            if ( watch::write_delta( path, _module.address, sequence++, *_image, changed ) )
+                spdlog::info( "Wrote {} changed pages to \"{}\"", changed.size( ), path );
+            else
+                spdlog::error( "Failed to write delta \"{}\"", path );
+        }
+
+        // The image is returned with every change applied, so its checksum has to be brought up to date.
+        _image->update_checksum( );
+    }
+
     void dumper::resolve_sections( std::stop_token stop_token )
     {
+        // Code pages are weighed by the functions they hold. The exception directory is read straight from the source, since the section
+        // it lives in is usually resolved after the code.
+        std::pmr::vector< pe::runtime_function_t > functions( _arena.get( ) );
+        std::pmr::vector< std::uint32_t > function_starts( _arena.get( ) );
+        std::pmr::vector< std::uint32_t > entry_points( _arena.get( ) );
+
+        if ( const auto directory = _image->data_directory( pe::DIRECTORY_ENTRY_EXCEPTION );
+             directory && directory->VirtualAddress && directory->Size >= sizeof( pe::runtime_function_t ) )
+        {
+            functions.resize( directory->Size / sizeof( pe::runtime_function_t ) );
+
+            if ( !_source.read(
+                     _module.address + directory->VirtualAddress,
+                     { reinterpret_cast< std::uint8_t* >( functions.data( ) ), functions.size( ) * sizeof( pe::runtime_function_t ) } ) )
+                functions.clear( );
+
+            for ( const auto& function : functions )
+                function_starts.push_back( function.BeginAddress );
+        }
+
+        if ( const auto entry_point = _image->nt_headers( )->OptionalHeader.AddressOfEntryPoint )
+            entry_points.push_back( entry_point );
+
+        for ( const auto& e : *_options.export_cache( )->exports( _source, _module ) )
+        {
+            if ( e.address >= _module.address && e.address - _module.address < _module.size )
+                entry_points.push_back( static_cast< std::uint32_t >( e.address - _module.address ) );
+        }
+
+        spdlog::debug( "Weighing code pages by {} functions and {} entry points", function_starts.size( ), entry_points.size( ) );
+
+        // Targeted dumps only acquire the selected pages.
+        const auto selected = select_pages( functions );
+
+        const auto is_selected = [ & ]( std::uint32_t rva )
+        { return selected.empty( ) || ( rva / pe::PAGE_SIZE < selected.size( ) && selected[ rva / pe::PAGE_SIZE ] ); };
+
+        // Watched dumps remember which code pages were acquired, so that only the rest has to be read in full later on.
+        const auto watching = _options.watch_interval( ).count( ) > 0 && _source.is_live( );
+
+        std::pmr::vector< std::uint32_t > watched_pages( _arena.get( ) ), read_pages( _arena.get( ) );
+
+        // The code pages that were read, for the result store.
+        std::pmr::vector< std::uint32_t > stored_pages( _arena.get( ) );
+
         for ( std::size_t idx = 0; idx < _image->section_headers( )->count( ); ++idx )
         {
             const auto& header = _image->section_headers( )->at( idx );
@@ -137,19 +593,64 @@ namespace vulkan
                 spdlog::debug( "Ignoring section: \"{}\"", name );
 
                 _image->section_headers( )->remove( idx );
+                _image->touch( );
                 --idx;
                 continue;
             }
 
             const auto& absolute_address = _image->image_base( ) + header->VirtualAddress;
 
+            if ( !selected.empty( ) )
+            {
+                bool targeted = false;
+
+                for ( std::uint32_t offset = 0; offset < header->Misc.VirtualSize && !targeted; offset += pe::PAGE_SIZE )
+                    targeted = is_selected( header->VirtualAddress + offset );
+
+                if ( !targeted )
+                {
+                    spdlog::debug( "Skipping section: \"{}\" (not targeted)", name );
+                    continue;
+                }
+            }
+
             spdlog::info( "Resolving section: \"{}\" @ 0x{:X} - {} bytes", name, absolute_address, header->Misc.VirtualSize );
 
             // We need to read code sections page by page.
-            if ( header->Characteristics & IMAGE_SCN_CNT_CODE )
+            if ( header->Characteristics & pe::SCN_CNT_CODE )
             {
-                std::unordered_set< std::uintptr_t > pages_read;
-                const auto total_pages = header->Misc.VirtualSize / 0x1000;
+                std::pmr::unordered_set< std::uintptr_t > pages_read( _arena.get( ) );
+
+                // Pages that were readable, but looked encrypted the last time they were read.
+                std::pmr::unordered_map< std::uintptr_t, suspect_page_t > encrypted( _arena.get( ) );
+                std::size_t accepted = 0;
+
+                // The last page of a section is usually only partly used, but it still holds code.
+                const auto page_count = pe::align< std::uint32_t >( header->Misc.VirtualSize, pe::PAGE_SIZE ) / pe::PAGE_SIZE;
+
+                // Valuable pages are polled first, so that stopping early keeps as much of the useful code as possible.
+                const acquisition::page_weights weights( header->VirtualAddress, page_count, function_starts, entry_points );
+
+                auto order = weights.order( );
+
+                // Targeted dumps neither poll nor wait on pages outside of the targets, and pages past the raw data have nothing to read.
+                std::erase_if(
+                    order,
+                    [ & ]( std::size_t page )
+                    {
+                        const auto page_rva = static_cast< std::uint32_t >( page ) * 0x1000;
+                        return page_rva >= header->SizeOfRawData || !is_selected( header->VirtualAddress + page_rva );
+                    } );
+
+                const auto total_pages = order.size( );
+
+                // Rehashing would leave the old buckets behind in the arena.
+                pages_read.reserve( total_pages );
+
+                double total_weight = 0.0, weight_read = 0.0;
+
+                for ( const auto page : order )
+                    total_weight += weights[ page ];
 
                 // Before we do anything, fill the buffer with nop instructions.
                 std::fill(
@@ -157,52 +658,225 @@ namespace vulkan
                     _image->buffer( ).begin( ) + header->PointerToRawData + header->SizeOfRawData,
                     0x90 );
 
-                while ( !stop_token.stop_requested( ) && ( pages_read.size( ) <= total_pages ) )
+                charge( header->SizeOfRawData );
+
+                if ( _seed )
                 {
-                    for ( auto page = 0; page < total_pages; ++page )
+                    for ( const auto page : order )
                     {
+                        const auto rva = header->VirtualAddress + static_cast< std::uint32_t >( page ) * 0x1000;
+                        const auto it = std::lower_bound( _seed->pages.begin( ), _seed->pages.end( ), rva );
+
+                        if ( it == _seed->pages.end( ) || *it != rva )
+                            continue;
+
+                        const auto bytes = _seed->page( static_cast< std::size_t >( it - _seed->pages.begin( ) ) );
+                        const auto size = std::min< std::size_t >( bytes.size( ), header->SizeOfRawData - page * 0x1000 );
+
+                        std::copy_n( bytes.begin( ), size, _image->buffer( ).begin( ) + header->PointerToRawData + page * 0x1000 );
+
+                        pages_read.insert( page );
+                        weight_read += weights[ page ];
+                    }
+
+                    spdlog::info( "Took {}/{} pages of \"{}\" from the result store", pages_read.size( ), total_pages, name );
+                }
+
+                // Timings are taken from the source, so that replayed traces report the times of their virtual clock.
+                const auto start = _source.now( );
+                const auto elapsed = [ & ]( ) { return std::chrono::duration< double >( _source.now( ) - start ).count( ); };
+
+                const acquisition::termination_policy policy{ _options.target_decryption_factor( ), _options.min_gain_rate( ), _options.deadline( ) };
+
+                // Pages taken from the result store were there from the start, so they must not show up as a burst of arrivals.
+                acquisition::arrival_model model( total_pages, start, pages_read.size( ) );
+
+                // A copy of the model from when it first became warm. Its prediction is compared with what was actually achieved.
+                std::optional< acquisition::arrival_model > baseline;
+
+                auto reason = acquisition::stop_reason_t::none;
+                auto last_report = start;
+
+                // The protections of the section are walked once, and only the regions that are due are walked again on later sweeps.
+                sources::region_map regions( _source, absolute_address, header->Misc.VirtualSize );
+
+                for ( bool swept = false;; swept = true )
+                {
+                    if ( stop_token.stop_requested( ) )
+                    {
+                        reason = acquisition::stop_reason_t::cancelled;
+                        break;
+                    }
+
+                    // The pages of a static source never change, so one sweep is all it takes.
+                    if ( swept && !_source.is_live( ) )
+                    {
+                        reason = acquisition::stop_reason_t::exhausted;
+                        break;
+                    }
+
+                    if ( swept )
+                        regions.refresh( );
+
+                    bool polled = false;
+
+                    for ( const auto page : order )
+                    {
+                        if ( stop_token.stop_requested( ) )
+                            break;
+
                         const auto page_rva = page * 0x1000;
 
                         // If we've read this page, skip.
                         if ( pages_read.find( page ) != pages_read.end( ) )
                             continue;
 
-                        const auto& region = *_module.factory[ absolute_address + page_rva ].regions( ).begin( );
+                        const auto& region = regions.find( absolute_address + page_rva );
                         const auto offset = header->PointerToRawData + page_rva;
+                        const auto size = std::min< std::size_t >( 0x1000, header->SizeOfRawData - page_rva );
 
                         // If the page is not accessible, skip.
-                        if ( !region.protection( ).has( wincpp::memory::protection_t::noaccess_t ) )
+                        if ( region && region->readable )
                         {
-                            if ( const auto& data = _module.factory.read( absolute_address + page_rva, 0x1000 ) )
+                            polled = true;
+
+                            if ( _source.read( absolute_address + page_rva, { _image->buffer( ).data( ) + offset, size } ) )
                             {
+                                charge( size );
+
+                                const auto page_class = analysis::classify_page( std::span( _image->buffer( ) ).subspan( offset, size ) ).type;
+
+                                // Readable pages that still look random have not been decrypted yet, so poll them again. They are kept once
+                                // the same contents came back a few times in a row, or after too many reads, so that acquisition ends.
+                                if ( page_class == analysis::page_class_t::encrypted )
+                                {
+                                    const auto hash = store::hash( std::span( _image->buffer( ) ).subspan( offset, size ) );
+                                    const auto [ it, inserted ] = encrypted.try_emplace( page, suspect_page_t{ hash, 0, 0 } );
+                                    auto& suspect = it->second;
+
+                                    if ( inserted )
+                                        spdlog::debug( "Page @ 0x{:X} looks encrypted", absolute_address + page_rva );
+
+                                    suspect.repeats = suspect.hash == hash ? suspect.repeats + 1 : 1;
+                                    suspect.hash = hash;
+
+                                    if ( ++suspect.reads < MAX_ENCRYPTED_READS && suspect.repeats < STABLE_READS )
+                                        continue;
+
+                                    spdlog::debug(
+                                        "Page @ 0x{:X} still looks encrypted after {} reads, keeping it",
+                                        absolute_address + page_rva,
+                                        suspect.reads );
+
+                                    _accepted_pages.insert( header->VirtualAddress + static_cast< std::uint32_t >( page_rva ) );
+                                    ++accepted;
+                                }
+
+                                encrypted.erase( page );
+
                                 const auto percent = static_cast< double >( pages_read.size( ) ) / total_pages * 100.0;
 
                                 spdlog::debug(
-                                    "Read page @ 0x{:X} ({}/{}) = {:.3f}%", absolute_address + page_rva, pages_read.size( ), total_pages, percent );
-
-                                // Copy the data into the image buffer.
-                                std::copy( data.get( ), data.get( ) + 0x1000, _image->buffer( ).begin( ) + offset );
+                                    "Read page @ 0x{:X} ({}/{}) = {:.3f}% after {:.3f} s",
+                                    absolute_address + page_rva,
+                                    pages_read.size( ),
+                                    total_pages,
+                                    percent,
+                                    elapsed( ) );
 
                                 // Mark the page as read.
                                 pages_read.insert( page );
+                                weight_read += weights[ page ];
                                 continue;
                             }
                         }
                     }
+
+                    const auto now = _source.now( );
+
+                    model.observe( now, pages_read.size( ) );
+
+                    report( { "sections", { name, strnlen( name, sizeof( header->Name ) ) }, pages_read.size( ), total_pages } );
+
+                    if ( !baseline && model.is_warm( ) )
+                        baseline = model;
+
+                    if ( ( reason = policy.evaluate( model ) ) != acquisition::stop_reason_t::none )
+                        break;
+
+                    if ( now - last_report >= std::chrono::seconds( 1 ) )
+                    {
+                        last_report = now;
+
+                        const auto next = model.time_to( std::min< double >( model.coverage( ) + 0.01, policy.target ) );
+
+                        spdlog::debug(
+                            "Coverage of \"{}\" is {:.2f}% ({:.2f}% weighted) at {:.2f} pages/s, next 1% expected in {}",
+                            name,
+                            model.coverage( ) * 100.0,
+                            total_weight ? weight_read / total_weight * 100.0 : 100.0,
+                            model.rate( ),
+                            next ? std::format( "{:.1f} s", next->count( ) ) : "never" );
+                    }
+
+                    // Nothing could be read, so wait for the next region to be walked again instead of spinning. A replayed source jumps
+                    // its clock there, since no read will move it.
+                    if ( !polled && _source.is_live( ) )
+                        _source.wait_until( regions.next_due( ) );
+                }
+
+                spdlog::info(
+                    "Read {}/{} pages of \"{}\" ({:.2f}% weighted) in {:.3f} s ({})",
+                    pages_read.size( ),
+                    total_pages,
+                    name,
+                    total_weight ? weight_read / total_weight * 100.0 : 100.0,
+                    elapsed( ),
+                    acquisition::to_string( reason ) );
+
+                if ( !encrypted.empty( ) )
+                    spdlog::warn( "{} pages of \"{}\" still look encrypted", encrypted.size( ), name );
+
+                if ( accepted )
+                    spdlog::warn( "{} pages of \"{}\" were kept although they look encrypted", accepted, name );
+
+                if ( baseline )
+                {
+                    const auto expected = baseline->predict( model.elapsed( ) - baseline->elapsed( ) );
+
+                    spdlog::info( "Coverage of \"{}\": {:.2f}% achieved, {:.2f}% expected", name, model.coverage( ) * 100.0, expected * 100.0 );
+                }
+
+                _missing_pages += total_pages - pages_read.size( );
+
+                if ( !_store_key.empty( ) )
+                {
+                    for ( const auto page : pages_read )
+                        stored_pages.push_back( header->VirtualAddress + static_cast< std::uint32_t >( page ) * 0x1000 );
+                }
+
+                if ( watching )
+                {
+                    for ( const auto page : order )
+                    {
+                        watched_pages.push_back( header->VirtualAddress + static_cast< std::uint32_t >( page ) * 0x1000 );
+
+                        if ( pages_read.contains( page ) )
+                            read_pages.push_back( watched_pages.back( ) );
+                    }
                 }
             }
             else
             {
-                if ( const auto& data = _module.factory.read( absolute_address, header->SizeOfRawData ) )
-                {
-                    // Copy the data into the image buffer.
-                    std::copy( data.get( ), data.get( ) + header->SizeOfRawData, _image->buffer( ).begin( ) + header->PointerToRawData );
+                charge( header->SizeOfRawData );
+
+                // Read the section straight into the image buffer.
+                if ( _source.read( absolute_address, { _image->buffer( ).data( ) + header->PointerToRawData, header->SizeOfRawData } ) )
                     continue;
-                }
 
                 if ( _file && _physical_image )
                 {
-                    const auto relocation_directory = _physical_image->data_directory( IMAGE_DIRECTORY_ENTRY_BASERELOC );
+                    const auto relocation_directory = _physical_image->data_directory( pe::DIRECTORY_ENTRY_BASERELOC );
 
                     // Check if the section corresponds to the `.reloc` section. Often times discarded sections are not readable, so we'll copy their
                     // contents from the image backed by the disk.
@@ -213,15 +887,11 @@ namespace vulkan
                             // Section is always mapped, so no need to check for bounds.
                             _file.seekg( offset, std::ios::beg );
 
-                            std::vector< std::uint8_t > buffer( relocation_directory->Size );
+                            // Read the section from the file straight into the image buffer.
+                            const auto destination = reinterpret_cast< char* >( _image->buffer( ).data( ) + header->PointerToRawData );
 
-                            // Read the section from the file.
-                            if ( _file.read( reinterpret_cast< char* >( buffer.data( ) ), relocation_directory->Size ) )
-                            {
-                                // Copy the data into the image buffer.
-                                std::copy( buffer.begin( ), buffer.end( ), _image->buffer( ).begin( ) + header->PointerToRawData );
+                            if ( _file.read( destination, relocation_directory->Size ) )
                                 continue;
-                            }
                         }
                     }
                 }
@@ -237,14 +907,25 @@ namespace vulkan
         }
 
         spdlog::debug( "Resolved all sections" );
+
+        // The watcher takes its hashes from the pages as they were read, before any of the later passes patches them.
+        if ( watching )
+            _watcher = std::make_unique< watch::watcher >( _source, _module.address, *_image, watched_pages, read_pages );
+
+        // So are the pages kept by the result store, which seed later dumps of the same build.
+        if ( !_store_key.empty( ) )
+        {
+            std::sort( stored_pages.begin( ), stored_pages.end( ) );
+
+            if ( !( _staged = _options.result_store( )->stage( _store_key, _module.address, *_image, stored_pages ) ) )
+                spdlog::error( "Failed to stage the pages of the dump in the result store" );
+        }
     }
 
-    void dumper::resolve_imports( const std::vector< std::shared_ptr< wincpp::modules::module_t > >& modules )
+    void dumper::resolve_imports( const std::vector< sources::module_t >& modules )
     {
         spdlog::info( "Resolving import directory: \".vulkan\"" );
 
-        _image->refresh( );
-
         spdlog::debug( "Collecting all exported functions" );
 
         // Get the imports from the modules
@@ -254,153 +935,201 @@ namespace vulkan
         for ( const auto& [ address, imp ] : imports )
         {
             // Add the import to the IAT
-            _image->import_directory( )->add( imp->module( )->name( ), imp->name( ), address );
+            _image->import_directory( )->add( imp.module_name, imp.name, address );
         }
 
         spdlog::debug( "Recompiling the import directory" );
 
         _image->import_directory( )->recompile( _image.get( ), ".vulkan" );
 
-        // Refresh the image.
+        // Drop the merged imports, so that they are parsed back from the new directory on the next access.
         _image->import_directory( )->clear( );
-        _image->refresh( );
+        _image->touch( );
 
-        // Now we create a map that maps the value of the IAT entries to their IAT entry rva.
-        std::unordered_map< std::uintptr_t, std::uintptr_t > iat_map;
+        // The import address table entries are as wide as the pointers of the image, so the patching is specialized for its layout.
+        pe::dispatch(
+            _image->arch( ),
+            [ & ]< typename Arch >( Arch )
+            {
+                using pointer_t = typename Arch::pointer_t;
 
-        // Iterate over the imports and add them to the map.
-        for ( const auto& import : _image->import_directory( )->imports( ) )
-        {
-            // Read the IAT entry
-            const auto& iat_entry = *reinterpret_cast< std::uintptr_t* >( _image->buffer( ).data( ) + _image->rva_to_offset( import->iat_rva ) );
+                // Now we create a map that maps the value of the IAT entries to their IAT entry rva.
+                std::pmr::unordered_map< std::uintptr_t, std::uintptr_t > iat_map( _arena.get( ) );
 
-            // Add the IAT entry to the map
-            iat_map[ iat_entry ] = import->iat_rva;
-        }
+                // Iterate over the imports and add them to the map.
+                for ( const auto& import : _image->import_directory( )->imports( ) )
+                {
+                    // Read the IAT entry
+                    const auto iat_offset = _image->rva_to_offset( static_cast< std::uint32_t >( import->iat_rva ) );
+                    const auto iat_entry =
+                        static_cast< std::uintptr_t >( *reinterpret_cast< const pointer_t* >( _image->buffer( ).data( ) + iat_offset ) );
+
+                    // Add the IAT entry to the map
+                    iat_map[ iat_entry ] = import->iat_rva;
+                }
 
-        spdlog::debug( "Searching for references to the exported routines" );
+                spdlog::debug( "Searching for references to the exported routines" );
 
-        struct reference_t
-        {
-            std::uintptr_t address;
-            std::uint32_t offset;
-            std::uint32_t len;
-        };
+                // Decode every function in the exception directory to find all RIP-relative references.
+                auto& xrefs = cross_references( );
 
-        // An immutable list of patterns to search for. The first parameter is the pattern, the second is the offset and length of the relative
-        // address. The `address` field is always set to zero, as it gets filled in later.
-        const std::list< std::pair< wincpp::patterns::pattern_t, reference_t > > patterns = {
-            { wincpp::patterns::pattern_t( "\xFF\x15\x00\x00\x00\x00", "xx????" ), { 0, 2, 6 } },
-            { wincpp::patterns::pattern_t( "\x48\xFF\x25\x00\x00\x00\x00", "xx?????" ), { 0, 3, 7 } }
-        };
+                spdlog::debug( "Processing {} cross references", xrefs.size( ) );
 
-        std::vector< reference_t > references;
+                for ( std::size_t i = 0; i < xrefs.size( ); ++i )
+                {
+                    const auto& xref = xrefs.xrefs( )[ i ];
 
-        for ( const auto& [ pattern, reference ] : patterns )
-        {
-            const auto& results =
-                wincpp::patterns::scanner::find_all< wincpp::patterns::scanner::algorithm_t::naive_t >( _image->buffer( ), pattern );
+                    // Only memory operands can reference an IAT entry.
+                    if ( !xref.indirect )
+                        continue;
 
-            for ( const auto& result : results )
-                references.push_back( { result, reference.offset, reference.len } );
-        }
+                    const auto slot_offset = _image->rva_to_offset( xref.target );
 
-        spdlog::debug( "Processing {} cross references", references.size( ) );
+                    if ( !slot_offset || slot_offset + sizeof( pointer_t ) > _image->buffer( ).size( ) )
+                        continue;
 
-        for ( const auto& reference : references )
-        {
-            // Extract the relative offset from the instruction
-            auto offset = reinterpret_cast< std::uint32_t* >( _image->buffer( ).data( ) + reference.address + reference.offset );
+                    // Dereference the referenced slot
+                    const auto export_address =
+                        static_cast< std::uintptr_t >( *reinterpret_cast< const pointer_t* >( _image->buffer( ).data( ) + slot_offset ) );
 
-            // Compute the absolute address of the call instruction
-            const auto next_instruction = reference.address + reference.len;
-            const auto& absolute_address = next_instruction + *offset;
+                    // Quick check to see if the dereferenced address could be a code address (64-bit system modules are mapped high)
+                    if constexpr ( std::is_same_v< Arch, pe::pe64 > )
+                    {
+                        if ( export_address < 0x00007FF000000000 || export_address > 0x00007FFFFFFFFFFF )
+                            continue;
+                    }
 
-            // Dereference the absolute address
-            const auto& export_address =
-                *reinterpret_cast< std::uintptr_t* >( _image->buffer( ).data( ) + _image->rva_to_offset( absolute_address ) );
+                    // Check if the old IAT entry is in the IAT map
+                    if ( const auto& iat_entry = iat_map.find( export_address ); iat_entry != iat_map.end( ) )
+                    {
+                        // Extract the relative offset from the instruction
+                        auto offset =
+                            reinterpret_cast< std::uint32_t* >( _image->buffer( ).data( ) + _image->rva_to_offset( xref.source ) + xref.operand );
 
-            // Quick check to see if the dereferenced address could be a code address
-            if ( export_address < 0x00007FF000000000 || export_address > 0x00007FFFFFFFFFFF )
-                continue;
+                        // Compute the new relative offset
+                        const auto& new_offset = iat_entry->second - ( xref.source + xref.length );
 
-            // Check if the old IAT entry is in the IAT map
-            if ( const auto& iat_entry = iat_map.find( export_address ); iat_entry != iat_map.end( ) )
-            {
-                // Get the new IAT entry RVA
-                const auto& new_iat_rva = iat_entry->second;
+                        // Write the new relative offset
+                        *offset = static_cast< std::uint32_t >( new_offset );
 
-                // Compute the new relative offset
-                const auto& new_offset = new_iat_rva - next_instruction;
+                        // Keep the table in line with the patched instruction, so that it can be reused by the later passes.
+                        xrefs.retarget( i, static_cast< std::uint32_t >( iat_entry->second ) );
 
-                // Write the new relative offset
-                *offset = new_offset;
+                        spdlog::debug( "Patched instruction @ 0x{:X} to 0x{:X}", _image->image_base( ) + xref.source, *offset );
+                    }
+                }
+            } );
 
-                spdlog::debug( "Patched instruction @ 0x{:X} to 0x{:X}", _image->image_base( ) + reference.address, *offset );
-            }
-        }
+        _image->release( );
     }
 
     void dumper::resolve_runtime_functions( )
     {
-        const auto exception_directory = _image->data_directory( IMAGE_DIRECTORY_ENTRY_EXCEPTION );
+        // The snapshot of a streamed image is a live view, so the invalid entries are only removed once every entry was checked.
+        std::vector< std::uint32_t > invalid;
 
-        if ( !exception_directory->VirtualAddress || !exception_directory->Size )
-            return;
+        const auto snapshot = _image->snapshot( );
+        const auto exception_directory = snapshot.data_directory( pe::DIRECTORY_ENTRY_EXCEPTION );
+        const auto functions = snapshot.runtime_functions( );
 
-        for ( auto rva = exception_directory->VirtualAddress; rva < exception_directory->VirtualAddress + exception_directory->Size;
-              rva += sizeof( IMAGE_RUNTIME_FUNCTION_ENTRY ) )
+        struct unwind_info_t
         {
-            const auto offset = _image->rva_to_offset( rva );
+            std::uint8_t version : 3;
+            std::uint8_t flags : 5;
 
-            if ( !offset )
-                continue;
+            // No need to implement the rest, as we don't need it.
+        };
 
-            const auto& entry = *reinterpret_cast< PIMAGE_RUNTIME_FUNCTION_ENTRY >( _image->buffer( ).data( ) + offset );
+        for ( std::size_t i = 0; i < functions.size( ); ++i )
+        {
+            const auto& entry = functions[ i ];
+            const auto rva = static_cast< std::uint32_t >( exception_directory.VirtualAddress + i * sizeof( pe::runtime_function_t ) );
 
-            const auto unwind_offset = _image->rva_to_offset( entry.UnwindInfoAddress );
+            const auto unwind_info = snapshot.read< unwind_info_t >( entry.UnwindInfoAddress );
 
             // Check if the entry is valid
-            if ( _image->rva_to_offset( entry.BeginAddress ) && _image->rva_to_offset( entry.EndAddress ) && unwind_offset )
+            if ( snapshot.rva_to_offset( entry.BeginAddress ) && snapshot.rva_to_offset( entry.EndAddress ) &&
+                 snapshot.rva_to_offset( entry.UnwindInfoAddress ) )
                 continue;
 
-            struct unwind_info_t
-            {
-                std::uint8_t version : 3;
-                std::uint8_t flags : 5;
-
-                // No need to implement the rest, as we don't need it.
-            };
-
-            const auto unwind_info = *reinterpret_cast< unwind_info_t* >( _image->buffer( ).data( ) + unwind_offset );
-
             // Check if the unwind info is valid
-            if ( unwind_info.version == 1 )
+            if ( unwind_info && unwind_info->version == 1 )
                 continue;
 
             spdlog::warn( "Invalid runtime function entry @ 0x{:X}. Removing.", rva );
 
+            invalid.push_back( rva );
+        }
+
+        for ( const auto rva : invalid )
+        {
+            const auto offset = _image->rva_to_offset( rva );
+
             // Remove the entry from the image;
-            std::fill( _image->buffer( ).begin( ) + offset, _image->buffer( ).begin( ) + offset + sizeof( IMAGE_RUNTIME_FUNCTION_ENTRY ), 0x00 );
+            std::fill( _image->buffer( ).begin( ) + offset, _image->buffer( ).begin( ) + offset + sizeof( pe::runtime_function_t ), 0x00 );
         }
     }
 
-    void dumper::save_minidump( const std::unique_ptr< wincpp::process_t >& process, const std::string_view path ) const
+    void dumper::resolve_relocations( )
+    {
+        // The relocation directory is parsed on access, so it reflects the sections that have been read.
+        if ( _image->relocation_directory( )->is_valid( ) )
+            return;
+
+        spdlog::info( "Reconstructing relocation directory: \".vreloc\"" );
+
+        // The snapshot of a streamed image is a live view, so it is dropped before the new directory is appended.
+        const auto pointers = analysis::scan_pointers( _image->snapshot( ), cross_references( ) );
+
+        spdlog::debug( "Found {} pointers into the image", pointers.size( ) );
+
+        if ( pointers.empty( ) )
+            return;
+
+        auto& relocation_directory = _image->relocation_directory( );
+
+        relocation_directory->clear( );
+
+        const auto type = pe::dispatch( _image->arch( ), []< typename Arch >( Arch ) { return Arch::pointer_relocation; } );
+
+        for ( const auto rva : pointers )
+            relocation_directory->add( rva, type );
+
+        relocation_directory->recompile( _image.get( ), ".vreloc" );
+
+        // The image can be relocated again.
+        _image->nt_headers( )->FileHeader.Characteristics &= ~pe::FILE_RELOCS_STRIPPED;
+
+        _image->release( );
+    }
+
+    void dumper::save_xref_database( )
     {
-        const auto& handle =
-            wincpp::core::handle_t::create( CreateFileA( path.data( ), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr ) );
+        std::vector< analysis::xref_import_t > imports;
+
+        for ( const auto& import : _image->import_directory( )->imports( ) )
+        {
+            const auto slot = static_cast< std::uint32_t >( import->iat_rva );
+
+            imports.push_back( { slot, std::format( "{}!{}", import->module_name, import->import_name ) } );
+        }
 
-        if ( handle->native == INVALID_HANDLE_VALUE )
-            throw wincpp::core::error::from_win32( GetLastError( ) );
+        const auto& xrefs = cross_references( );
 
-        const auto minidump_type = static_cast< MINIDUMP_TYPE >(
-            MiniDumpWithFullMemoryInfo | MiniDumpWithHandleData | MiniDumpWithUnloadedModules | MiniDumpWithThreadInfo | MiniDumpWithModuleHeaders );
+        if ( !analysis::save_xref_database( _options.xref_path( ), xrefs.xrefs( ), imports ) )
+        {
+            spdlog::error( "Failed to write cross reference database \"{}\"", _options.xref_path( ) );
+            return;
+        }
 
-        if ( !MiniDumpWriteDump( process->handle->native, process->id( ), handle->native, minidump_type, nullptr, nullptr, nullptr ) )
-            throw wincpp::core::error::from_win32( GetLastError( ) );
+        spdlog::info( "Saved {} cross references to \"{}\"", xrefs.size( ), _options.xref_path( ) );
     }
 
-    dumper::options::options( ) noexcept : _module_name( ), _target_decryption_factor( 1.0f ), _resolve_imports( false )
+    dumper::options::options( ) noexcept
+        : _module_name( ),
+          _target_decryption_factor( 1.0f ),
+          _resolve_imports( false ),
+          _rebuild_relocations( false )
     {
     }
 
@@ -431,6 +1160,28 @@ namespace vulkan
         return *this;
     }
 
+    double dumper::options::min_gain_rate( ) const noexcept
+    {
+        return _min_gain_rate;
+    }
+
+    dumper::options& dumper::options::min_gain_rate( double rate ) noexcept
+    {
+        _min_gain_rate = rate;
+        return *this;
+    }
+
+    std::chrono::duration< double > dumper::options::deadline( ) const noexcept
+    {
+        return _deadline;
+    }
+
+    dumper::options& dumper::options::deadline( std::chrono::duration< double > value ) noexcept
+    {
+        _deadline = value;
+        return *this;
+    }
+
     bool dumper::options::resolve_imports( ) const noexcept
     {
         return _resolve_imports;
@@ -442,6 +1193,17 @@ namespace vulkan
         return *this;
     }
 
+    bool dumper::options::rebuild_relocations( ) const noexcept
+    {
+        return _rebuild_relocations;
+    }
+
+    dumper::options& dumper::options::rebuild_relocations( bool value ) noexcept
+    {
+        _rebuild_relocations = value;
+        return *this;
+    }
+
     std::list< std::string >& dumper::options::ignore_sections( ) noexcept
     {
         return _ignore_sections;
@@ -473,4 +1235,114 @@ namespace vulkan
         _minidump_path = std::string( path );
         return *this;
     }
+
+    std::string_view dumper::options::coverage_path( ) const noexcept
+    {
+        return _coverage_path;
+    }
+
+    dumper::options& dumper::options::coverage_path( std::string_view path ) noexcept
+    {
+        _coverage_path = std::string( path );
+        return *this;
+    }
+
+    std::string_view dumper::options::stream_path( ) const noexcept
+    {
+        return _stream_path;
+    }
+
+    dumper::options& dumper::options::stream_path( std::string_view path ) noexcept
+    {
+        _stream_path = std::string( path );
+        return *this;
+    }
+
+    std::size_t dumper::options::memory_budget( ) const noexcept
+    {
+        return _memory_budget;
+    }
+
+    dumper::options& dumper::options::memory_budget( std::size_t bytes ) noexcept
+    {
+        _memory_budget = bytes;
+        return *this;
+    }
+
+    const std::function< void( const progress_t& ) >& dumper::options::progress( ) const noexcept
+    {
+        return _progress;
+    }
+
+    dumper::options& dumper::options::progress( std::function< void( const progress_t& ) > callback ) noexcept
+    {
+        _progress = std::move( callback );
+        return *this;
+    }
+
+    const std::shared_ptr< sources::export_cache >& dumper::options::export_cache( ) const noexcept
+    {
+        return _export_cache;
+    }
+
+    dumper::options& dumper::options::export_cache( std::shared_ptr< sources::export_cache > cache ) noexcept
+    {
+        _export_cache = std::move( cache );
+        return *this;
+    }
+
+    const targets_t& dumper::options::targets( ) const noexcept
+    {
+        return _targets;
+    }
+
+    dumper::options& dumper::options::targets( targets_t value ) noexcept
+    {
+        _targets = std::move( value );
+        return *this;
+    }
+
+    std::chrono::duration< double > dumper::options::watch_interval( ) const noexcept
+    {
+        return _watch_interval;
+    }
+
+    dumper::options& dumper::options::watch_interval( std::chrono::duration< double > value ) noexcept
+    {
+        _watch_interval = value;
+        return *this;
+    }
+
+    std::string_view dumper::options::watch_path( ) const noexcept
+    {
+        return _watch_path;
+    }
+
+    dumper::options& dumper::options::watch_path( std::string_view path ) noexcept
+    {
+        _watch_path = std::string( path );
+        return *this;
+    }
+
+    std::string_view dumper::options::xref_path( ) const noexcept
+    {
+        return _xref_path;
+    }
+
+    dumper::options& dumper::options::xref_path( std::string_view path ) noexcept
+    {
+        _xref_path = std::string( path );
+        return *this;
+    }
+
+    const std::shared_ptr< store::result_store >& dumper::options::result_store( ) const noexcept
+    {
+        return _result_store;
+    }
+
+    dumper::options& dumper::options::result_store( std::shared_ptr< store::result_store > value ) noexcept
+    {
+        _result_store = std::move( value );
+        return *this;
+    }
 }  // namespace vulkan
\ No newline at end of file
@@ -0,0 +1,134 @@
+#include "io/mapped_file.hpp"
+
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace vulkan::io
+{
+    mapped_file::mapped_file( std::string_view path ) noexcept
+    {
+        const std::string filepath( path );
+
+#ifdef _WIN32
+        _file = CreateFileA( filepath.c_str( ), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+
+        if ( _file == INVALID_HANDLE_VALUE )
+        {
+            _file = nullptr;
+            return;
+        }
+
+        LARGE_INTEGER size = { };
+
+        if ( !GetFileSizeEx( _file, &size ) || !size.QuadPart )
+        {
+            close( );
+            return;
+        }
+
+        _mapping = CreateFileMappingA( _file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+
+        if ( !_mapping )
+        {
+            close( );
+            return;
+        }
+
+        _data = static_cast< const std::uint8_t* >( MapViewOfFile( _mapping, FILE_MAP_READ, 0, 0, 0 ) );
+        _size = static_cast< std::size_t >( size.QuadPart );
+#else
+        _fd = ::open( filepath.c_str( ), O_RDONLY );
+
+        if ( _fd < 0 )
+            return;
+
+        struct stat st = { };
+
+        if ( ::fstat( _fd, &st ) != 0 || st.st_size <= 0 )
+        {
+            close( );
+            return;
+        }
+
+        const auto data = ::mmap( nullptr, static_cast< std::size_t >( st.st_size ), PROT_READ, MAP_PRIVATE, _fd, 0 );
+
+        if ( data == MAP_FAILED )
+        {
+            close( );
+            return;
+        }
+
+        _data = static_cast< const std::uint8_t* >( data );
+        _size = static_cast< std::size_t >( st.st_size );
+#endif
+
+        if ( !_data )
+            close( );
+    }
+
+    mapped_file::mapped_file( mapped_file&& other ) noexcept
+    {
+        *this = std::move( other );
+    }
+
+    mapped_file& mapped_file::operator=( mapped_file&& other ) noexcept
+    {
+        if ( this == &other )
+            return *this;
+
+        close( );
+
+        _data = std::exchange( other._data, nullptr );
+        _size = std::exchange( other._size, 0 );
+
+#ifdef _WIN32
+        _file = std::exchange( other._file, nullptr );
+        _mapping = std::exchange( other._mapping, nullptr );
+#else
+        _fd = std::exchange( other._fd, -1 );
+#endif
+
+        return *this;
+    }
+
+    mapped_file::~mapped_file( )
+    {
+        close( );
+    }
+
+    void mapped_file::close( ) noexcept
+    {
+#ifdef _WIN32
+        if ( _data )
+            UnmapViewOfFile( _data );
+
+        if ( _mapping )
+            CloseHandle( _mapping );
+
+        if ( _file )
+            CloseHandle( _file );
+
+        _file = _mapping = nullptr;
+#else
+        if ( _data )
+            ::munmap( const_cast< std::uint8_t* >( _data ), _size );
+
+        if ( _fd >= 0 )
+            ::close( _fd );
+
+        _fd = -1;
+#endif
+
+        _data = nullptr;
+        _size = 0;
+    }
+}  // namespace vulkan::io
\ No newline at end of file
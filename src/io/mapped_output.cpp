@@ -0,0 +1,187 @@
+#include "io/mapped_output.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace vulkan::io
+{
+    mapped_output::mapped_output( std::string_view path, std::size_t size, bool truncate ) noexcept : _path( path )
+    {
+        if ( !size )
+            return;
+
+#ifdef _WIN32
+        _file = CreateFileA(
+            _path.c_str( ),
+            GENERIC_READ | GENERIC_WRITE,
+            FILE_SHARE_READ | FILE_SHARE_WRITE,
+            nullptr,
+            truncate ? CREATE_ALWAYS : OPEN_ALWAYS,
+            FILE_ATTRIBUTE_NORMAL,
+            nullptr );
+
+        if ( _file == INVALID_HANDLE_VALUE )
+        {
+            _file = nullptr;
+            return;
+        }
+
+        // Mapping more than the size of the file extends it, which also works while other views of the file are open. File mappings
+        // cannot be backed by large pages, so there is no hint to give.
+        const auto size64 = static_cast< std::uint64_t >( size );
+
+        _mapping = CreateFileMappingA(
+            _file, nullptr, PAGE_READWRITE, static_cast< DWORD >( size64 >> 32 ), static_cast< DWORD >( size64 & 0xFFFFFFFF ), nullptr );
+
+        if ( !_mapping )
+        {
+            close( );
+            return;
+        }
+
+        _data = static_cast< std::uint8_t* >( MapViewOfFile( _mapping, FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, size ) );
+        _size = size;
+#else
+        _fd = ::open( _path.c_str( ), O_RDWR | O_CREAT | ( truncate ? O_TRUNC : 0 ), 0644 );
+
+        if ( _fd < 0 )
+            return;
+
+        struct stat st = { };
+
+        // Only ever grow the file, since other mappings of it may still be in use.
+        if ( ::fstat( _fd, &st ) != 0 ||
+             ( static_cast< std::size_t >( st.st_size ) < size && ::ftruncate( _fd, static_cast< off_t >( size ) ) != 0 ) )
+        {
+            close( );
+            return;
+        }
+
+        const auto data = ::mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0 );
+
+        if ( data == MAP_FAILED )
+        {
+            close( );
+            return;
+        }
+
+#ifdef MADV_HUGEPAGE
+        // Only a hint; file systems that cannot back the file with huge pages ignore it.
+        ::madvise( data, size, MADV_HUGEPAGE );
+#endif
+
+        _data = static_cast< std::uint8_t* >( data );
+        _size = size;
+#endif
+
+        if ( !_data )
+            close( );
+    }
+
+    mapped_output::mapped_output( mapped_output&& other ) noexcept
+    {
+        *this = std::move( other );
+    }
+
+    mapped_output& mapped_output::operator=( mapped_output&& other ) noexcept
+    {
+        if ( this == &other )
+            return *this;
+
+        close( );
+
+        _data = std::exchange( other._data, nullptr );
+        _size = std::exchange( other._size, 0 );
+        _path = std::move( other._path );
+
+#ifdef _WIN32
+        _file = std::exchange( other._file, nullptr );
+        _mapping = std::exchange( other._mapping, nullptr );
+#else
+        _fd = std::exchange( other._fd, -1 );
+#endif
+
+        return *this;
+    }
+
+    mapped_output::~mapped_output( )
+    {
+        close( );
+    }
+
+    bool mapped_output::flush( std::size_t offset, std::size_t size ) const noexcept
+    {
+        if ( !_data || offset >= _size )
+            return false;
+
+        size = std::min( size, _size - offset );
+
+#ifdef _WIN32
+        return FlushViewOfFile( _data + offset, size ) && FlushFileBuffers( _file );
+#else
+        const auto page_size = static_cast< std::size_t >( ::sysconf( _SC_PAGESIZE ) );
+        const auto begin = offset / page_size * page_size;
+
+        return ::msync( _data + begin, offset + size - begin, MS_SYNC ) == 0;
+#endif
+    }
+
+    void mapped_output::release( std::size_t offset, std::size_t size ) const noexcept
+    {
+        if ( !_data || offset >= _size )
+            return;
+
+        size = std::min( size, _size - offset );
+
+#ifdef _WIN32
+        FlushViewOfFile( _data + offset, size );
+
+        // Unlocking pages that are not locked removes them from the working set.
+        VirtualUnlock( _data + offset, size );
+#else
+        const auto page_size = static_cast< std::size_t >( ::sysconf( _SC_PAGESIZE ) );
+        const auto begin = offset / page_size * page_size;
+
+        ::msync( _data + begin, offset + size - begin, MS_ASYNC );
+
+        // The mapping is shared, so dropping the pages does not discard their contents.
+        ::madvise( _data + begin, offset + size - begin, MADV_DONTNEED );
+#endif
+    }
+
+    void mapped_output::close( ) noexcept
+    {
+#ifdef _WIN32
+        if ( _data )
+            UnmapViewOfFile( _data );
+
+        if ( _mapping )
+            CloseHandle( _mapping );
+
+        if ( _file )
+            CloseHandle( _file );
+
+        _file = _mapping = nullptr;
+#else
+        if ( _data )
+            ::munmap( _data, _size );
+
+        if ( _fd >= 0 )
+            ::close( _fd );
+
+        _fd = -1;
+#endif
+
+        _data = nullptr;
+        _size = 0;
+    }
+}  // namespace vulkan::io
\ No newline at end of file
@@ -0,0 +1,145 @@
+#include "jobs/job_host.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <atomic>
+
+namespace vulkan::jobs
+{
+    /// <summary>
+    /// The state of a job, shared by its handles and the host.
+    /// </summary>
+    struct job::state_t
+    {
+        request_t request;
+        std::stop_source stop;
+        std::promise< std::shared_ptr< pe::image > > promise;
+        std::shared_future< std::shared_ptr< pe::image > > result = promise.get_future( ).share( );
+        std::atomic< status_t > status = status_t::queued;
+    };
+
+    job::job( std::shared_ptr< state_t > state ) noexcept : _state( std::move( state ) )
+    {
+    }
+
+    status_t job::status( ) const noexcept
+    {
+        return _state->status;
+    }
+
+    void job::cancel( ) noexcept
+    {
+        _state->stop.request_stop( );
+    }
+
+    std::shared_future< std::shared_ptr< pe::image > > job::result( ) const noexcept
+    {
+        return _state->result;
+    }
+
+    job_host::job_host( std::size_t workers ) : _exports( std::make_shared< sources::export_cache >( ) )
+    {
+        if ( !workers )
+            workers = std::max( 1u, std::thread::hardware_concurrency( ) );
+
+        _workers.reserve( workers );
+
+        for ( std::size_t i = 0; i < workers; ++i )
+            _workers.emplace_back( [ this ]( std::stop_token stop_token ) { work( stop_token ); } );
+    }
+
+    job_host::~job_host( )
+    {
+        // Stopping a worker also cancels the job it is running.
+        for ( auto& worker : _workers )
+            worker.request_stop( );
+
+        _workers.clear( );
+
+        for ( const auto& state : _queue )
+        {
+            state->status = status_t::cancelled;
+            state->promise.set_value( nullptr );
+        }
+    }
+
+    void job_host::work( std::stop_token stop_token )
+    {
+        while ( true )
+        {
+            std::shared_ptr< job::state_t > state;
+
+            {
+                std::unique_lock lock( _mutex );
+
+                if ( !_ready.wait( lock, stop_token, [ this ]( ) { return !_queue.empty( ); } ) )
+                    return;
+
+                state = std::move( _queue.front( ) );
+                _queue.pop_front( );
+            }
+
+            run( *state, stop_token );
+        }
+    }
+
+    void job_host::run( job::state_t& state, std::stop_token stop_token )
+    {
+        if ( state.stop.stop_requested( ) )
+        {
+            state.status = status_t::cancelled;
+            state.promise.set_value( nullptr );
+            return;
+        }
+
+        state.status = status_t::running;
+
+        const std::stop_callback forward( stop_token, [ &state ]( ) { state.stop.request_stop( ); } );
+
+        try
+        {
+            auto options = state.request.options;
+
+            if ( !options.export_cache( ) )
+                options.export_cache( _exports );
+
+            std::shared_ptr< pe::image > image = dumper::dump( *state.request.source, options, state.stop.get_token( ) );
+
+            // Let go of the source as soon as possible, since it may hold a process handle or a mapped capture.
+            state.request.source.reset( );
+
+            state.status = state.stop.stop_requested( ) ? status_t::cancelled : status_t::finished;
+            state.promise.set_value( std::move( image ) );
+        }
+        catch ( const std::exception& ex )
+        {
+            spdlog::error( "Failed to dump \"{}\": {}", state.request.options.module_name( ), ex.what( ) );
+
+            state.request.source.reset( );
+
+            state.status = status_t::failed;
+            state.promise.set_exception( std::current_exception( ) );
+        }
+    }
+
+    job job_host::submit( request_t request )
+    {
+        auto state = std::make_shared< job::state_t >( );
+        state->request = std::move( request );
+
+        {
+            std::lock_guard lock( _mutex );
+            _queue.push_back( state );
+        }
+
+        _ready.notify_one( );
+
+        return job( std::move( state ) );
+    }
+
+    const std::shared_ptr< sources::export_cache >& job_host::exports( ) const noexcept
+    {
+        return _exports;
+    }
+}  // namespace vulkan::jobs
\ No newline at end of file
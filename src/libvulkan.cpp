@@ -0,0 +1,249 @@
+#include "libvulkan.h"
+
+#include <spdlog/spdlog.h>
+
+#include <chrono>
+#include <string>
+
+#include "jobs/job_host.hpp"
+#include "sources/minidump_source.hpp"
+#include "sources/process_source.hpp"
+
+static_assert( static_cast< int >( vulkan::jobs::status_t::queued ) == VULKAN_STATUS_QUEUED );
+static_assert( static_cast< int >( vulkan::jobs::status_t::failed ) == VULKAN_STATUS_FAILED );
+
+struct vulkan_host
+{
+    vulkan::jobs::job_host host;
+
+    explicit vulkan_host( std::size_t workers ) : host( workers )
+    {
+    }
+};
+
+struct vulkan_job
+{
+    vulkan::jobs::job job;
+
+    /// <summary>
+    /// The message of the exception the job failed with. Filled in on the first request.
+    /// </summary>
+    std::string error;
+};
+
+namespace
+{
+    /// <summary>
+    /// A live process, together with the source that reads it.
+    /// </summary>
+    struct process_holder_t
+    {
+        std::unique_ptr< wincpp::process_t > process;
+        vulkan::sources::process_source source;
+
+        explicit process_holder_t( std::unique_ptr< wincpp::process_t > p ) : process( std::move( p ) ), source( *process )
+        {
+        }
+    };
+
+    /// <summary>
+    /// Converts the options of the C interface.
+    /// </summary>
+    vulkan::dumper::options
+    to_options( const vulkan_dump_options* options, std::string_view main_module, vulkan_progress_callback progress, void* user )
+    {
+        vulkan_dump_options defaults;
+
+        if ( !options )
+        {
+            vulkan_dump_options_init( &defaults );
+            options = &defaults;
+        }
+
+        auto result = vulkan::dumper::options::default_value( );
+
+        result.module_name( options->module_name ? std::string_view( options->module_name ) : main_module );
+        result.target_decryption_factor( options->decryption_factor );
+        result.min_gain_rate( options->min_gain_rate );
+        result.deadline( std::chrono::duration< double >( options->deadline ) );
+        result.resolve_imports( options->resolve_imports );
+        result.rebuild_relocations( options->rebuild_relocations );
+
+        if ( options->image_base )
+            result.image_base( static_cast< std::uintptr_t >( options->image_base ) );
+
+        if ( options->stream_path )
+        {
+            result.stream_path( options->stream_path );
+            result.memory_budget( static_cast< std::size_t >( options->memory_budget ) );
+        }
+
+        if ( progress )
+        {
+            result.progress(
+                [ progress, user ]( const vulkan::progress_t& p )
+                {
+                    const std::string pass( p.pass ), section( p.section );
+
+                    progress( pass.c_str( ), section.c_str( ), p.pages_read, p.total_pages, user );
+                } );
+        }
+
+        return result;
+    }
+
+    /// <summary>
+    /// Submits a request and wraps the job for the C interface.
+    /// </summary>
+    vulkan_job* submit( vulkan_host* host, vulkan::jobs::request_t request )
+    {
+        return new vulkan_job{ host->host.submit( std::move( request ) ), { } };
+    }
+}  // namespace
+
+void vulkan_dump_options_init( vulkan_dump_options* options )
+{
+    const auto defaults = vulkan::dumper::options::default_value( );
+
+    *options = { nullptr,
+                 defaults.target_decryption_factor( ),
+                 defaults.min_gain_rate( ),
+                 defaults.deadline( ).count( ),
+                 defaults.resolve_imports( ),
+                 defaults.rebuild_relocations( ),
+                 0,
+                 nullptr,
+                 defaults.memory_budget( ) };
+}
+
+vulkan_host* vulkan_host_create( uint32_t workers )
+{
+    try
+    {
+        return new vulkan_host( workers );
+    }
+    catch ( const std::exception& ex )
+    {
+        spdlog::error( "Failed to create the job host: {}", ex.what( ) );
+        return nullptr;
+    }
+}
+
+void vulkan_host_destroy( vulkan_host* host )
+{
+    delete host;
+}
+
+vulkan_job* vulkan_dump_process(
+    vulkan_host* host,
+    const char* process_name,
+    const vulkan_dump_options* options,
+    vulkan_progress_callback progress,
+    void* user )
+{
+    try
+    {
+        auto process = wincpp::process_t::open( process_name );
+
+        if ( !process )
+        {
+            spdlog::error( "Failed to open process \"{}\"", process_name );
+            return nullptr;
+        }
+
+        const auto name = process->name( );
+        const auto holder = std::make_shared< process_holder_t >( std::move( process ) );
+
+        // The source shares the ownership of the process it reads.
+        return submit(
+            host, { std::shared_ptr< const vulkan::sources::source >( holder, &holder->source ), to_options( options, name, progress, user ) } );
+    }
+    catch ( const std::exception& ex )
+    {
+        spdlog::error( "Failed to submit a dump of \"{}\": {}", process_name, ex.what( ) );
+        return nullptr;
+    }
+}
+
+vulkan_job* vulkan_dump_minidump( vulkan_host* host, const char* path, const vulkan_dump_options* options, vulkan_progress_callback progress, void* user )
+{
+    try
+    {
+        auto minidump = std::make_shared< vulkan::sources::minidump_source >( path );
+
+        if ( !minidump->is_valid( ) || minidump->modules( ).empty( ) )
+        {
+            spdlog::error( "Failed to read minidump \"{}\"", path );
+            return nullptr;
+        }
+
+        // The main module is the first module in the list.
+        const auto name = minidump->modules( ).front( ).name;
+
+        return submit( host, { std::move( minidump ), to_options( options, name, progress, user ) } );
+    }
+    catch ( const std::exception& ex )
+    {
+        spdlog::error( "Failed to submit a dump of \"{}\": {}", path, ex.what( ) );
+        return nullptr;
+    }
+}
+
+vulkan_status vulkan_job_status( const vulkan_job* job )
+{
+    return static_cast< vulkan_status >( job->job.status( ) );
+}
+
+void vulkan_job_cancel( vulkan_job* job )
+{
+    job->job.cancel( );
+}
+
+vulkan_status vulkan_job_wait( vulkan_job* job, uint32_t timeout )
+{
+    const auto& result = job->job.result( );
+
+    if ( timeout == VULKAN_INFINITE )
+        result.wait( );
+    else
+        result.wait_for( std::chrono::milliseconds( timeout ) );
+
+    return vulkan_job_status( job );
+}
+
+int32_t vulkan_job_save( vulkan_job* job, const char* path )
+{
+    const auto& result = job->job.result( );
+
+    if ( job->job.status( ) != vulkan::jobs::status_t::finished && job->job.status( ) != vulkan::jobs::status_t::cancelled )
+        return 0;
+
+    const auto& image = result.get( );
+
+    return image && image->save_to_file( path );
+}
+
+const char* vulkan_job_error( vulkan_job* job )
+{
+    if ( job->job.status( ) != vulkan::jobs::status_t::failed )
+        return nullptr;
+
+    if ( job->error.empty( ) )
+    {
+        try
+        {
+            job->job.result( ).get( );
+        }
+        catch ( const std::exception& ex )
+        {
+            job->error = ex.what( );
+        }
+    }
+
+    return job->error.c_str( );
+}
+
+void vulkan_job_release( vulkan_job* job )
+{
+    delete job;
+}
\ No newline at end of file
@@ -1,9 +1,38 @@
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <csignal>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#include "analysis/page_classifier.hpp"
 #include "argparse/argparse.hpp"
+#include "batch/manifest.hpp"
+#include "batch/work_pool.hpp"
+#include "carve/carver.hpp"
+#include "diff/image_diff.hpp"
 #include "dumper.hpp"
+#include "io/mapped_file.hpp"
+#include "merge/merger.hpp"
+#include "sources/carved_source.hpp"
+#include "sources/minidump_source.hpp"
+#include "sources/recording_source.hpp"
+#include "sources/replay_source.hpp"
+#include "sources/snapshot_source.hpp"
 #include "spdlog/spdlog.h"
 
+#ifdef _WIN32
+#include "sources/process_source.hpp"
+#endif
+
 std::stop_source stop_source;
 
+#ifdef _WIN32
 /// <summary>
 /// The console control handler. Used to terminate the application when CTRL+C or CTRL+BREAK is pressed.
 /// </summary>
@@ -17,6 +46,619 @@ static BOOL WINAPI console_ctrl_handler( DWORD ctrl_type )
 
     return FALSE;
 }
+#else
+/// <summary>
+/// Set when SIGINT or SIGTERM is received. Requesting a stop runs the stop callbacks, which is not safe in a signal handler, so the
+/// flag is picked up by a thread instead.
+/// </summary>
+static volatile std::sig_atomic_t interrupted = 0;
+
+/// <summary>
+/// The signal handler. Used to terminate the application when CTRL+C is pressed.
+/// </summary>
+static void signal_handler( std::int32_t )
+{
+    interrupted = 1;
+}
+#endif
+
+/// <summary>
+/// Parses a hexadecimal 32-bit number, with or without a `0x` prefix.
+/// </summary>
+static std::optional< std::uint32_t > parse_hex( std::string_view value )
+{
+    if ( value.starts_with( "0x" ) || value.starts_with( "0X" ) )
+        value.remove_prefix( 2 );
+
+    std::uint32_t result = 0;
+    const auto [ end, error ] = std::from_chars( value.data( ), value.data( ) + value.size( ), result, 16 );
+
+    if ( value.empty( ) || error != std::errc( ) || end != value.data( ) + value.size( ) )
+        return std::nullopt;
+
+    return result;
+}
+
+/// <summary>
+/// Parses a decimal number.
+/// </summary>
+static std::optional< double > parse_number( std::string_view value )
+{
+    double result = 0.0;
+    const auto [ end, error ] = std::from_chars( value.data( ), value.data( ) + value.size( ), result );
+
+    if ( value.empty( ) || error != std::errc( ) || end != value.data( ) + value.size( ) )
+        return std::nullopt;
+
+    return result;
+}
+
+/// <summary>
+/// Runs the `merge` command, which combines partial dumps of the same module into one image.
+/// </summary>
+static std::int32_t merge_dumps( const argparse::ArgumentParser& command )
+{
+    const auto& inputs = command.get< std::vector< std::string > >( "inputs" );
+    const auto& output = command.get< std::string >( "output" );
+
+    vulkan::merge::merger merger;
+
+    for ( const auto& input : inputs )
+    {
+        if ( !merger.add( input ) )
+            return 1;
+    }
+
+    const auto& result = merger.merge( );
+
+    if ( !result )
+    {
+        spdlog::error( "Failed to merge the dumps" );
+        return 1;
+    }
+
+    for ( std::size_t i = 0; i < inputs.size( ); ++i )
+        spdlog::debug( "Took {} pages from \"{}\"", result->contributions[ i ], inputs[ i ] );
+
+    for ( const auto& conflict : result->conflicts )
+        spdlog::warn(
+            "Dumps disagree on the page @ 0x{:X}, taking it from \"{}\" ({} dissenting)", conflict.rva, inputs[ conflict.chosen ], conflict.dissenting );
+
+    spdlog::info(
+        "Merged {} dumps: {}/{} code pages recovered, {} conflicts", inputs.size( ), result->merged_pages, result->total_pages, result->conflicts.size( ) );
+
+    spdlog::info( "Saving merged image to \"{}\"", output );
+
+    if ( !result->image->save_to_file( output ) )
+    {
+        spdlog::error( "Failed to save \"{}\"", output );
+        return 1;
+    }
+
+    if ( const auto& path = command.present< std::string >( "coverage-map" ) )
+    {
+        if ( !vulkan::analysis::save_coverage_map( path.value( ), vulkan::analysis::classify_pages( result->image->snapshot( ) ) ) )
+        {
+            spdlog::error( "Failed to write coverage map \"{}\"", path.value( ) );
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/// <summary>
+/// Runs the `diff` command, which compares two dumps of a module and reports the changed sections, pages and functions.
+/// </summary>
+static std::int32_t diff_dumps( const argparse::ArgumentParser& command )
+{
+    const auto load = []( const std::string& path ) -> std::optional< vulkan::pe::image_view >
+    {
+        const vulkan::io::mapped_file file( path );
+
+        if ( !file.is_valid( ) )
+            return std::nullopt;
+
+        vulkan::pe::image_view image( std::vector< std::uint8_t >( file.data( ).begin( ), file.data( ).end( ) ) );
+
+        if ( !image.is_valid( ) )
+            return std::nullopt;
+
+        return image;
+    };
+
+    const auto& old_image = load( command.get< std::string >( "old" ) );
+
+    if ( !old_image )
+    {
+        spdlog::error( "Failed to read \"{}\"", command.get< std::string >( "old" ) );
+        return 1;
+    }
+
+    const auto& new_image = load( command.get< std::string >( "new" ) );
+
+    if ( !new_image )
+    {
+        spdlog::error( "Failed to read \"{}\"", command.get< std::string >( "new" ) );
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now( );
+    const auto& report = vulkan::diff::compare( *old_image, *new_image );
+
+    spdlog::info(
+        "Found {} changed ranges in {} functions in {:.3f} s",
+        report.ranges.size( ),
+        report.functions.size( ),
+        std::chrono::duration< double >( std::chrono::steady_clock::now( ) - start ).count( ) );
+
+    if ( const auto& path = command.present< std::string >( "output" ) )
+    {
+        std::ofstream file( path.value( ) );
+
+        if ( !file.is_open( ) )
+        {
+            spdlog::error( "Failed to create \"{}\"", path.value( ) );
+            return 1;
+        }
+
+        vulkan::diff::write_report( file, report );
+    }
+    else
+        vulkan::diff::write_report( std::cout, report );
+
+    return 0;
+}
+
+/// <summary>
+/// Runs the `carve` command, which finds every mapped image in a minidump or raw memory snapshot and rebuilds each of them.
+/// </summary>
+static std::int32_t carve_images( const argparse::ArgumentParser& command )
+{
+    const auto& input = command.get< std::string >( "input" );
+
+    std::unique_ptr< vulkan::sources::source > source = nullptr;
+
+    if ( const auto& base = command.present< std::uintptr_t >( "snapshot-base" ) )
+    {
+        auto snapshot = std::make_unique< vulkan::sources::snapshot_source >(
+            input, std::filesystem::path( input ).filename( ).string( ), base.value( ) );
+
+        if ( snapshot->is_valid( ) )
+            source = std::move( snapshot );
+    }
+    else
+    {
+        auto minidump = std::make_unique< vulkan::sources::minidump_source >( input );
+
+        if ( minidump->is_valid( ) )
+            source = std::move( minidump );
+    }
+
+    if ( !source )
+    {
+        spdlog::error( "Failed to read \"{}\"", input );
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now( );
+    const auto extents = source->extents( );
+    const auto images = vulkan::carve::carve( extents, stop_source.get_token( ) );
+    const auto listed = source->modules( );
+
+    std::vector< vulkan::sources::module_t > modules;
+
+    for ( const auto& image : images )
+    {
+        const auto module =
+            std::find_if( listed.begin( ), listed.end( ), [ & ]( const vulkan::sources::module_t& m ) { return m.address == image.address; } );
+
+        const auto name = module != listed.end( )
+                              ? module->name
+                              : std::format( "carved_{:X}.{}", image.address, image.characteristics & vulkan::pe::FILE_DLL ? "dll" : "exe" );
+
+        spdlog::info( "Found {} @ 0x{:X} - {} bytes{}", name, image.address, image.size, module != listed.end( ) ? "" : " (not in the module list)" );
+
+        if ( image.size < image.declared_size )
+            spdlog::warn( "Only 0x{:X} of the 0x{:X} bytes of {} were captured", image.size, image.declared_size, name );
+
+        if ( module != listed.end( ) )
+            modules.push_back( { name, module->path, image.address, image.size, module->time_date_stamp, module->checksum } );
+        else
+            modules.push_back( { name, std::string( ), image.address, image.size, 0, 0 } );
+    }
+
+    spdlog::info(
+        "Carved {} images from {} ranges in {:.3f} s",
+        images.size( ),
+        extents.size( ),
+        std::chrono::duration< double >( std::chrono::steady_clock::now( ) - start ).count( ) );
+
+    if ( command.get< bool >( "list" ) )
+        return 0;
+
+    const vulkan::sources::carved_source carved( *source, modules );
+    const std::filesystem::path directory( command.get< std::string >( "output" ) );
+
+    std::filesystem::create_directories( directory );
+
+    std::int32_t failed = 0;
+
+    for ( const auto& module : modules )
+    {
+        if ( stop_source.stop_requested( ) )
+            break;
+
+        auto opts = vulkan::dumper::options::default_value( );
+        opts.module_name( module.name );
+
+        try
+        {
+            const auto& image = vulkan::dumper::dump( carved, opts, stop_source.get_token( ) );
+            const auto output = ( directory / module.name ).string( );
+
+            spdlog::info( "Dumping module: \"{}\" to \"{}\"", module.name, output );
+
+            if ( !image->save_to_file( output ) )
+                throw std::runtime_error( std::format( "failed to save \"{}\"", output ) );
+        }
+        catch ( const std::exception& ex )
+        {
+            spdlog::error( "Failed to rebuild {}: {}", module.name, ex.what( ) );
+            ++failed;
+        }
+    }
+
+    return failed ? 1 : 0;
+}
+
+/// <summary>
+/// Opens the source of an input of the `batch` command, and picks the module to dump from it.
+/// </summary>
+static std::unique_ptr< vulkan::sources::source > open_input( const vulkan::batch::input_t& input, std::string& module_name )
+{
+    module_name = input.module_name;
+
+    if ( input.base )
+    {
+        if ( module_name.empty( ) )
+            module_name = input.path.filename( ).string( );
+
+        auto snapshot = std::make_unique< vulkan::sources::snapshot_source >( input.path.string( ), module_name, input.base.value( ) );
+
+        return snapshot->is_valid( ) ? std::move( snapshot ) : nullptr;
+    }
+
+    auto minidump = std::make_unique< vulkan::sources::minidump_source >( input.path.string( ) );
+
+    if ( !minidump->is_valid( ) || minidump->modules( ).empty( ) )
+        return nullptr;
+
+    // The main module is the first module in the list.
+    if ( module_name.empty( ) )
+        module_name = minidump->modules( ).front( ).name;
+
+    return minidump;
+}
+
+/// <summary>
+/// Runs the `batch` command, which rebuilds the modules of many minidumps and raw memory snapshots at once.
+/// </summary>
+static std::int32_t batch_dumps( const argparse::ArgumentParser& command )
+{
+    const std::filesystem::path path( command.get< std::string >( "input" ) );
+    const auto& inputs = vulkan::batch::read_inputs( path );
+
+    if ( !inputs )
+    {
+        spdlog::error( "Failed to read the inputs from \"{}\"", path.string( ) );
+        return 1;
+    }
+
+    const std::filesystem::path directory( command.get< std::string >( "output" ) );
+
+    std::filesystem::create_directories( directory );
+
+    vulkan::batch::result_log log( directory / "results.tsv" );
+
+    if ( !log.is_valid( ) )
+    {
+        spdlog::error( "Failed to open the results manifest in \"{}\"", directory.string( ) );
+        return 1;
+    }
+
+    auto opts = vulkan::dumper::options::default_value( );
+
+    opts.resolve_imports( command.get< bool >( "resolve-imports" ) );
+    opts.rebuild_relocations( command.get< bool >( "rebuild-relocations" ) );
+
+    if ( const auto& rebase = command.present< std::uintptr_t >( "rebase" ) )
+        opts.image_base( rebase.value( ) );
+
+    // Inputs usually load the same builds of the system modules, so their exports are only enumerated once. Minidumps list the time
+    // stamp and checksum of every module, which tells apart other builds that ASLR happened to load at the same address.
+    opts.export_cache( std::make_shared< vulkan::sources::export_cache >( ) );
+
+    std::vector< vulkan::batch::task_t > tasks;
+    std::atomic< std::size_t > failed = 0;
+    std::size_t skipped = 0;
+
+    for ( const auto& input : inputs.value( ) )
+    {
+        const auto key = input.key( );
+
+        if ( log.is_done( key ) )
+        {
+            ++skipped;
+            continue;
+        }
+
+        std::string module_name;
+        const auto source = open_input( input, module_name );
+
+        if ( !source )
+        {
+            spdlog::error( "Failed to read \"{}\"", input.path.string( ) );
+            log.append( { key, vulkan::batch::status_t::failed, 0.0, { }, "failed to read the input" } );
+            ++failed;
+            continue;
+        }
+
+        // The image of the module is what a job holds on to, the rest of the input is mapped from disk.
+        const auto modules = source->modules( );
+        const auto module = std::ranges::find( modules, module_name, &vulkan::sources::module_t::name );
+
+        std::error_code error;
+        const auto cost = module != modules.end( ) ? module->size : std::filesystem::file_size( input.path, error );
+
+        const auto run = [ &, input, key ]( std::stop_token stop_token )
+        {
+            const auto start = std::chrono::steady_clock::now( );
+
+            vulkan::batch::result_t result = { key, vulkan::batch::status_t::failed, 0.0, { }, { } };
+
+            try
+            {
+                std::string module_name;
+                const auto source = open_input( input, module_name );
+
+                if ( !source )
+                    throw std::runtime_error( "failed to read the input" );
+
+                auto job_opts = opts;
+                job_opts.module_name( module_name );
+
+                const auto& image = vulkan::dumper::dump( *source, job_opts, stop_token );
+
+                // A stopped dump is incomplete, and is left for the next run.
+                if ( stop_token.stop_requested( ) )
+                {
+                    result.status = vulkan::batch::status_t::cancelled;
+                }
+                else
+                {
+                    const auto output = directory / input.path.stem( ) / module_name;
+
+                    std::filesystem::create_directories( output.parent_path( ) );
+
+                    if ( !image->save_to_file( output.string( ) ) )
+                        throw std::runtime_error( std::format( "failed to save \"{}\"", output.string( ) ) );
+
+                    result.status = vulkan::batch::status_t::done;
+                    result.output = output.string( );
+                }
+            }
+            catch ( const std::exception& ex )
+            {
+                result.message = ex.what( );
+            }
+
+            result.seconds = std::chrono::duration< double >( std::chrono::steady_clock::now( ) - start ).count( );
+
+            if ( result.status == vulkan::batch::status_t::done )
+                spdlog::info( "Rebuilt \"{}\" in {:.3f} s", key, result.seconds );
+            else if ( result.status == vulkan::batch::status_t::failed )
+            {
+                spdlog::error( "Failed to rebuild \"{}\": {}", key, result.message );
+                ++failed;
+            }
+
+            log.append( result );
+        };
+
+        tasks.push_back( { cost, run } );
+    }
+
+    if ( skipped )
+        spdlog::info( "Skipping {} inputs that were rebuilt by an earlier run", skipped );
+
+    vulkan::batch::work_pool pool( command.get< std::size_t >( "jobs" ), command.get< std::size_t >( "memory-budget" ) * 1024 * 1024 );
+
+    spdlog::info( "Rebuilding {} inputs on {} workers", tasks.size( ), std::min( pool.workers( ), tasks.size( ) ) );
+
+    const auto start = std::chrono::steady_clock::now( );
+
+    pool.run( tasks, stop_source.get_token( ) );
+
+    spdlog::info(
+        "Finished the batch in {:.3f} s, {} inputs failed",
+        std::chrono::duration< double >( std::chrono::steady_clock::now( ) - start ).count( ),
+        failed.load( ) );
+
+    return failed || stop_source.stop_requested( ) ? 1 : 0;
+}
+
+/// <summary>
+/// Runs the `replay` command, which replays traces through the dumper and reports how fast the code sections were covered on the
+/// virtual clock of the trace, so that acquisition strategies can be compared and regressions caught.
+/// </summary>
+static std::int32_t replay_traces( const argparse::ArgumentParser& command )
+{
+    /// <summary>
+    /// The coverages, in percent, the time to reach is reported for.
+    /// </summary>
+    constexpr std::array< double, 4 > MILESTONES = { 50.0, 90.0, 99.0, 100.0 };
+
+    /// <summary>
+    /// The coverage of a code section over the course of a replay.
+    /// </summary>
+    struct section_t
+    {
+        std::string name;
+        std::size_t total_pages = 0;
+
+        /// <summary>
+        /// The number of pages read after every sweep, and the time of the sweep.
+        /// </summary>
+        std::vector< std::pair< std::size_t, double > > timeline;
+
+        /// <summary>
+        /// Returns the time the coverage was first reached, or nothing if it never was.
+        /// </summary>
+        std::optional< double > time_to( double percent ) const
+        {
+            for ( const auto& [ pages_read, seconds ] : timeline )
+            {
+                if ( pages_read * 100.0 >= percent * total_pages )
+                    return seconds;
+            }
+
+            return std::nullopt;
+        }
+    };
+
+    // Every expectation is a coverage, in percent, that every code section must reach within a number of virtual seconds.
+    std::vector< std::pair< double, double > > expectations;
+
+    for ( const auto& value : command.get< std::list< std::string > >( "expect" ) )
+    {
+        const auto separator = value.find( ':' );
+        const auto& percent = parse_number( value.substr( 0, separator ) );
+        const auto& seconds = separator != std::string::npos ? parse_number( value.substr( separator + 1 ) ) : std::nullopt;
+
+        if ( !percent || !seconds )
+        {
+            spdlog::error( "Invalid expectation \"{}\", expected <percent>:<seconds>", value );
+            return 1;
+        }
+
+        expectations.emplace_back( percent.value( ), seconds.value( ) );
+    }
+
+    std::ofstream file;
+
+    if ( const auto& path = command.present< std::string >( "output" ) )
+    {
+        file.open( path.value( ) );
+
+        if ( !file.is_open( ) )
+        {
+            spdlog::error( "Failed to create \"{}\"", path.value( ) );
+            return 1;
+        }
+    }
+
+    auto& out = file.is_open( ) ? static_cast< std::ostream& >( file ) : std::cout;
+
+    out << "trace\tsection\tpages\ttotal\tcoverage\tseconds";
+
+    for ( const auto milestone : MILESTONES )
+        out << std::format( "\tt{}", milestone );
+
+    out << '\n';
+
+    std::int32_t result = 0;
+
+    for ( const auto& path : command.get< std::vector< std::string > >( "traces" ) )
+    {
+        if ( stop_source.stop_requested( ) )
+            break;
+
+        const vulkan::sources::replay_source source( path );
+
+        if ( !source.is_valid( ) || source.modules( ).empty( ) )
+        {
+            spdlog::error( "Failed to read trace \"{}\"", path );
+            result = 1;
+            continue;
+        }
+
+        std::vector< section_t > sections;
+        std::mutex mutex;
+
+        // Times are taken on the virtual clock of the trace, from the start of the dump.
+        const auto start = source.now( );
+
+        auto opts = vulkan::dumper::options::default_value( );
+
+        // The main module is the first module in the list.
+        opts.module_name( command.present< std::string >( "module" ).value_or( source.modules( ).front( ).name ) );
+        opts.target_decryption_factor( command.get< float >( "decryption-factor" ) );
+        opts.min_gain_rate( command.get< double >( "min-gain-rate" ) / 100.0 );
+        opts.deadline( std::chrono::duration< double >( command.get< double >( "deadline" ) ) );
+        opts.progress(
+            [ & ]( const vulkan::progress_t& progress )
+            {
+                if ( progress.pass != "sections" || progress.section.empty( ) || !progress.total_pages )
+                    return;
+
+                const auto seconds = std::chrono::duration< double >( source.now( ) - start ).count( );
+
+                std::lock_guard lock( mutex );
+
+                if ( sections.empty( ) || sections.back( ).name != progress.section )
+                    sections.push_back( { std::string( progress.section ), 0, { } } );
+
+                sections.back( ).total_pages = progress.total_pages;
+                sections.back( ).timeline.emplace_back( progress.pages_read, seconds );
+            } );
+
+        try
+        {
+            vulkan::dumper::dump( source, opts, stop_source.get_token( ) );
+        }
+        catch ( const std::exception& ex )
+        {
+            spdlog::error( "Failed to replay \"{}\": {}", path, ex.what( ) );
+            result = 1;
+            continue;
+        }
+
+        for ( const auto& section : sections )
+        {
+            const auto [ pages_read, seconds ] = section.timeline.back( );
+
+            out << std::format(
+                "{}\t{}\t{}\t{}\t{:.2f}\t{:.3f}",
+                path,
+                section.name,
+                pages_read,
+                section.total_pages,
+                pages_read * 100.0 / section.total_pages,
+                seconds );
+
+            for ( const auto milestone : MILESTONES )
+            {
+                const auto reached = section.time_to( milestone );
+
+                out << ( reached ? std::format( "\t{:.3f}", *reached ) : "\t-" );
+            }
+
+            out << '\n';
+
+            for ( const auto& [ percent, limit ] : expectations )
+            {
+                if ( const auto reached = section.time_to( percent ); !reached || *reached > limit )
+                {
+                    spdlog::error( "\"{}\" of \"{}\" did not reach {}% within {} s", section.name, path, percent, limit );
+                    result = 1;
+                }
+            }
+        }
+    }
+
+    return result;
+}
 
 std::int32_t main( std::int32_t argc, char* argv[] )
 {
@@ -29,23 +671,165 @@ std::int32_t main( std::int32_t argc, char* argv[] )
         "terminate a task with `Ctrl+C`." );
     parser.add_epilog( "for more information, visit: https://github.com/atrexus/vulkan" );
 
-    parser.add_argument( "-p", "--process" ).required( ).help( "the name of the process to dump" );
+#ifdef _WIN32
+    parser.add_argument( "-p", "--process" ).help( "the name of the process to dump" );
+#endif
+    parser.add_argument( "--from-minidump" ).help( "dump from a minidump instead of a live process" );
+    parser.add_argument( "--from-snapshot" ).help( "dump from a raw memory snapshot of the module instead of a live process" );
+    parser.add_argument( "--snapshot-base" )
+        .help( "the address the raw memory snapshot was taken at (required with --from-snapshot)" )
+        .scan< 'x', std::uintptr_t >( );
+    parser.add_argument( "--from-trace" ).help( "replay a page-arrival trace written with --record-trace instead of reading a live process" );
+    parser.add_argument( "--record-trace" ).help( "record every poll, protection change and page read into a trace file" );
     parser.add_argument( "-m", "--module" ).help( "the name of the module to dump [default: \"<main-module>\"]" );
     parser.add_argument( "-o", "--output" ).help( "the name of the output file [default: \"<module>\"]" );
     parser.add_argument( "-d", "--decryption-factor" )
         .default_value< float >( 1.0f )
         .scan< 'g', float >( )
-        .help( "the decryption factor to use when decrypting the PE" );
+        .help( "stop reading a code section once this fraction of its pages was decrypted" );
+    parser.add_argument( "--min-gain-rate" )
+        .default_value< double >( 0.0 )
+        .scan< 'g', double >( )
+        .help( "stop reading a code section once the expected coverage gain drops below this many percent per second [default: disabled]" );
+    parser.add_argument( "--deadline" )
+        .default_value< double >( 0.0 )
+        .scan< 'g', double >( )
+        .help( "the maximum number of seconds to spend reading a code section [default: disabled]" );
     parser.add_argument( "-i", "--resolve-imports" ).flag( ).default_value< bool >( false ).help( "rebuild the import table from scratch" );
+    parser.add_argument( "--rebuild-relocations" )
+        .flag( )
+        .default_value< bool >( false )
+        .help( "reconstruct the relocation directory if it is missing or unreadable" );
+#ifdef _WIN32
     parser.add_argument( "-w", "--wait" ).flag( ).default_value< bool >( false ).help( "wait for the process to start" );
+#endif
     parser.add_argument( "--ignore-sections" )
         .help( "a list of section names to skip" )
         .nargs( argparse::nargs_pattern::any )
         .default_value( std::list< std::string >( ) );
+    parser.add_argument( "--target-sections" )
+        .help( "only dump these sections, along with the headers and data directories" )
+        .nargs( argparse::nargs_pattern::any )
+        .default_value( std::list< std::string >( ) );
+    parser.add_argument( "--target-functions" )
+        .help( "only dump the functions that start at these hexadecimal RVAs, along with the headers and data directories" )
+        .nargs( argparse::nargs_pattern::any )
+        .default_value( std::list< std::string >( ) );
+    parser.add_argument( "--target-ranges" )
+        .help( "only dump these hexadecimal RVA ranges, given as <rva>:<size>, along with the headers and data directories" )
+        .nargs( argparse::nargs_pattern::any )
+        .default_value( std::list< std::string >( ) );
     parser.add_argument( "-r", "--rebase" )
         .help( "rebases the image to a new absolute address (fixes relocations) [default: <old-base>]" )
         .scan< 'x', std::uintptr_t >( );
-    parser.add_argument( "--minidump" ).help( "the path of the minidump file to create" ).default_value< std::string >( "" );
+#ifdef _WIN32
+    parser.add_argument( "--minidump" ).help( "the path of a full memory minidump of the process to create" ).default_value< std::string >( "" );
+#endif
+    parser.add_argument( "--coverage-map" )
+        .help( "the path of a text file that classifies every code page of the dump as code, data, encrypted, zero or unread" )
+        .default_value< std::string >( "" );
+    parser.add_argument( "--xref-database" )
+        .help( "the path of a database of every cross reference of the code, indexed by source and target" )
+        .default_value< std::string >( "" );
+    parser.add_argument( "--stream" )
+        .flag( )
+        .default_value< bool >( false )
+        .help( "write sections straight into the output file as they are read, instead of building the image in memory" );
+    parser.add_argument( "--memory-budget" )
+        .default_value< std::size_t >( 64 )
+        .scan< 'u', std::size_t >( )
+        .help( "the number of megabytes of a streamed image to keep in memory before writing them back" );
+    parser.add_argument( "--result-store" )
+        .help( "a directory of earlier dumps, which are reused when the module did not change and topped up when they missed pages" );
+    parser.add_argument( "--watch" )
+        .default_value< double >( 0.0 )
+        .scan< 'g', double >( )
+        .help( "check the code pages for changes every this many seconds after the dump, and write them to delta files [default: disabled]" );
+
+    argparse::ArgumentParser merge_command( "merge" );
+
+    merge_command.add_description( "Merges partial dumps of the same module into one image that holds every page any of them decrypted." );
+    merge_command.add_argument( "inputs" ).help( "the dumps to merge" ).nargs( argparse::nargs_pattern::at_least_one );
+    merge_command.add_argument( "-o", "--output" ).required( ).help( "the name of the output file" );
+    merge_command.add_argument( "--coverage-map" ).help( "the path of a text file that classifies every code page of the merged image" );
+
+    parser.add_subparser( merge_command );
+
+    argparse::ArgumentParser diff_command( "diff" );
+
+    diff_command.add_description( "Compares two dumps of a module and reports the changed sections, pages and functions." );
+    diff_command.add_argument( "old" ).help( "the old dump" );
+    diff_command.add_argument( "new" ).help( "the new dump" );
+    diff_command.add_argument( "-o", "--output" ).help( "the name of the report file [default: <stdout>]" );
+
+    parser.add_subparser( diff_command );
+
+    argparse::ArgumentParser carve_command( "carve" );
+
+    carve_command.add_description(
+        "Finds every mapped image in a minidump or raw memory snapshot, including ones missing from the module list, and rebuilds them." );
+    carve_command.add_argument( "input" ).help( "the minidump or raw memory snapshot" );
+    carve_command.add_argument( "--snapshot-base" )
+        .help( "the address the raw memory snapshot was taken at (the input is read as a minidump without it)" )
+        .scan< 'x', std::uintptr_t >( );
+    carve_command.add_argument( "-o", "--output" ).default_value< std::string >( "." ).help( "the directory to save the images to" );
+    carve_command.add_argument( "--list" ).flag( ).default_value< bool >( false ).help( "only list the images, do not rebuild them" );
+
+    parser.add_subparser( carve_command );
+
+    argparse::ArgumentParser batch_command( "batch" );
+
+    batch_command.add_description(
+        "Rebuilds the modules of many minidumps and raw memory snapshots in parallel. Inputs that were rebuilt by an earlier run into the same "
+        "output directory are skipped." );
+    batch_command.add_argument( "input" )
+        .help( "a directory of minidumps, or a manifest with one tab separated line per input: <path> [<snapshot-base>] [<module>]" );
+    batch_command.add_argument( "-o", "--output" )
+        .default_value< std::string >( "." )
+        .help( "the directory to save the images and the results manifest (results.tsv) to" );
+    batch_command.add_argument( "-j", "--jobs" )
+        .default_value< std::size_t >( 0 )
+        .scan< 'u', std::size_t >( )
+        .help( "the number of inputs to rebuild at once [default: <hardware-threads>]" );
+    batch_command.add_argument( "--memory-budget" )
+        .default_value< std::size_t >( 0 )
+        .scan< 'u', std::size_t >( )
+        .help( "the number of megabytes of images the running jobs may hold at once [default: unlimited]" );
+    batch_command.add_argument( "-i", "--resolve-imports" ).flag( ).default_value< bool >( false ).help( "rebuild the import tables from scratch" );
+    batch_command.add_argument( "--rebuild-relocations" )
+        .flag( )
+        .default_value< bool >( false )
+        .help( "reconstruct the relocation directories if they are missing or unreadable" );
+    batch_command.add_argument( "-r", "--rebase" ).help( "rebases the images to a new absolute address" ).scan< 'x', std::uintptr_t >( );
+
+    parser.add_subparser( batch_command );
+
+    argparse::ArgumentParser replay_command( "replay" );
+
+    replay_command.add_description(
+        "Replays page-arrival traces through the dumper and reports, for every code section, the coverage and the virtual time it took to "
+        "reach 50, 90, 99 and 100% of it." );
+    replay_command.add_argument( "traces" ).help( "the traces to replay" ).nargs( argparse::nargs_pattern::at_least_one );
+    replay_command.add_argument( "-m", "--module" ).help( "the name of the module to dump [default: \"<main-module>\"]" );
+    replay_command.add_argument( "-o", "--output" ).help( "the name of the report file [default: <stdout>]" );
+    replay_command.add_argument( "-d", "--decryption-factor" )
+        .default_value< float >( 1.0f )
+        .scan< 'g', float >( )
+        .help( "stop reading a code section once this fraction of its pages was decrypted" );
+    replay_command.add_argument( "--min-gain-rate" )
+        .default_value< double >( 0.0 )
+        .scan< 'g', double >( )
+        .help( "stop reading a code section once the expected coverage gain drops below this many percent per second [default: disabled]" );
+    replay_command.add_argument( "--deadline" )
+        .default_value< double >( 0.0 )
+        .scan< 'g', double >( )
+        .help( "the maximum number of seconds to spend reading a code section [default: disabled]" );
+    replay_command.add_argument( "--expect" )
+        .help( "fail unless every code section reaches these coverages in time, given as <percent>:<seconds>" )
+        .nargs( argparse::nargs_pattern::any )
+        .default_value( std::list< std::string >( ) );
+
+    parser.add_subparser( replay_command );
 
     // Parse the command line arguments
     try
@@ -58,50 +842,228 @@ std::int32_t main( std::int32_t argc, char* argv[] )
         return 1;
     }
 
+#ifdef _WIN32
     // Register the console control handler to terminate the application when CTRL+C or CTRL+BREAK is pressed.
     SetConsoleCtrlHandler( console_ctrl_handler, TRUE );
+#else
+    std::signal( SIGINT, signal_handler );
+    std::signal( SIGTERM, signal_handler );
+
+    // Turns a received signal into a stop request. It is stopped and joined when `main` returns.
+    const std::jthread interrupt_watcher(
+        []( std::stop_token stop_token )
+        {
+            while ( !stop_token.stop_requested( ) && !interrupted )
+                std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+
+            if ( interrupted )
+                stop_source.request_stop( );
+        } );
+#endif
+
+    if ( parser.is_subcommand_used( merge_command ) )
+        return merge_dumps( merge_command );
+
+    if ( parser.is_subcommand_used( diff_command ) )
+        return diff_dumps( diff_command );
+
+    if ( parser.is_subcommand_used( carve_command ) )
+        return carve_images( carve_command );
+
+    if ( parser.is_subcommand_used( batch_command ) )
+        return batch_dumps( batch_command );
+
+    if ( parser.is_subcommand_used( replay_command ) )
+        return replay_traces( replay_command );
 
     try
     {
+#ifdef _WIN32
         std::unique_ptr< wincpp::process_t > process = nullptr;
+#endif
+        std::unique_ptr< vulkan::sources::source > source = nullptr;
+        std::unique_ptr< vulkan::sources::recording_source > recorder = nullptr;
 
-        const auto& should_wait = parser.get< bool >( "wait" );
+        auto opts = vulkan::dumper::options::default_value( );
 
-        do
+        if ( const auto& m = parser.present< std::string >( "-m" ) )
+            opts.module_name( m.value( ) );
+
+        if ( const auto& path = parser.present< std::string >( "from-minidump" ) )
         {
-            process = wincpp::process_t::open( parser.get< std::string >( "process" ) );
+            auto minidump = std::make_unique< vulkan::sources::minidump_source >( path.value( ) );
 
-            if ( should_wait )
-                std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+            if ( !minidump->is_valid( ) )
+            {
+                spdlog::error( "Failed to read minidump \"{}\"", path.value( ) );
+                return 1;
+            }
 
-        } while ( !process && should_wait && !stop_source.stop_requested( ) );
+            // The main module is the first module in the list.
+            if ( opts.module_name( ).empty( ) && !minidump->modules( ).empty( ) )
+                opts.module_name( minidump->modules( ).front( ).name );
 
-        if ( !process )
+            source = std::move( minidump );
+        }
+        else if ( const auto& path = parser.present< std::string >( "from-snapshot" ) )
         {
-            spdlog::error( "Failed to open process" );
-            return 1;
+            const auto& base = parser.present< std::uintptr_t >( "snapshot-base" );
+
+            if ( !base )
+            {
+                spdlog::error( "--from-snapshot requires --snapshot-base" );
+                return 1;
+            }
+
+            if ( opts.module_name( ).empty( ) )
+                opts.module_name( std::filesystem::path( path.value( ) ).filename( ).string( ) );
+
+            auto snapshot = std::make_unique< vulkan::sources::snapshot_source >( path.value( ), opts.module_name( ), base.value( ) );
+
+            if ( !snapshot->is_valid( ) )
+            {
+                spdlog::error( "Failed to read snapshot \"{}\"", path.value( ) );
+                return 1;
+            }
+
+            source = std::move( snapshot );
         }
+        else if ( const auto& path = parser.present< std::string >( "from-trace" ) )
+        {
+            auto replay = std::make_unique< vulkan::sources::replay_source >( path.value( ) );
 
-        auto opts = vulkan::dumper::options::default_value( );
+            if ( !replay->is_valid( ) )
+            {
+                spdlog::error( "Failed to read trace \"{}\"", path.value( ) );
+                return 1;
+            }
 
-        if ( const auto& m = parser.present< std::string >( "-m" ) )
-            opts.module_name( m.value( ) );
+            // The main module is the first module in the list.
+            if ( opts.module_name( ).empty( ) && !replay->modules( ).empty( ) )
+                opts.module_name( replay->modules( ).front( ).name );
+
+            source = std::move( replay );
+        }
         else
-            opts.module_name( process->name( ) );
+        {
+#ifdef _WIN32
+            if ( !parser.present( "process" ) )
+            {
+                spdlog::error( "Either --process, --from-minidump, --from-snapshot or --from-trace is required" );
+                return 1;
+            }
+
+            const auto& should_wait = parser.get< bool >( "wait" );
+
+            do
+            {
+                process = wincpp::process_t::open( parser.get< std::string >( "process" ) );
+
+                if ( should_wait )
+                    std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+
+            } while ( !process && should_wait && !stop_source.stop_requested( ) );
+
+            if ( !process )
+            {
+                spdlog::error( "Failed to open process" );
+                return 1;
+            }
+
+            if ( opts.module_name( ).empty( ) )
+                opts.module_name( process->name( ) );
+
+            source = std::make_unique< vulkan::sources::process_source >( *process );
+#else
+            spdlog::error( "Either --from-minidump, --from-snapshot or --from-trace is required, live processes can only be read on Windows" );
+            return 1;
+#endif
+        }
 
         opts.target_decryption_factor( parser.get< float >( "decryption-factor" ) );
+        opts.min_gain_rate( parser.get< double >( "min-gain-rate" ) / 100.0 );
+        opts.deadline( std::chrono::duration< double >( parser.get< double >( "deadline" ) ) );
         opts.resolve_imports( parser.get< bool >( "resolve-imports" ) );
+        opts.rebuild_relocations( parser.get< bool >( "rebuild-relocations" ) );
         opts.ignore_sections( parser.get< std::list< std::string > >( "ignore-sections" ) );
 
+        vulkan::targets_t targets;
+
+        for ( const auto& name : parser.get< std::list< std::string > >( "target-sections" ) )
+            targets.sections.push_back( name );
+
+        for ( const auto& value : parser.get< std::list< std::string > >( "target-functions" ) )
+        {
+            const auto& rva = parse_hex( value );
+
+            if ( !rva )
+            {
+                spdlog::error( "Invalid function RVA \"{}\"", value );
+                return 1;
+            }
+
+            targets.functions.push_back( rva.value( ) );
+        }
+
+        for ( const auto& value : parser.get< std::list< std::string > >( "target-ranges" ) )
+        {
+            const auto separator = value.find( ':' );
+            const auto& rva = parse_hex( value.substr( 0, separator ) );
+            const auto& size = separator != std::string::npos ? parse_hex( value.substr( separator + 1 ) ) : std::nullopt;
+
+            if ( !rva || !size )
+            {
+                spdlog::error( "Invalid range \"{}\", expected <rva>:<size>", value );
+                return 1;
+            }
+
+            targets.ranges.push_back( { rva.value( ), size.value( ) } );
+        }
+
+        opts.targets( std::move( targets ) );
+
         if ( const auto& rebase = parser.present< std::uintptr_t >( "-r" ) )
             opts.image_base( rebase.value( ) );
 
+#ifdef _WIN32
         opts.minidump_path( parser.get< std::string >( "minidump" ) );
+#endif
+        opts.coverage_path( parser.get< std::string >( "coverage-map" ) );
+        opts.xref_path( parser.get< std::string >( "xref-database" ) );
 
-        const auto& image = vulkan::dumper::dump( process, opts, stop_source.get_token( ) );
+        if ( const auto& path = parser.present< std::string >( "result-store" ) )
+            opts.result_store( std::make_shared< vulkan::store::result_store >( path.value( ) ) );
 
         const auto& output = parser.present< std::string >( "-o" ).value_or( opts.module_name( ).data( ) );
 
+        if ( parser.get< bool >( "stream" ) )
+        {
+            opts.stream_path( output );
+            opts.memory_budget( parser.get< std::size_t >( "memory-budget" ) * 1024 * 1024 );
+        }
+
+        if ( const auto interval = parser.get< double >( "watch" ); interval > 0.0 )
+        {
+            opts.watch_interval( std::chrono::duration< double >( interval ) );
+            opts.watch_path( output );
+        }
+
+        if ( const auto& path = parser.present< std::string >( "record-trace" ) )
+        {
+            recorder = std::make_unique< vulkan::sources::recording_source >( *source, path.value( ) );
+
+            if ( !recorder->is_valid( ) )
+            {
+                spdlog::error( "Failed to create trace \"{}\"", path.value( ) );
+                return 1;
+            }
+
+            spdlog::info( "Recording trace to \"{}\"", path.value( ) );
+        }
+
+        const auto& image =
+            vulkan::dumper::dump( recorder ? static_cast< const vulkan::sources::source& >( *recorder ) : *source, opts, stop_source.get_token( ) );
+
         spdlog::info( "Dumping module: \"{}\" to \"{}\"", opts.module_name( ), output );
 
         image->save_to_file( output );
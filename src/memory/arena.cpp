@@ -0,0 +1,41 @@
+#include "memory/arena.hpp"
+
+namespace vulkan::memory
+{
+    arena::arena( std::size_t initial_size, std::pmr::memory_resource* upstream ) noexcept : _resource( initial_size, upstream )
+    {
+    }
+
+    void* arena::do_allocate( std::size_t bytes, std::size_t alignment )
+    {
+        std::lock_guard lock( _mutex );
+
+#ifndef NDEBUG
+        ++_allocations;
+        _bytes += bytes;
+#endif
+
+        return _resource.allocate( bytes, alignment );
+    }
+
+    void arena::do_deallocate( void*, std::size_t, std::size_t )
+    {
+        // Memory is only given back when the arena is destroyed.
+    }
+
+    bool arena::do_is_equal( const std::pmr::memory_resource& other ) const noexcept
+    {
+        return this == &other;
+    }
+
+    arena::stats_t arena::stats( ) const noexcept
+    {
+#ifndef NDEBUG
+        std::lock_guard lock( _mutex );
+
+        return { _allocations, _bytes };
+#else
+        return { };
+#endif
+    }
+}  // namespace vulkan::memory
\ No newline at end of file
@@ -0,0 +1,432 @@
+#include "merge/merger.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+
+#include "analysis/page_classifier.hpp"
+#include "parallel.hpp"
+#include "pe/util.hpp"
+#include "spdlog/spdlog.h"
+
+namespace vulkan::merge
+{
+    namespace
+    {
+        /// <summary>
+        /// Returns whether a page holds real contents, i.e. it was read and does not look encrypted.
+        /// </summary>
+        bool is_real( std::span< const std::uint8_t > page ) noexcept
+        {
+            const auto type = analysis::classify_page( page ).type;
+
+            return type != analysis::page_class_t::filler && type != analysis::page_class_t::encrypted;
+        }
+
+        /// <summary>
+        /// Returns whether a section contains code.
+        /// </summary>
+        constexpr bool is_code( const pe::section_header_t& section ) noexcept
+        {
+            return section.Characteristics & pe::SCN_CNT_CODE;
+        }
+
+        /// <summary>
+        /// Returns the name of a section. Names of exactly eight characters are not null-terminated.
+        /// </summary>
+        std::string_view name_of( const pe::section_header_t& section ) noexcept
+        {
+            const auto name = reinterpret_cast< const char* >( section.Name );
+
+            return { name, strnlen( name, pe::SIZEOF_SHORT_NAME ) };
+        }
+
+        /// <summary>
+        /// Finds the section with the same name in a section table.
+        /// </summary>
+        const pe::section_header_t* find( const std::vector< pe::section_header_t >& sections, const pe::section_header_t& section ) noexcept
+        {
+            const auto it = std::find_if(
+                sections.begin( ),
+                sections.end( ),
+                [ & ]( const pe::section_header_t& other ) { return !std::memcmp( other.Name, section.Name, pe::SIZEOF_SHORT_NAME ); } );
+
+            return it != sections.end( ) ? &*it : nullptr;
+        }
+
+        /// <summary>
+        /// Returns the raw contents of a page of a section, or an empty span if it lies outside of the file.
+        /// </summary>
+        template< typename T >
+        std::span< T > page_of( std::span< T > file, const pe::section_header_t& section, std::uint32_t index ) noexcept
+        {
+            const std::uint64_t begin = static_cast< std::uint64_t >( index ) * pe::PAGE_SIZE;
+
+            if ( begin >= section.SizeOfRawData )
+                return { };
+
+            const auto offset = section.PointerToRawData + begin;
+            const auto length = std::min< std::uint64_t >( pe::PAGE_SIZE, section.SizeOfRawData - begin );
+
+            if ( offset + length > file.size( ) )
+                return { };
+
+            return file.subspan( offset, length );
+        }
+
+        /// <summary>
+        /// Returns the number of bytes a relocation patches, or zero if it is not supported.
+        /// </summary>
+        constexpr std::uint32_t width_of( std::uint8_t type ) noexcept
+        {
+            switch ( type )
+            {
+                case pe::REL_BASED_HIGH:
+                case pe::REL_BASED_LOW: return sizeof( std::uint16_t );
+                case pe::REL_BASED_HIGHLOW: return sizeof( std::uint32_t );
+                case pe::REL_BASED_DIR64: return sizeof( std::uint64_t );
+                default: return 0;
+            }
+        }
+
+        /// <summary>
+        /// Adds a value to an unaligned field.
+        /// </summary>
+        template< typename T >
+        void add_to( std::uint8_t* field, T value ) noexcept
+        {
+            T current;
+            std::memcpy( &current, field, sizeof( T ) );
+
+            current += value;
+            std::memcpy( field, &current, sizeof( T ) );
+        }
+
+        /// <summary>
+        /// Applies a base delta to a relocated field.
+        /// </summary>
+        void relocate( std::uint8_t* field, std::uint8_t type, std::uintptr_t delta ) noexcept
+        {
+            switch ( type )
+            {
+                case pe::REL_BASED_HIGH: add_to( field, static_cast< std::uint16_t >( delta >> 16 ) ); break;
+                case pe::REL_BASED_LOW: add_to( field, static_cast< std::uint16_t >( delta & 0xFFFF ) ); break;
+                case pe::REL_BASED_HIGHLOW: add_to( field, static_cast< std::uint32_t >( delta ) ); break;
+                case pe::REL_BASED_DIR64: add_to( field, static_cast< std::uint64_t >( delta ) ); break;
+                default: break;
+            }
+        }
+    }  // namespace
+
+    merger::merger( ) noexcept
+    {
+    }
+
+    bool merger::add( std::string_view path ) noexcept
+    {
+        input_t input{ std::string( path ), io::mapped_file( path ), 0, 0, 0, 0, { } };
+
+        if ( !input.file.is_valid( ) )
+        {
+            spdlog::error( "Failed to map \"{}\"", path );
+            return false;
+        }
+
+        const auto data = input.file.data( );
+        const auto dos_header = reinterpret_cast< const pe::dos_header_t* >( data.data( ) );
+
+        if ( data.size( ) < sizeof( pe::dos_header_t ) || dos_header->e_magic != pe::DOS_SIGNATURE || dos_header->e_lfanew < 0 ||
+             dos_header->e_lfanew + sizeof( pe::nt_headers_t ) > data.size( ) )
+        {
+            spdlog::error( "\"{}\" is not a PE image", path );
+            return false;
+        }
+
+        const auto nt_headers = reinterpret_cast< const pe::nt_headers_t* >( data.data( ) + dos_header->e_lfanew );
+        const auto first_section = reinterpret_cast< const pe::section_header_t* >( pe::first_section( nt_headers ) );
+        const auto sections_end =
+            reinterpret_cast< const std::uint8_t* >( first_section ) + nt_headers->FileHeader.NumberOfSections * sizeof( pe::section_header_t );
+
+        const auto arch = pe::arch_of( nt_headers->OptionalHeader.Magic );
+
+        if ( nt_headers->Signature != pe::NT_SIGNATURE || arch == pe::arch_t::unknown || sections_end > data.data( ) + data.size( ) )
+        {
+            spdlog::error( "\"{}\" is not a PE image", path );
+            return false;
+        }
+
+        input.image_base = pe::dispatch(
+            arch,
+            [ & ]< typename Arch >( Arch )
+            { return static_cast< std::uintptr_t >( reinterpret_cast< const typename Arch::nt_headers_t* >( nt_headers )->OptionalHeader.ImageBase ); } );
+        input.machine = nt_headers->FileHeader.Machine;
+        input.time_date_stamp = nt_headers->FileHeader.TimeDateStamp;
+        input.entry_point = nt_headers->OptionalHeader.AddressOfEntryPoint;
+        input.sections.assign( first_section, first_section + nt_headers->FileHeader.NumberOfSections );
+
+        if ( !_inputs.empty( ) )
+        {
+            const auto& reference = _inputs.front( );
+
+            // Dumps may differ in the sections that were appended while rebuilding them, but never in the ones that hold code.
+            std::string difference;
+
+            if ( input.machine != reference.machine )
+                difference = "the machine types differ";
+            else if ( input.time_date_stamp != reference.time_date_stamp )
+                difference = "the time stamps differ";
+            else if ( input.entry_point != reference.entry_point )
+                difference = "the entry points differ";
+
+            for ( const auto& section : reference.sections )
+            {
+                if ( !difference.empty( ) )
+                    break;
+
+                if ( !is_code( section ) )
+                    continue;
+
+                const auto match = find( input.sections, section );
+
+                if ( !match )
+                    difference = std::format( "section \"{}\" is missing", name_of( section ) );
+                else if ( match->VirtualAddress != section.VirtualAddress || match->Misc.VirtualSize != section.Misc.VirtualSize )
+                    difference = std::format( "section \"{}\" differs", name_of( section ) );
+            }
+
+            if ( !difference.empty( ) )
+            {
+                spdlog::error( "\"{}\" is not the same build as \"{}\": {}", path, reference.path, difference );
+                return false;
+            }
+        }
+
+        spdlog::debug( "Added \"{}\" @ 0x{:X}", path, input.image_base );
+
+        _inputs.push_back( std::move( input ) );
+        return true;
+    }
+
+    std::optional< result_t > merger::merge( ) const
+    {
+        if ( _inputs.empty( ) )
+            return std::nullopt;
+
+        const auto& reference = _inputs.front( );
+        const auto reference_data = reference.file.data( );
+
+        result_t result;
+        result.image = std::make_unique< pe::image >( std::vector< std::uint8_t >( reference_data.begin( ), reference_data.end( ) ), false );
+        result.contributions.resize( _inputs.size( ) );
+
+        if ( !result.image->is_valid( ) )
+            return std::nullopt;
+
+        // The delta to add to the pointers of every dump, so that they match the base of the first one.
+        std::vector< std::uintptr_t > deltas;
+
+        for ( const auto& input : _inputs )
+            deltas.push_back( reference.image_base - input.image_base );
+
+        std::vector< pe::relocation_directory::relocation_t > relocations;
+
+        if ( std::any_of( deltas.begin( ), deltas.end( ), []( std::uintptr_t delta ) { return delta != 0; } ) )
+        {
+            relocations = result.image->relocation_directory( )->relocations( );
+
+            // Relocations are the same in every dump of a build, so any dump that still has them will do.
+            for ( std::size_t i = 1; relocations.empty( ) && i < _inputs.size( ); ++i )
+            {
+                const auto data = _inputs[ i ].file.data( );
+                const pe::image image( std::vector< std::uint8_t >( data.begin( ), data.end( ) ), false );
+
+                if ( image.is_valid( ) )
+                    relocations = image.relocation_directory( )->relocations( );
+            }
+
+            if ( relocations.empty( ) )
+                spdlog::warn( "None of the dumps has a relocation directory. Pages of rebased dumps are not normalized." );
+
+            std::erase_if( relocations, []( const auto& relocation ) { return !width_of( relocation.type ); } );
+            std::sort( relocations.begin( ), relocations.end( ), []( const auto& a, const auto& b ) { return a.rva < b.rva; } );
+        }
+
+        // A code page of the merged image.
+        struct page_t
+        {
+            std::uint16_t section;
+            std::uint32_t index;
+        };
+
+        std::vector< page_t > pages;
+
+        // The index of the first page of every code section.
+        std::vector< std::size_t > first_pages( reference.sections.size( ) );
+
+        // The matching section of every dump, indexed by dump and then by section of the first dump.
+        std::vector< std::vector< const pe::section_header_t* > > matches( _inputs.size( ) );
+
+        for ( std::uint16_t section = 0; section < reference.sections.size( ); ++section )
+        {
+            for ( std::size_t i = 0; i < _inputs.size( ); ++i )
+                matches[ i ].push_back( find( _inputs[ i ].sections, reference.sections[ section ] ) );
+
+            if ( !is_code( reference.sections[ section ] ) )
+                continue;
+
+            first_pages[ section ] = pages.size( );
+
+            const auto count = pe::align( reference.sections[ section ].Misc.VirtualSize, pe::PAGE_SIZE ) / pe::PAGE_SIZE;
+
+            for ( std::uint32_t index = 0; index < count; ++index )
+                pages.push_back( { section, index } );
+        }
+
+        result.total_pages = pages.size( );
+
+        const auto& headers = result.image->section_headers( );
+        const auto output = std::span( result.image->buffer( ) );
+
+        // The dump every page was taken from, used to relocate fields that straddle two pages.
+        constexpr auto none = static_cast< std::size_t >( -1 );
+
+        std::vector< std::size_t > owners( pages.size( ), none );
+
+        struct partial_t
+        {
+            std::size_t merged_pages = 0;
+            std::vector< std::size_t > contributions;
+            std::vector< conflict_t > conflicts;
+        };
+
+        const auto chunks = split( pages.size( ), 64 );
+        std::vector< partial_t > partials( chunks.size( ) );
+
+        parallel_for(
+            chunks,
+            [ & ]( std::size_t chunk, std::size_t begin, std::size_t end )
+            {
+                auto& partial = partials[ chunk ];
+                partial.contributions.resize( _inputs.size( ) );
+
+                // The normalized contents of the page in every dump that read it.
+                std::vector< std::vector< std::uint8_t > > contents( _inputs.size( ) );
+                std::vector< std::size_t > candidates;
+
+                for ( auto i = begin; i < end; ++i )
+                {
+                    const auto& [ section, index ] = pages[ i ];
+                    const auto rva = reference.sections[ section ].VirtualAddress + index * pe::PAGE_SIZE;
+
+                    candidates.clear( );
+
+                    for ( std::size_t input = 0; input < _inputs.size( ); ++input )
+                    {
+                        const auto page = page_of( _inputs[ input ].file.data( ), *matches[ input ][ section ], index );
+
+                        if ( page.empty( ) || !is_real( page ) )
+                            continue;
+
+                        auto& content = contents[ input ];
+                        content.assign( page.begin( ), page.end( ) );
+
+                        // Fields that straddle the end of the page are relocated once both halves are in place.
+                        if ( deltas[ input ] )
+                        {
+                            auto it = std::lower_bound(
+                                relocations.begin( ), relocations.end( ), rva, []( const auto& relocation, std::uint32_t value ) { return relocation.rva < value; } );
+
+                            for ( ; it != relocations.end( ) && it->rva < rva + content.size( ); ++it )
+                            {
+                                const auto offset = it->rva - rva;
+
+                                if ( offset + width_of( it->type ) <= content.size( ) )
+                                    relocate( content.data( ) + offset, it->type, deltas[ input ] );
+                            }
+                        }
+
+                        candidates.push_back( input );
+                    }
+
+                    if ( candidates.empty( ) )
+                        continue;
+
+                    // The contents most dumps agree on win. Ties go to the dump that was added first.
+                    auto chosen = candidates.front( );
+                    std::size_t votes = 0;
+
+                    for ( const auto candidate : candidates )
+                    {
+                        const auto count = static_cast< std::size_t >(
+                            std::count_if( candidates.begin( ), candidates.end( ), [ & ]( std::size_t other ) { return contents[ other ] == contents[ candidate ]; } ) );
+
+                        if ( count > votes )
+                        {
+                            chosen = candidate;
+                            votes = count;
+                        }
+                    }
+
+                    if ( votes < candidates.size( ) )
+                        partial.conflicts.push_back( { rva, chosen, candidates.size( ) - votes } );
+
+                    const auto destination = page_of( output, *headers->at( section ), index );
+                    const auto length = std::min( destination.size( ), contents[ chosen ].size( ) );
+
+                    std::copy_n( contents[ chosen ].begin( ), length, destination.begin( ) );
+
+                    owners[ i ] = chosen;
+                    ++partial.merged_pages;
+                    ++partial.contributions[ chosen ];
+                }
+            } );
+
+        for ( const auto& partial : partials )
+        {
+            result.merged_pages += partial.merged_pages;
+            result.conflicts.insert( result.conflicts.end( ), partial.conflicts.begin( ), partial.conflicts.end( ) );
+
+            for ( std::size_t i = 0; i < partial.contributions.size( ); ++i )
+                result.contributions[ i ] += partial.contributions[ i ];
+        }
+
+        // Returns the index of the code page that contains an address.
+        const auto locate = [ & ]( std::uint32_t rva ) -> std::size_t
+        {
+            for ( std::uint16_t section = 0; section < reference.sections.size( ); ++section )
+            {
+                const auto& header = reference.sections[ section ];
+
+                if ( is_code( header ) && rva >= header.VirtualAddress && rva - header.VirtualAddress < pe::align( header.Misc.VirtualSize, pe::PAGE_SIZE ) )
+                    return first_pages[ section ] + ( rva - header.VirtualAddress ) / pe::PAGE_SIZE;
+            }
+
+            return none;
+        };
+
+        for ( const auto& relocation : relocations )
+        {
+            const auto width = width_of( relocation.type );
+
+            if ( relocation.rva % pe::PAGE_SIZE + width <= pe::PAGE_SIZE )
+                continue;
+
+            const auto first = locate( relocation.rva );
+            const auto second = locate( relocation.rva + width - 1 );
+
+            if ( first == none || second == none )
+                continue;
+
+            const auto owner = owners[ first ];
+
+            // Both halves must come from dumps saved at the same base, otherwise the field is garbage either way.
+            if ( owner == none || owners[ second ] == none || deltas[ owner ] != deltas[ owners[ second ] ] || !deltas[ owner ] )
+                continue;
+
+            if ( const auto offset = result.image->rva_to_offset( relocation.rva ) )
+                relocate( output.data( ) + offset, relocation.type, deltas[ owner ] );
+        }
+
+        return result;
+    }
+}  // namespace vulkan::merge
\ No newline at end of file
@@ -0,0 +1,295 @@
+#include "minidump/reader.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "minidump/format.hpp"
+
+namespace vulkan::minidump
+{
+    namespace
+    {
+        /// <summary>
+        /// Returns a pointer to `count` structures at the given offset, or a null pointer if they do not fit into the file.
+        /// </summary>
+        template< typename T >
+        const T* at( std::span< const std::uint8_t > data, std::uint64_t offset, std::uint64_t count = 1 ) noexcept
+        {
+            if ( offset > data.size( ) || count > ( data.size( ) - offset ) / sizeof( T ) )
+                return nullptr;
+
+            return reinterpret_cast< const T* >( data.data( ) + offset );
+        }
+
+        /// <summary>
+        /// Reads a `MINIDUMP_STRING` (UTF-16) and converts it to UTF-8.
+        /// </summary>
+        std::string read_string( std::span< const std::uint8_t > data, std::uint32_t rva )
+        {
+            const auto length = at< std::uint32_t >( data, rva );
+
+            if ( !length )
+                return { };
+
+            const auto units = at< char16_t >( data, rva + sizeof( std::uint32_t ), *length / sizeof( char16_t ) );
+
+            if ( !units )
+                return { };
+
+            std::string result;
+            result.reserve( *length / sizeof( char16_t ) );
+
+            for ( std::size_t i = 0; i < *length / sizeof( char16_t ); ++i )
+            {
+                std::uint32_t cp = units[ i ];
+
+                // Combine surrogate pairs.
+                if ( cp >= 0xD800 && cp < 0xDC00 && i + 1 < *length / sizeof( char16_t ) && units[ i + 1 ] >= 0xDC00 && units[ i + 1 ] < 0xE000 )
+                    cp = 0x10000 + ( ( cp - 0xD800 ) << 10 ) + ( units[ ++i ] - 0xDC00 );
+
+                if ( cp < 0x80 )
+                    result += static_cast< char >( cp );
+                else if ( cp < 0x800 )
+                {
+                    result += static_cast< char >( 0xC0 | ( cp >> 6 ) );
+                    result += static_cast< char >( 0x80 | ( cp & 0x3F ) );
+                }
+                else if ( cp < 0x10000 )
+                {
+                    result += static_cast< char >( 0xE0 | ( cp >> 12 ) );
+                    result += static_cast< char >( 0x80 | ( ( cp >> 6 ) & 0x3F ) );
+                    result += static_cast< char >( 0x80 | ( cp & 0x3F ) );
+                }
+                else
+                {
+                    result += static_cast< char >( 0xF0 | ( cp >> 18 ) );
+                    result += static_cast< char >( 0x80 | ( ( cp >> 12 ) & 0x3F ) );
+                    result += static_cast< char >( 0x80 | ( ( cp >> 6 ) & 0x3F ) );
+                    result += static_cast< char >( 0x80 | ( cp & 0x3F ) );
+                }
+            }
+
+            return result;
+        }
+
+        /// <summary>
+        /// Compares two ASCII strings, ignoring case.
+        /// </summary>
+        bool iequals( std::string_view a, std::string_view b ) noexcept
+        {
+            return std::equal(
+                a.begin( ), a.end( ), b.begin( ), b.end( ), []( char x, char y ) { return std::tolower( x ) == std::tolower( y ); } );
+        }
+    }  // namespace
+
+    bool memory_region_t::is_readable( ) const noexcept
+    {
+        return state == MEM_STATE_COMMIT && !( protect & ( PAGE_PROTECT_NOACCESS | PAGE_PROTECT_GUARD ) );
+    }
+
+    reader::reader( std::string_view path ) noexcept : _file( path )
+    {
+        _is_valid = _file.is_valid( ) && parse( );
+    }
+
+    bool reader::parse( ) noexcept
+    {
+        const auto data = _file.data( );
+        const auto header = at< header_t >( data, 0 );
+
+        if ( !header || header->signature != SIGNATURE || ( header->version & 0xFFFF ) != VERSION )
+            return false;
+
+        const auto directories = at< directory_t >( data, header->stream_directory_rva, header->number_of_streams );
+
+        if ( !directories )
+            return false;
+
+        for ( std::uint32_t i = 0; i < header->number_of_streams; ++i )
+        {
+            const auto& location = directories[ i ].location;
+
+            switch ( static_cast< stream_type_t >( directories[ i ].stream_type ) )
+            {
+                case stream_type_t::module_list:
+                {
+                    const auto count = at< std::uint32_t >( data, location.rva );
+
+                    if ( !count )
+                        break;
+
+                    const auto modules = at< module_t >( data, location.rva + sizeof( std::uint32_t ), *count );
+
+                    if ( !modules )
+                        break;
+
+                    for ( std::uint32_t j = 0; j < *count; ++j )
+                    {
+                        module_info_t info = { };
+                        info.path = read_string( data, modules[ j ].module_name_rva );
+                        info.name = info.path.substr( info.path.find_last_of( "\\/" ) + 1 );
+                        info.base = modules[ j ].base_of_image;
+                        info.size = modules[ j ].size_of_image;
+                        info.checksum = modules[ j ].checksum;
+                        info.time_date_stamp = modules[ j ].time_date_stamp;
+
+                        _modules.push_back( std::move( info ) );
+                    }
+
+                    break;
+                }
+                case stream_type_t::memory_list:
+                {
+                    const auto count = at< std::uint32_t >( data, location.rva );
+
+                    if ( !count )
+                        break;
+
+                    const auto descriptors = at< memory_descriptor_t >( data, location.rva + sizeof( std::uint32_t ), *count );
+
+                    if ( !descriptors )
+                        break;
+
+                    for ( std::uint32_t j = 0; j < *count; ++j )
+                        _ranges.push_back( { descriptors[ j ].start_of_memory_range, descriptors[ j ].memory.data_size, descriptors[ j ].memory.rva } );
+
+                    break;
+                }
+                case stream_type_t::memory64_list:
+                {
+                    const auto list = at< memory64_list_t >( data, location.rva );
+
+                    if ( !list )
+                        break;
+
+                    const auto descriptors = at< memory_descriptor64_t >( data, location.rva + sizeof( memory64_list_t ), list->number_of_memory_ranges );
+
+                    if ( !descriptors )
+                        break;
+
+                    // The contents of all ranges are stored back to back, starting at the base offset.
+                    auto offset = list->base_rva;
+
+                    for ( std::uint64_t j = 0; j < list->number_of_memory_ranges; ++j )
+                    {
+                        _ranges.push_back( { descriptors[ j ].start_of_memory_range, descriptors[ j ].data_size, offset } );
+                        offset += descriptors[ j ].data_size;
+                    }
+
+                    break;
+                }
+                case stream_type_t::memory_info_list:
+                {
+                    const auto list = at< memory_info_list_t >( data, location.rva );
+
+                    if ( !list || list->size_of_entry < sizeof( memory_info_t ) )
+                        break;
+
+                    for ( std::uint64_t j = 0; j < list->number_of_entries; ++j )
+                    {
+                        const auto info = at< memory_info_t >( data, location.rva + list->size_of_header + j * list->size_of_entry );
+
+                        if ( !info )
+                            break;
+
+                        _regions.push_back( { info->base_address, info->region_size, info->state, info->protect } );
+                    }
+
+                    break;
+                }
+                default: break;
+            }
+        }
+
+        // Drop ranges whose contents are not (completely) in the file, e.g. because the dump was truncated.
+        std::erase_if( _ranges, [ & ]( const memory_range_t& range ) { return range.offset > data.size( ) || range.size > data.size( ) - range.offset; } );
+
+        std::sort( _ranges.begin( ), _ranges.end( ), []( const memory_range_t& a, const memory_range_t& b ) { return a.base < b.base; } );
+        std::sort( _regions.begin( ), _regions.end( ), []( const memory_region_t& a, const memory_region_t& b ) { return a.base < b.base; } );
+
+        return true;
+    }
+
+    const std::vector< module_info_t >& reader::modules( ) const noexcept
+    {
+        return _modules;
+    }
+
+    const std::vector< memory_range_t >& reader::ranges( ) const noexcept
+    {
+        return _ranges;
+    }
+
+    std::span< const std::uint8_t > reader::contents( const memory_range_t& range ) const noexcept
+    {
+        // Ranges that do not fit into the file were dropped while parsing.
+        return _file.data( ).subspan( static_cast< std::size_t >( range.offset ), static_cast< std::size_t >( range.size ) );
+    }
+
+    const std::vector< memory_region_t >& reader::regions( ) const noexcept
+    {
+        return _regions;
+    }
+
+    const module_info_t* reader::find_module( std::string_view name ) const noexcept
+    {
+        const auto it = std::find_if( _modules.begin( ), _modules.end( ), [ name ]( const module_info_t& m ) { return iequals( m.name, name ); } );
+
+        return it != _modules.end( ) ? &*it : nullptr;
+    }
+
+    std::optional< memory_region_t > reader::query( std::uint64_t address ) const noexcept
+    {
+        // Without a memory info stream, the captured ranges are the only regions that are known to be readable.
+        if ( _regions.empty( ) )
+        {
+            auto it = std::upper_bound(
+                _ranges.begin( ), _ranges.end( ), address, []( std::uint64_t value, const memory_range_t& range ) { return value < range.base; } );
+
+            if ( it == _ranges.begin( ) || address - ( --it )->base >= it->size )
+                return std::nullopt;
+
+            return memory_region_t{ it->base, it->size, MEM_STATE_COMMIT, 0x02 };
+        }
+
+        auto it = std::upper_bound(
+            _regions.begin( ), _regions.end( ), address, []( std::uint64_t value, const memory_region_t& region ) { return value < region.base; } );
+
+        if ( it == _regions.begin( ) || address - ( --it )->base >= it->size )
+            return std::nullopt;
+
+        return *it;
+    }
+
+    std::size_t reader::read( std::uint64_t address, std::span< std::uint8_t > out ) const noexcept
+    {
+        auto it = std::upper_bound(
+            _ranges.begin( ), _ranges.end( ), address, []( std::uint64_t value, const memory_range_t& range ) { return value < range.base; } );
+
+        if ( it == _ranges.begin( ) )
+            return 0;
+
+        --it;
+
+        std::size_t done = 0;
+
+        // Ranges are usually split at region boundaries, so keep reading as long as they are adjacent.
+        while ( done < out.size( ) && it != _ranges.end( ) )
+        {
+            const auto current = address + done;
+
+            if ( current < it->base || current - it->base >= it->size )
+                break;
+
+            const auto skip = current - it->base;
+            const auto count = std::min< std::uint64_t >( it->size - skip, out.size( ) - done );
+
+            std::memcpy( out.data( ) + done, _file.data( ).data( ) + it->offset + skip, static_cast< std::size_t >( count ) );
+
+            done += static_cast< std::size_t >( count );
+            ++it;
+        }
+
+        return done;
+    }
+}  // namespace vulkan::minidump
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include "pass_manager.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+namespace vulkan
+{
+    namespace
+    {
+        /// <summary>
+        /// Returns whether two passes must not run concurrently.
+        /// </summary>
+        bool conflicts( const pass_t& a, const pass_t& b ) noexcept
+        {
+            return any( a.writes & ( b.reads | b.writes ) ) || any( b.writes & a.reads );
+        }
+    }  // namespace
+
+    void pass_manager::add( pass_t pass )
+    {
+        _passes.push_back( std::move( pass ) );
+        _elapsed.emplace_back( );
+    }
+
+    void pass_manager::run( dumper& d, std::stop_token stop_token, const std::function< void( const pass_t& ) >& started )
+    {
+        const auto count = _passes.size( );
+
+        std::vector< bool > done( count, false );
+        std::vector< std::vector< std::size_t > > dependencies( count );
+
+        // Every pass depends on the earlier passes it conflicts with.
+        for ( std::size_t i = 0; i < count; ++i )
+        {
+            for ( std::size_t j = 0; j < i; ++j )
+            {
+                if ( conflicts( _passes[ j ], _passes[ i ] ) )
+                    dependencies[ i ].push_back( j );
+            }
+        }
+
+        std::size_t remaining = count;
+
+        while ( remaining )
+        {
+            std::vector< std::size_t > wave;
+
+            for ( std::size_t i = 0; i < count; ++i )
+            {
+                if ( !done[ i ] && std::all_of( dependencies[ i ].begin( ), dependencies[ i ].end( ), [ & ]( std::size_t j ) { return done[ j ]; } ) )
+                    wave.push_back( i );
+            }
+
+            std::vector< std::size_t > runnable;
+
+            for ( const auto i : wave )
+            {
+                const auto& pass = _passes[ i ];
+
+                if ( !pass.enabled || pass.enabled( d ) )
+                    runnable.push_back( i );
+            }
+
+            std::vector< std::exception_ptr > errors( runnable.size( ) );
+
+            const auto execute = [ & ]( std::size_t slot )
+            {
+                const auto i = runnable[ slot ];
+                const auto start = std::chrono::steady_clock::now( );
+
+                try
+                {
+                    if ( started )
+                        started( _passes[ i ] );
+
+                    _passes[ i ].run( d, stop_token );
+                }
+                catch ( ... )
+                {
+                    errors[ slot ] = std::current_exception( );
+                }
+
+                _elapsed[ i ] = std::chrono::steady_clock::now( ) - start;
+            };
+
+            if ( runnable.size( ) == 1 )
+                execute( 0 );
+            else if ( !runnable.empty( ) )
+            {
+                std::vector< std::jthread > workers;
+                workers.reserve( runnable.size( ) );
+
+                for ( std::size_t slot = 0; slot < runnable.size( ); ++slot )
+                    workers.emplace_back( execute, slot );
+            }
+
+            for ( std::size_t slot = 0; slot < runnable.size( ); ++slot )
+            {
+                if ( errors[ slot ] )
+                    std::rethrow_exception( errors[ slot ] );
+
+                const auto& pass = _passes[ runnable[ slot ] ];
+
+                spdlog::debug(
+                    "Pass \"{}\" finished in {:.3f} ms",
+                    pass.name,
+                    std::chrono::duration< double, std::milli >( _elapsed[ runnable[ slot ] ] ).count( ) );
+            }
+
+            for ( const auto i : wave )
+                done[ i ] = true;
+
+            remaining -= wave.size( );
+        }
+    }
+
+    const std::vector< pass_t >& pass_manager::passes( ) const noexcept
+    {
+        return _passes;
+    }
+
+    std::chrono::steady_clock::duration pass_manager::elapsed( std::string_view name ) const noexcept
+    {
+        for ( std::size_t i = 0; i < _passes.size( ); ++i )
+        {
+            if ( _passes[ i ].name == name )
+                return _elapsed[ i ];
+        }
+
+        return { };
+    }
+}  // namespace vulkan
\ No newline at end of file
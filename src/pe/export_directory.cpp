@@ -0,0 +1,162 @@
+#include "pe/export_directory.hpp"
+
+#include <algorithm>
+
+#include "pe/image.hpp"
+
+namespace vulkan::pe
+{
+    namespace
+    {
+        /// <summary>
+        /// Parses an export directory. `resolve` returns the bytes from a relative virtual address to the end of what is available, or
+        /// an empty span if the address is not backed by anything.
+        /// </summary>
+        template< typename Resolve >
+        void parse_exports(
+            Resolve resolve,
+            const data_directory_t &directory,
+            std::string &module_name,
+            std::vector< export_directory::export_t > &exports )
+        {
+            module_name.clear( );
+            exports.clear( );
+
+            if ( !directory.VirtualAddress || directory.Size < sizeof( export_directory_t ) )
+                return;
+
+            // Returns a pointer to `count` elements at the given address, or a null pointer if they are not backed by the bytes.
+            const auto at = [ & ]< typename T >( std::uint32_t rva, std::size_t count = 1 ) -> const T *
+            {
+                const auto bytes = resolve( rva );
+
+                if ( bytes.empty( ) || count * sizeof( T ) > bytes.size( ) )
+                    return nullptr;
+
+                return reinterpret_cast< const T * >( bytes.data( ) );
+            };
+
+            // Reads a null-terminated string, bounded by the end of the bytes.
+            const auto string_at = [ & ]( std::uint32_t rva ) -> std::string
+            {
+                const auto bytes = resolve( rva );
+                const auto begin = reinterpret_cast< const char * >( bytes.data( ) );
+
+                return { begin, std::find( begin, begin + bytes.size( ), '\0' ) };
+            };
+
+            const auto export_directory = at.template operator( )< export_directory_t >( directory.VirtualAddress );
+
+            if ( !export_directory )
+                return;
+
+            module_name = string_at( export_directory->Name );
+
+            const auto functions =
+                at.template operator( )< std::uint32_t >( export_directory->AddressOfFunctions, export_directory->NumberOfFunctions );
+
+            if ( !functions )
+                return;
+
+            exports.resize( export_directory->NumberOfFunctions );
+
+            for ( std::uint32_t i = 0; i < export_directory->NumberOfFunctions; ++i )
+            {
+                auto &entry = exports[ i ];
+                entry.ordinal = static_cast< std::uint16_t >( export_directory->Base + i );
+
+                // Exports that point back into the export directory are forwarded to another module.
+                if ( functions[ i ] >= directory.VirtualAddress && functions[ i ] < directory.VirtualAddress + directory.Size )
+                {
+                    entry.rva = 0;
+                    entry.forwarder = string_at( functions[ i ] );
+                }
+                else
+                    entry.rva = functions[ i ];
+            }
+
+            const auto names = at.template operator( )< std::uint32_t >( export_directory->AddressOfNames, export_directory->NumberOfNames );
+            const auto name_ordinals =
+                at.template operator( )< std::uint16_t >( export_directory->AddressOfNameOrdinals, export_directory->NumberOfNames );
+
+            if ( names && name_ordinals )
+            {
+                for ( std::uint32_t i = 0; i < export_directory->NumberOfNames; ++i )
+                {
+                    if ( name_ordinals[ i ] < exports.size( ) )
+                        exports[ name_ordinals[ i ] ].name = string_at( names[ i ] );
+                }
+            }
+
+            // Unused slots in the address table are not exports.
+            std::erase_if( exports, []( const export_directory::export_t &entry ) { return !entry.rva && entry.forwarder.empty( ); } );
+        }
+    }  // namespace
+
+    export_directory::export_directory( ) noexcept
+    {
+    }
+
+    void export_directory::refresh( const image *img ) noexcept
+    {
+        const auto &buffer = img->buffer( );
+
+        const auto resolve = [ & ]( std::uint32_t rva ) -> std::span< const std::uint8_t >
+        {
+            const auto offset = img->rva_to_offset( rva );
+
+            if ( !offset || offset >= buffer.size( ) )
+                return { };
+
+            return buffer.subspan( offset );
+        };
+
+        parse_exports( resolve, *img->data_directory( DIRECTORY_ENTRY_EXPORT ), _module_name, _exports );
+    }
+
+    std::vector< export_directory::export_t > export_directory::parse(
+        std::span< const std::uint8_t > bytes,
+        std::uint32_t base,
+        const data_directory_t &directory ) noexcept
+    {
+        const auto resolve = [ & ]( std::uint32_t rva ) -> std::span< const std::uint8_t >
+        {
+            if ( rva < base || rva - base >= bytes.size( ) )
+                return { };
+
+            return bytes.subspan( rva - base );
+        };
+
+        std::string module_name;
+        std::vector< export_t > exports;
+
+        parse_exports( resolve, directory, module_name, exports );
+
+        return exports;
+    }
+
+    std::string_view export_directory::module_name( ) const noexcept
+    {
+        return _module_name;
+    }
+
+    const std::vector< export_directory::export_t > &export_directory::exports( ) const noexcept
+    {
+        return _exports;
+    }
+
+    const export_directory::export_t *export_directory::find( std::string_view name ) const noexcept
+    {
+        const auto it = std::find_if( _exports.begin( ), _exports.end( ), [ name ]( const export_t &entry ) { return entry.name == name; } );
+
+        return it != _exports.end( ) ? &*it : nullptr;
+    }
+
+    const export_directory::export_t *export_directory::find( std::uint16_t ordinal ) const noexcept
+    {
+        const auto it =
+            std::lower_bound( _exports.begin( ), _exports.end( ), ordinal, []( const export_t &entry, std::uint16_t value ) { return entry.ordinal < value; } );
+
+        return it != _exports.end( ) && it->ordinal == ordinal ? &*it : nullptr;
+    }
+}  // namespace vulkan::pe
\ No newline at end of file
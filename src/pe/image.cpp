@@ -1,6 +1,10 @@
 #include "pe/image.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
+#include <type_traits>
 
 #include "pe/util.hpp"
 
@@ -8,35 +12,46 @@ namespace vulkan::pe
 {
     std::uint32_t image::compute_checksum( ) const noexcept
     {
-        std::uint32_t sum = 0;
+        return pe::compute_checksum( storage( ) );
+    }
 
-        const auto data = reinterpret_cast< std::uint32_t* >( _buffer.data( ) );
-        const auto size = _buffer.size( ) / sizeof( std::uint32_t );
+    bool image::is_stale( std::uint64_t& parsed ) const noexcept
+    {
+        if ( parsed == _epoch )
+            return false;
 
-        for ( std::size_t i = 0; i < size; ++i )
-        {
-            if ( ( sum += data[ i ] ) > 0xFFFF )
-                sum = ( sum & 0xFFFF ) + ( sum >> 0x10 );
-        }
+        parsed = _epoch;
+        return true;
+    }
 
-        if ( size % sizeof( std::uint32_t ) )
-        {
-            if ( ( sum += ( static_cast< std::uint16_t >( data[ size - 1 ] ) << 0x8 ) ) > 0xFFFF )
-                sum = ( sum & 0xFFFF ) + ( sum >> 0x10 );
-        }
+    image::image( const std::vector< std::uint8_t >& buffer, bool mapped ) : _buffer( buffer )
+    {
+        initialize( mapped );
+    }
 
-        return ~sum;
+    image::image( std::shared_ptr< io::mapped_output > mapping, bool mapped ) : _mapping( std::move( mapping ) )
+    {
+        initialize( mapped );
     }
 
-    image::image( const std::vector< std::uint8_t >& buffer, bool mapped ) : _buffer( buffer )
+    void image::initialize( bool mapped )
     {
         // Create the import directory.
         _import_directory = std::unique_ptr< pe::import_directory >( new pe::import_directory( ) );
 
-        if ( _is_valid = refresh( ) && mapped )
-        {
-            auto& headers = section_headers( );
+        // Create the relocation directory.
+        _relocation_directory = std::unique_ptr< pe::relocation_directory >( new pe::relocation_directory( ) );
 
+        // Create the export directory.
+        _export_directory = std::unique_ptr< pe::export_directory >( new pe::export_directory( ) );
+
+        if ( !( _is_valid = refresh( ) ) )
+            return;
+
+        auto& headers = section_headers( );
+
+        if ( mapped )
+        {
             // Because we're mapping the image, we need to set the raw data to the virtual address.
             for ( std::uint16_t i = 0; i < headers->count( ); ++i )
             {
@@ -45,25 +60,66 @@ namespace vulkan::pe
                 section->SizeOfRawData = section->Misc.VirtualSize;
             }
         }
+
+        headers->realign( );
+    }
+
+    std::span< std::uint8_t > image::storage( ) const noexcept
+    {
+        if ( _mapping )
+            return _mapping->data( );
+
+        return _buffer;
     }
 
-    std::unique_ptr< image > image::create( const wincpp::modules::module_t& module )
+    bool image::insert( std::size_t offset, std::span< const std::uint8_t > data )
     {
-        std::vector< std::uint8_t > buffer;
-        buffer.resize( module.size( ) );
+        if ( !_mapping )
+        {
+            _buffer.insert( _buffer.begin( ) + offset, data.begin( ), data.end( ) );
+            return true;
+        }
+
+        const auto size = _mapping->size( );
+        auto grown = std::make_shared< io::mapped_output >( _mapping->path( ), size + data.size( ), false );
 
-        // The header is the first region in the module.
-        const auto& header = *module.regions( ).begin( );
-        const auto header_size = header.size( );
+        if ( !grown->is_valid( ) )
+            return false;
+
+        const auto bytes = grown->data( ).data( );
 
-        header.read( buffer.data( ) );
+        std::memmove( bytes + offset + data.size( ), bytes + offset, size - offset );
+        std::copy( data.begin( ), data.end( ), bytes + offset );
 
-        return std::make_unique< image >( buffer, true );
+        _mapping = std::move( grown );
+        return true;
     }
 
-    std::vector< std::uint8_t >& image::buffer( ) const noexcept
+    std::span< std::uint8_t > image::buffer( ) noexcept
     {
-        return _buffer;
+        touch( );
+
+        return storage( );
+    }
+
+    std::span< const std::uint8_t > image::buffer( ) const noexcept
+    {
+        return storage( );
+    }
+
+    void image::release( ) const noexcept
+    {
+        if ( !_mapping || !_is_valid )
+            return;
+
+        const auto headers = align< std::size_t >( _nt_headers->OptionalHeader.SizeOfHeaders, PAGE_SIZE );
+
+        _mapping->release( headers, _mapping->size( ) - std::min( headers, _mapping->size( ) ) );
+    }
+
+    void image::touch( ) noexcept
+    {
+        ++_epoch;
     }
 
     std::unique_ptr< section_headers >& image::section_headers( ) const noexcept
@@ -73,15 +129,83 @@ namespace vulkan::pe
 
     std::unique_ptr< import_directory >& image::import_directory( ) const noexcept
     {
+        std::lock_guard lock( _parse_mutex );
+
+        if ( _is_valid && is_stale( _parsed.imports ) )
+            _import_directory->refresh( this );
+
         return _import_directory;
     }
 
-    PIMAGE_DATA_DIRECTORY image::data_directory( std::uint32_t id ) const noexcept
+    std::unique_ptr< relocation_directory >& image::relocation_directory( ) const noexcept
     {
-        return &_nt_headers->OptionalHeader.DataDirectory[ id ];
+        std::lock_guard lock( _parse_mutex );
+
+        if ( _is_valid && is_stale( _parsed.relocations ) )
+            _relocation_directory->refresh( this );
+
+        return _relocation_directory;
+    }
+
+    const std::unique_ptr< export_directory >& image::export_directory( ) const noexcept
+    {
+        std::lock_guard lock( _parse_mutex );
+
+        if ( _is_valid && is_stale( _parsed.exports ) )
+            _export_directory->refresh( this );
+
+        return _export_directory;
+    }
+
+    const std::vector< runtime_function_t >& image::runtime_functions( ) const noexcept
+    {
+        std::lock_guard lock( _parse_mutex );
+
+        if ( !_is_valid || !is_stale( _parsed.exceptions ) )
+            return _runtime_functions;
+
+        _runtime_functions.clear( );
+
+        const auto directory = data_directory( DIRECTORY_ENTRY_EXCEPTION );
+        const auto offset = rva_to_offset( directory->VirtualAddress );
+
+        const auto bytes = storage( );
+
+        if ( !directory->VirtualAddress || !offset || offset + directory->Size > bytes.size( ) )
+            return _runtime_functions;
+
+        const auto entries = reinterpret_cast< const runtime_function_t* >( bytes.data( ) + offset );
+
+        _runtime_functions.assign( entries, entries + directory->Size / sizeof( runtime_function_t ) );
+
+        return _runtime_functions;
     }
 
-    PIMAGE_SECTION_HEADER image::append_section( const std::string_view name, std::uint32_t characteristics, const std::span< std::uint8_t >& data )
+    std::uint32_t image::checksum( ) const noexcept
+    {
+        std::lock_guard lock( _parse_mutex );
+
+        if ( is_stale( _parsed.checksum ) )
+            _checksum = compute_checksum( );
+
+        return _checksum;
+    }
+
+    void image::update_checksum( ) noexcept
+    {
+        if ( !_is_valid )
+            return;
+
+        // Writing the checksum does not modify the image as far as the caches are concerned, so bypass `buffer`.
+        _nt_headers->OptionalHeader.CheckSum = checksum( );
+    }
+
+    data_directory_t* image::data_directory( std::uint32_t id ) const noexcept
+    {
+        return dispatch( _arch, [ & ]< typename Arch >( Arch ) { return &optional_header< Arch >( )->DataDirectory[ id ]; } );
+    }
+
+    section_header_t* image::append_section( const std::string_view name, std::uint32_t characteristics, const std::span< std::uint8_t >& data )
     {
         const auto file_alignment = _nt_headers->OptionalHeader.FileAlignment;
         const auto section_alignment = _nt_headers->OptionalHeader.SectionAlignment;
@@ -92,13 +216,13 @@ namespace vulkan::pe
         const auto& aligned_file_size = align< std::uint32_t >( static_cast< std::uint32_t >( data.size( ) ), file_alignment );
 
         // Create a new section header.
-        IMAGE_SECTION_HEADER section_header = { };
+        section_header_t section_header = { };
 
         // Copy the name into the section header.
         std::copy( name.begin( ), name.end( ), section_header.Name );
 
         // Set the virtual size to the size of the data.
-        section_header.SizeOfRawData = static_cast< std::uint32_t >( aligned_file_size + data.size( ) );
+        section_header.SizeOfRawData = aligned_file_size;
         section_header.Misc.VirtualSize = static_cast< std::uint32_t >( data.size( ) );
 
         // Set the characteristics of the section.
@@ -110,11 +234,19 @@ namespace vulkan::pe
         section_header.VirtualAddress = align( last_section->VirtualAddress + last_section->Misc.VirtualSize, section_alignment );
         section_header.PointerToRawData = align( last_section->PointerToRawData + last_section->SizeOfRawData, file_alignment );
 
+        // The raw data of the last section may end before the file alignment (or the buffer may be shorter than its raw size), so pad
+        // the buffer with zeros up to the new section. Anything after the last section (such as an overlay) is moved behind it.
+        const auto size = storage( ).size( );
+        const auto offset = std::min< std::size_t >( section_header.PointerToRawData, size );
+
+        std::vector< std::uint8_t > bytes( section_header.PointerToRawData - offset + aligned_file_size, 0x0 );
+        std::copy( data.begin( ), data.end( ), bytes.begin( ) + ( section_header.PointerToRawData - offset ) );
+
         // Append the section to the raw section headers.
         section_headers( )->append( section_header );
 
         // Update the image size.
-        _nt_headers->OptionalHeader.SizeOfImage += aligned_file_size;
+        _nt_headers->OptionalHeader.SizeOfImage += align( section_header.Misc.VirtualSize, section_alignment );
 
         // Update the NT headers.
         _nt_headers->FileHeader.NumberOfSections += 1;
@@ -122,22 +254,31 @@ namespace vulkan::pe
         _nt_headers->OptionalHeader.SizeOfCode += static_cast< std::uint32_t >( data.size( ) );
 
         // Insert the data into the buffer.
-        _buffer.insert( _buffer.begin( ) + section_header.PointerToRawData, data.begin( ), data.end( ) );
+        if ( !insert( offset, bytes ) )
+            return nullptr;
 
-        if ( _is_valid = refresh( ) )
-            return _section_headers->last( );
+        if ( !( _is_valid = refresh( ) ) )
+            return nullptr;
 
-        return nullptr;
+        _section_headers->realign( );
+
+        // Every section must still lie within the buffer, or a later append would be placed past its end.
+        const auto appended = _section_headers->last( );
+
+        if ( appended->PointerToRawData + appended->SizeOfRawData > storage( ).size( ) )
+            return nullptr;
+
+        return appended;
     }
 
-    PIMAGE_SECTION_HEADER image::append_section( const std::string_view name, std::uint32_t characteristics, std::uint32_t size )
+    section_header_t* image::append_section( const std::string_view name, std::uint32_t characteristics, std::uint32_t size )
     {
         std::vector< std::uint8_t > data( size, 0x0 );
 
         return append_section( name, characteristics, data );
     }
 
-    PIMAGE_SECTION_HEADER image::extend_section( const std::string_view name, std::uint32_t size )
+    section_header_t* image::extend_section( const std::string_view name, std::uint32_t size )
     {
         // Find the section header.
         const auto section = _section_headers->find( name.data( ) );
@@ -166,36 +307,67 @@ namespace vulkan::pe
         std::unique_ptr< std::uint8_t[] > data( new std::uint8_t[ size ] );
 
         // Insert the data into the buffer.
-        _buffer.insert( _buffer.begin( ) + section->PointerToRawData + old_size, data.get( ), data.get( ) + size );
+        const auto index = static_cast< std::uint16_t >( section - _section_headers->first( ) );
+
+        if ( !insert( section->PointerToRawData + old_size, { data.get( ), size } ) )
+            return nullptr;
 
+        // The insertion may have moved the buffer, so the section header has to be looked up again.
         if ( _is_valid = refresh( ) )
-            return section;
+        {
+            _section_headers->realign( );
+            return _section_headers->at( index );
+        }
 
         return nullptr;
     }
 
+    image_view image::snapshot( ) const
+    {
+        if ( _mapping )
+            return image_view( _mapping, _mapping->data( ) );
+
+        return image_view( std::vector< std::uint8_t >( _buffer ) );
+    }
+
+    bool image::commit( const image_view& view )
+    {
+        if ( !_mapping )
+            _buffer.assign( view.buffer( ).begin( ), view.buffer( ).end( ) );
+        else if ( view.buffer( ).size( ) != _mapping->size( ) )
+            return false;
+        else if ( view.buffer( ).data( ) != _mapping->data( ).data( ) )
+            std::memmove( _mapping->data( ).data( ), view.buffer( ).data( ), view.buffer( ).size( ) );
+
+        return _is_valid = refresh( );
+    }
+
     bool image::refresh( ) noexcept
     {
-        _dos_header = reinterpret_cast< PIMAGE_DOS_HEADER >( _buffer.data( ) );
+        touch( );
+
+        const auto bytes = storage( );
 
-        if ( _dos_header->e_magic != IMAGE_DOS_SIGNATURE )
+        if ( bytes.size( ) < sizeof( dos_header_t ) )
             return false;
 
-        _nt_headers = reinterpret_cast< PIMAGE_NT_HEADERS >( _buffer.data( ) + _dos_header->e_lfanew );
+        _dos_header = reinterpret_cast< dos_header_t* >( bytes.data( ) );
 
-        if ( !_nt_headers || _nt_headers->Signature != IMAGE_NT_SIGNATURE )
+        if ( _dos_header->e_magic != DOS_SIGNATURE )
             return false;
 
-        _section_headers.reset( new pe::section_headers( _nt_headers ) );
+        _nt_headers = reinterpret_cast< nt_headers_t* >( bytes.data( ) + _dos_header->e_lfanew );
 
-        if ( _nt_headers->OptionalHeader.Magic != IMAGE_NT_OPTIONAL_HDR_MAGIC )
+        if ( !_nt_headers || _nt_headers->Signature != NT_SIGNATURE )
             return false;
 
-        _import_directory->refresh( this );
+        _arch = arch_of( _nt_headers->OptionalHeader.Magic );
 
-        _nt_headers->OptionalHeader.CheckSum = compute_checksum( );
+        // The section headers only hold on to the NT headers, so they only need to be recreated if the buffer moved.
+        if ( !_section_headers || _section_headers->_nt_headers != _nt_headers )
+            _section_headers.reset( new pe::section_headers( _nt_headers ) );
 
-        return true;
+        return _arch != arch_t::unknown;
     }
 
     std::uint32_t image::rva_to_offset( std::uint32_t rva ) const noexcept
@@ -226,63 +398,104 @@ namespace vulkan::pe
 
     bool image::save_to_file( std::string_view filepath )
     {
+        update_checksum( );
+
+        std::error_code error;
+
+        if ( _mapping && std::filesystem::equivalent( _mapping->path( ), filepath, error ) )
+            return _mapping->flush( 0, _mapping->size( ) );
+
         std::ofstream file( filepath.data( ), std::ios::binary );
 
         if ( !file.is_open( ) )
             return false;
 
-        file.write( reinterpret_cast< const char* >( _buffer.data( ) ), _buffer.size( ) );
+        const auto bytes = storage( );
+
+        file.write( reinterpret_cast< const char* >( bytes.data( ) ), bytes.size( ) );
 
         file.close( );
 
         return true;
     }
 
-    void image::rebase( std::uintptr_t base ) const noexcept
+    template< typename Arch >
+    void image::rebase( std::uintptr_t base ) noexcept
     {
-        const auto relocation_directory = data_directory( IMAGE_DIRECTORY_ENTRY_BASERELOC );
-        const auto relocation_delta = base - image_base( );
+        using pointer_t = typename Arch::pointer_t;
+
+        const auto header = optional_header< Arch >( );
+        const auto relocation_directory = &header->DataDirectory[ DIRECTORY_ENTRY_BASERELOC ];
+        const auto relocation_delta = static_cast< pointer_t >( base - header->ImageBase );
 
         if ( !relocation_directory->VirtualAddress || !relocation_directory->Size )
             return;
 
         const auto relocation_offset = rva_to_offset( relocation_directory->VirtualAddress );
 
-        if ( !relocation_offset )
-            return;
+        const auto data = buffer( ).data( );
+        const auto size = storage( ).size( );
 
-        auto relocation = reinterpret_cast< PIMAGE_BASE_RELOCATION >( buffer( ).data( ) + relocation_offset );
+        if ( !relocation_offset || relocation_offset >= size )
+            return;
 
-        std::size_t offset = 0;
+        // Blocks are only walked as far as both the directory and the buffer reach.
+        const auto end = std::min< std::size_t >( relocation_directory->Size, size - relocation_offset );
 
-        while ( relocation->VirtualAddress && offset < relocation_directory->Size )
+        for ( std::size_t offset = 0; offset + sizeof( base_relocation_t ) <= end; )
         {
-            const auto& count = ( relocation->SizeOfBlock - sizeof( IMAGE_BASE_RELOCATION ) ) / sizeof( std::uint16_t );
+            const auto relocation = reinterpret_cast< base_relocation_t* >( data + relocation_offset + offset );
+            const auto block_size = relocation->SizeOfBlock;
+
+            // A corrupt or zero-padded directory would otherwise never advance, or run past its end.
+            if ( !relocation->VirtualAddress || block_size < sizeof( base_relocation_t ) || block_size > end - offset )
+                break;
+
+            const auto& count = ( block_size - sizeof( base_relocation_t ) ) / sizeof( std::uint16_t );
             const auto& entries = reinterpret_cast< std::uint16_t* >( relocation + 1 );
 
+            // A block covers a single page, which almost always lies within a single section, so the section of the block is looked up
+            // once and only the entries outside of it are translated on their own.
+            section_header_t* section = nullptr;
+
+            for ( std::uint16_t j = 0; j < _section_headers->count( ) && !section; ++j )
+            {
+                const auto candidate = _section_headers->at( j );
+
+                if ( relocation->VirtualAddress - candidate->VirtualAddress < candidate->Misc.VirtualSize )
+                    section = candidate;
+            }
+
             for ( std::size_t i = 0; i < count; i++ )
             {
-                const auto ptr_offset = rva_to_offset( relocation->VirtualAddress + ( entries[ i ] & 0xFFF ) );
+                const auto rva = relocation->VirtualAddress + ( entries[ i ] & 0xFFF );
+                const auto ptr_offset = section && rva - section->VirtualAddress < section->Misc.VirtualSize
+                                            ? section->PointerToRawData + ( rva - section->VirtualAddress )
+                                            : rva_to_offset( rva );
 
-                if ( !ptr_offset )
+                if ( !ptr_offset || ptr_offset + sizeof( pointer_t ) > size )
                     continue;
 
-                const auto ptr = buffer( ).data( ) + ptr_offset;
+                const auto ptr = data + ptr_offset;
                 const auto relocation_type = entries[ i ] >> 12;
 
+                // The pointer-sized relocation of the layout is by far the most common, so it is tested first.
+                if ( relocation_type == Arch::pointer_relocation )
+                {
+                    *reinterpret_cast< pointer_t* >( ptr ) += relocation_delta;
+                    continue;
+                }
+
                 switch ( relocation_type )
                 {
-                    case IMAGE_REL_BASED_ABSOLUTE: break;
-                    case IMAGE_REL_BASED_HIGH:
+                    case REL_BASED_ABSOLUTE: break;
+                    case REL_BASED_HIGH:
                         *reinterpret_cast< std::uint16_t* >( ptr ) += static_cast< std::uint16_t >( relocation_delta >> 16 );
                         break;
-                    case IMAGE_REL_BASED_LOW:
+                    case REL_BASED_LOW:
                         *reinterpret_cast< std::uint16_t* >( ptr ) += static_cast< std::uint16_t >( relocation_delta & 0xFFFF );
                         break;
-                    case IMAGE_REL_BASED_HIGHLOW:
-                        *reinterpret_cast< std::uint32_t* >( ptr ) += static_cast< std::uint32_t >( relocation_delta );
-                        break;
-                    case IMAGE_REL_BASED_HIGHADJ:
+                    case REL_BASED_HIGHADJ:
                     {
                         if ( i + 1 >= count )
                             break;
@@ -298,17 +511,29 @@ namespace vulkan::pe
                         *target = result >> 16;
                         break;
                     }
-                    case IMAGE_REL_BASED_DIR64: *reinterpret_cast< std::uint64_t* >( ptr ) += relocation_delta; break;
+                    case REL_BASED_HIGHLOW:
+                        // In PE32 images this is the pointer relocation, which was handled above.
+                        if constexpr ( std::is_same_v< Arch, pe64 > )
+                            *reinterpret_cast< std::uint32_t* >( ptr ) += static_cast< std::uint32_t >( relocation_delta );
+                        break;
                     default: break;
                 }
             }
 
-            relocation = reinterpret_cast< PIMAGE_BASE_RELOCATION >( reinterpret_cast< std::uint8_t* >( relocation ) + relocation->SizeOfBlock );
-
-            offset += relocation->SizeOfBlock;
+            offset += block_size;
         }
 
         // Update the image base.
-        _nt_headers->OptionalHeader.ImageBase = base;
+        header->ImageBase = static_cast< pointer_t >( base );
+
+        touch( );
+    }
+
+    void image::rebase( std::uintptr_t base ) noexcept
+    {
+        if ( !_is_valid )
+            return;
+
+        dispatch( _arch, [ & ]< typename Arch >( Arch ) { rebase< Arch >( base ); } );
     }
 }  // namespace vulkan::pe
\ No newline at end of file
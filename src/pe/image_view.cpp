@@ -0,0 +1,184 @@
+#include "pe/image_view.hpp"
+
+#include <algorithm>
+
+#include "pe/util.hpp"
+
+namespace vulkan::pe
+{
+    image_view::image_view( std::vector< std::uint8_t >&& buffer )
+        : image_view( std::make_shared< const std::vector< std::uint8_t > >( std::move( buffer ) ) )
+    {
+    }
+
+    image_view::image_view( std::shared_ptr< const std::vector< std::uint8_t > > buffer ) : image_view( buffer, *buffer )
+    {
+    }
+
+    image_view::image_view( std::shared_ptr< const void > owner, std::span< const std::uint8_t > buffer )
+        : _owner( std::move( owner ) ),
+          _buffer( buffer )
+    {
+        const auto data = _buffer;
+
+        if ( data.size( ) < sizeof( dos_header_t ) )
+            return;
+
+        const auto dos_header = reinterpret_cast< const dos_header_t* >( data.data( ) );
+
+        if ( dos_header->e_magic != DOS_SIGNATURE || dos_header->e_lfanew < 0 ||
+             static_cast< std::size_t >( dos_header->e_lfanew ) + sizeof( nt_headers32_t ) > data.size( ) )
+            return;
+
+        const auto nt_headers = reinterpret_cast< const nt_headers_t* >( data.data( ) + dos_header->e_lfanew );
+        const auto arch = arch_of( nt_headers->OptionalHeader.Magic );
+
+        if ( nt_headers->Signature != NT_SIGNATURE || arch == arch_t::unknown )
+            return;
+
+        // The 64-bit headers are larger, so their size can only be checked once the layout is known.
+        if ( arch == arch_t::pe64 && static_cast< std::size_t >( dos_header->e_lfanew ) + sizeof( nt_headers64_t ) > data.size( ) )
+            return;
+
+        const auto sections_offset = static_cast< std::size_t >( dos_header->e_lfanew ) + offsetof( nt_headers_t, OptionalHeader ) +
+                                     nt_headers->FileHeader.SizeOfOptionalHeader;
+
+        if ( sections_offset > data.size( ) )
+            return;
+
+        const auto count = std::min< std::size_t >(
+            nt_headers->FileHeader.NumberOfSections, ( data.size( ) - sections_offset ) / sizeof( section_header_t ) );
+
+        _nt_headers = nt_headers;
+        _arch = arch;
+        _sections = { reinterpret_cast< const section_header_t* >( data.data( ) + sections_offset ), count };
+    }
+
+    std::span< const std::uint8_t > image_view::buffer( ) const noexcept
+    {
+        return _buffer;
+    }
+
+    const section_header_t* image_view::find_section( std::string_view name ) const noexcept
+    {
+        for ( const auto& section : _sections )
+        {
+            const auto length = std::find( section.Name, section.Name + SIZEOF_SHORT_NAME, '\0' ) - section.Name;
+
+            if ( std::string_view( reinterpret_cast< const char* >( section.Name ), length ) == name )
+                return &section;
+        }
+
+        return nullptr;
+    }
+
+    const section_header_t* image_view::section_of( std::uint32_t rva ) const noexcept
+    {
+        for ( const auto& section : _sections )
+        {
+            if ( rva >= section.VirtualAddress && rva < section.VirtualAddress + section.Misc.VirtualSize )
+                return &section;
+        }
+
+        return nullptr;
+    }
+
+    data_directory_t image_view::data_directory( std::uint32_t id ) const noexcept
+    {
+        if ( !_nt_headers )
+            return { };
+
+        return dispatch(
+            _arch,
+            [ & ]< typename Arch >( Arch ) -> data_directory_t
+            {
+                const auto header = optional_header< Arch >( );
+
+                if ( id >= std::min< std::uint32_t >( header->NumberOfRvaAndSizes, NUMBEROF_DIRECTORY_ENTRIES ) )
+                    return { };
+
+                return header->DataDirectory[ id ];
+            } );
+    }
+
+    std::uint32_t image_view::rva_to_offset( std::uint32_t rva ) const noexcept
+    {
+        if ( const auto section = section_of( rva ) )
+            return section->PointerToRawData + ( rva - section->VirtualAddress );
+
+        return 0;
+    }
+
+    std::span< const std::uint8_t > image_view::bytes( std::uint32_t rva, std::size_t size ) const noexcept
+    {
+        if ( !_nt_headers )
+            return { };
+
+        std::size_t offset = 0, limit = 0;
+
+        if ( rva < _nt_headers->OptionalHeader.SizeOfHeaders )
+        {
+            offset = rva;
+            limit = _nt_headers->OptionalHeader.SizeOfHeaders;
+        }
+        else if ( const auto section = section_of( rva ) )
+        {
+            offset = section->PointerToRawData + ( rva - section->VirtualAddress );
+            limit = section->PointerToRawData + section->Misc.VirtualSize;
+        }
+        else
+            return { };
+
+        if ( offset + size > limit || offset + size > _buffer.size( ) )
+            return { };
+
+        return { _buffer.data( ) + offset, size };
+    }
+
+    std::span< const std::uint8_t > image_view::directory( std::uint32_t id ) const noexcept
+    {
+        const auto directory = data_directory( id );
+
+        if ( !directory.VirtualAddress || !directory.Size )
+            return { };
+
+        return bytes( directory.VirtualAddress, directory.Size );
+    }
+
+    std::span< const runtime_function_t > image_view::runtime_functions( ) const noexcept
+    {
+        const auto directory = data_directory( DIRECTORY_ENTRY_EXCEPTION );
+
+        return array< runtime_function_t >( directory.VirtualAddress, directory.Size / sizeof( runtime_function_t ) );
+    }
+
+    std::uint32_t image_view::compute_checksum( ) const noexcept
+    {
+        return pe::compute_checksum( buffer( ) );
+    }
+
+    image_editor::image_editor( const image_view& base ) : _base( base ), _buffer( base.buffer( ).begin( ), base.buffer( ).end( ) )
+    {
+    }
+
+    std::span< std::uint8_t > image_editor::bytes( std::uint32_t rva, std::size_t size ) noexcept
+    {
+        // The layout is shared with the base snapshot, so translate through it and apply the offset to our copy.
+        const auto data = _base.bytes( rva, size );
+
+        if ( data.empty( ) )
+            return { };
+
+        return { _buffer.data( ) + ( data.data( ) - _base.buffer( ).data( ) ), size };
+    }
+
+    image_view image_editor::publish( ) const&
+    {
+        return image_view( std::vector< std::uint8_t >( _buffer ) );
+    }
+
+    image_view image_editor::publish( ) &&
+    {
+        return image_view( std::move( _buffer ) );
+    }
+}  // namespace vulkan::pe
\ No newline at end of file
@@ -7,44 +7,69 @@
 
 namespace vulkan::pe
 {
-    import_directory::import_directory( ) noexcept
+    import_directory::import_directory( std::shared_ptr< std::pmr::memory_resource > resource ) noexcept
+        : _resource( std::move( resource ) ),
+          _imports( _resource ? _resource.get( ) : std::pmr::get_default_resource( ) ),
+          _keys( _imports.get_allocator( ) )
     {
+        calculate_import_sizes( );
+    }
+
+    void import_directory::refresh( const image* img ) noexcept
+    {
+        _import_data_directory = img->data_directory( DIRECTORY_ENTRY_IMPORT );
+        _iat_data_directory = img->data_directory( DIRECTORY_ENTRY_IAT );
+
+        dispatch( img->arch( ), [ & ]< typename Arch >( Arch ) { parse< Arch >( img ); } );
     }
 
-    void import_directory::refresh( image* img ) noexcept
+    template< typename Arch >
+    void import_directory::parse( const image* img ) noexcept
     {
-        _import_data_directory = img->data_directory( IMAGE_DIRECTORY_ENTRY_IMPORT );
-        _iat_data_directory = img->data_directory( IMAGE_DIRECTORY_ENTRY_IAT );
+        using thunk_t = typename Arch::thunk_t;
+
+        // The sizes of the added imports were computed with the previous entry size.
+        if ( _thunk_size != sizeof( thunk_t ) )
+        {
+            _thunk_size = sizeof( thunk_t );
+            calculate_import_sizes( );
+        }
+
+        if ( !_import_data_directory->VirtualAddress || !img->rva_to_offset( _import_data_directory->VirtualAddress ) )
+            return;
+
+        // The buffer is only read here, the pointers are kept for the callers that edit the directory in place.
+        const auto buffer = const_cast< std::uint8_t* >( img->buffer( ).data( ) );
 
         _import_descriptor =
-            reinterpret_cast< PIMAGE_IMPORT_DESCRIPTOR >( img->buffer( ).data( ) + img->rva_to_offset( _import_data_directory->VirtualAddress ) );
+            reinterpret_cast< import_descriptor_t* >( buffer + img->rva_to_offset( _import_data_directory->VirtualAddress ) );
 
-        _iat = reinterpret_cast< std::uintptr_t* >( img->buffer( ).data( ) + img->rva_to_offset( _iat_data_directory->VirtualAddress ) );
+        _iat = buffer + img->rva_to_offset( _iat_data_directory->VirtualAddress );
 
         // Parse the import directory
         while ( _import_descriptor->Name )
         {
             // Get the module name
-            const auto& module_name = reinterpret_cast< const char* >( img->buffer( ).data( ) + img->rva_to_offset( _import_descriptor->Name ) );
+            const auto& module_name = reinterpret_cast< const char* >( buffer + img->rva_to_offset( _import_descriptor->Name ) );
 
             // Get the import lookup table
-            const auto& lookup_table =
-                reinterpret_cast< PIMAGE_THUNK_DATA >( img->buffer( ).data( ) + img->rva_to_offset( _import_descriptor->OriginalFirstThunk ) );
+            const auto& lookup_table = reinterpret_cast< const thunk_t* >( buffer + img->rva_to_offset( _import_descriptor->OriginalFirstThunk ) );
 
-            // Get the import address table
-            const auto& address_table =
-                reinterpret_cast< PIMAGE_THUNK_DATA >( img->buffer( ).data( ) + img->rva_to_offset( _import_descriptor->FirstThunk ) );
-
-            // Iterate over both the lookup and address tables
+            // Iterate over the lookup table
             for ( std::size_t i = 0; lookup_table[ i ].u1.AddressOfData; ++i )
             {
+                // Imports by ordinal have no name to rebuild them from.
+                if ( lookup_table[ i ].u1.Ordinal & Arch::ordinal_flag )
+                    continue;
+
                 // Get the import name
                 const auto& import_name =
-                    reinterpret_cast< PIMAGE_IMPORT_BY_NAME >( img->buffer( ).data( ) + img->rva_to_offset( lookup_table[ i ].u1.AddressOfData ) )
+                    reinterpret_cast< import_by_name_t* >(
+                        buffer + img->rva_to_offset( static_cast< std::uint32_t >( lookup_table[ i ].u1.AddressOfData ) ) )
                         ->Name;
 
                 // Get the IAT RVA
-                const auto& iat_rva = static_cast< std::uintptr_t >( _import_descriptor->FirstThunk + ( i * sizeof( std::uintptr_t ) ) );
+                const auto& iat_rva = static_cast< std::uintptr_t >( _import_descriptor->FirstThunk + ( i * sizeof( thunk_t ) ) );
 
                 // Add the import to the list
                 add( module_name, import_name, iat_rva );
@@ -71,46 +96,46 @@ namespace vulkan::pe
             for ( const auto& import : imports )
             {
                 // Add the size of the import name
-                _api_and_module_names_size += sizeof( IMAGE_IMPORT_BY_NAME );
-                _api_and_module_names_size += import->import_name.size( ) + 1;
+                _api_and_module_names_size += sizeof( import_by_name_t );
+                _api_and_module_names_size += import.import_name.size( ) + 1;
 
                 // Add the import lookup table entry
-                _api_and_module_names_size += sizeof( std::uintptr_t );
+                _api_and_module_names_size += _thunk_size;
 
                 // Add the entry size
-                _iat_size += sizeof( std::uintptr_t );
+                _iat_size += _thunk_size;
             }
 
             // Add the size of the null terminator
-            _api_and_module_names_size += sizeof( std::uintptr_t ) * 2;
+            _api_and_module_names_size += _thunk_size * 2;
 
             // Add the size of the null terminator
-            _iat_size += sizeof( std::uintptr_t );
+            _iat_size += _thunk_size;
         }
 
         // Calculate the size of the import directory
-        _import_section_size = _iat_size + _api_and_module_names_size + ( sizeof( IMAGE_IMPORT_DESCRIPTOR ) * _import_descriptor_count );
+        _import_section_size = _iat_size + _api_and_module_names_size + ( sizeof( import_descriptor_t ) * _import_descriptor_count );
     }
 
-    PIMAGE_DATA_DIRECTORY import_directory::iat_data_directory( ) const noexcept
+    data_directory_t* import_directory::iat_data_directory( ) const noexcept
     {
         return _iat_data_directory;
     }
 
-    PIMAGE_DATA_DIRECTORY import_directory::import_data_directory( ) const noexcept
+    data_directory_t* import_directory::import_data_directory( ) const noexcept
     {
         return _import_data_directory;
     }
 
-    const std::list< std::shared_ptr< import_directory::import_t > > import_directory::imports( ) noexcept
+    std::pmr::vector< const import_directory::import_t* > import_directory::imports( ) const noexcept
     {
-        std::list< std::shared_ptr< import_t > > result;
+        std::pmr::vector< const import_t* > result( _imports.get_allocator( ) );
 
         for ( const auto& [ _, imports ] : _imports )
         {
             for ( const auto& import : imports )
             {
-                result.push_back( import );
+                result.push_back( &import );
             }
         }
 
@@ -120,38 +145,77 @@ namespace vulkan::pe
     void import_directory::clear( ) noexcept
     {
         _imports.clear( );
+        _keys.clear( );
+
+        calculate_import_sizes( );
     }
 
     void import_directory::add( const std::string_view module_name, const std::string_view import_name, std::uintptr_t iat_rva ) noexcept
     {
-        auto& import_list = _imports[ module_name.data( ) ];
+        _key.assign( module_name ).append( 1, '!' ).append( import_name );
 
         // Check if the import already exists
-        for ( const auto& import : import_list )
+        if ( _keys.contains( std::string_view( _key ) ) )
+            return;
+
+        _keys.emplace( _key );
+
+        auto it = _imports.find( module_name );
+        const auto inserted = it == _imports.end( );
+
+        if ( inserted )
+            it = _imports.emplace( std::piecewise_construct, std::forward_as_tuple( module_name ), std::forward_as_tuple( ) ).first;
+
+        it->second.emplace_back( module_name, import_name, iat_rva );
+
+        // Update the sizes (see `calculate_import_sizes`)
+        if ( inserted )
         {
-            if ( import->import_name == import_name )
-                return;
+            _import_descriptor_count += 1;
+            _api_and_module_names_size += module_name.size( ) + 1 + _thunk_size * 2;
+            _iat_size += _thunk_size;
         }
 
-        import_list.emplace_back( new import_t{ module_name, import_name, iat_rva } );
+        _api_and_module_names_size += sizeof( import_by_name_t ) + import_name.size( ) + 1 + _thunk_size;
+        _iat_size += _thunk_size;
 
-        // Update the sizes
-        calculate_import_sizes( );
+        _import_section_size = _iat_size + _api_and_module_names_size + ( sizeof( import_descriptor_t ) * _import_descriptor_count );
     }
 
     void import_directory::recompile( image* img, const std::string_view section_name ) noexcept
     {
+        dispatch( img->arch( ), [ & ]< typename Arch >( Arch ) { emit< Arch >( img, section_name ); } );
+    }
+
+    template< typename Arch >
+    void import_directory::emit( image* img, const std::string_view section_name ) noexcept
+    {
+        using thunk_t = typename Arch::thunk_t;
+
+        if ( _thunk_size != sizeof( thunk_t ) )
+        {
+            _thunk_size = sizeof( thunk_t );
+            calculate_import_sizes( );
+        }
+
         // Create a new section that will hold the new import directory
-        const auto& section = img->append_section( section_name, IMAGE_SCN_CNT_INITIALIZED_DATA | IMAGE_SCN_MEM_READ, _import_section_size );
+        const auto& section = img->append_section( section_name, SCN_CNT_INITIALIZED_DATA | SCN_MEM_READ, _import_section_size );
+
+        if ( !section )
+            return;
+
+        // Appending the section may have moved the buffer, so the data directories have to be looked up again.
+        _import_data_directory = img->data_directory( DIRECTORY_ENTRY_IMPORT );
+        _iat_data_directory = img->data_directory( DIRECTORY_ENTRY_IAT );
 
         // Get the section data
         auto data = img->buffer( ).data( ) + section->PointerToRawData;
 
         // Set the offsets
-        std::size_t iat_offset = 0, offset = _iat_size + _import_descriptor_count * sizeof( IMAGE_IMPORT_DESCRIPTOR );
+        std::size_t iat_offset = 0, offset = _iat_size + _import_descriptor_count * sizeof( import_descriptor_t );
 
         // Get the first import descriptor
-        auto import_descriptor = reinterpret_cast< PIMAGE_IMPORT_DESCRIPTOR >( data + _iat_size );
+        auto import_descriptor = reinterpret_cast< import_descriptor_t* >( data + _iat_size );
 
         // Iterate over the import pools
         for ( const auto& [ module_name, imports ] : _imports )
@@ -163,34 +227,34 @@ namespace vulkan::pe
             import_descriptor->OriginalFirstThunk = section->VirtualAddress + offset;
 
             // Get the lookup table for the current module
-            auto lookup_table = reinterpret_cast< PIMAGE_THUNK_DATA >( data + offset );
+            auto lookup_table = reinterpret_cast< thunk_t* >( data + offset );
 
             // Update the offset for the lookup table
-            offset += sizeof( IMAGE_THUNK_DATA ) * ( imports.size( ) + 2 );
+            offset += sizeof( thunk_t ) * ( imports.size( ) + 2 );
 
             // Iterate over the imports in the pool
             for ( const auto& import : imports )
             {
                 // Add the IAT entry for the import
-                *reinterpret_cast< std::uintptr_t* >( data + iat_offset ) = import->iat_rva;
+                *reinterpret_cast< typename Arch::pointer_t* >( data + iat_offset ) = static_cast< typename Arch::pointer_t >( import.iat_rva );
 
                 // Add the import by name structure
-                auto import_by_name = reinterpret_cast< PIMAGE_IMPORT_BY_NAME >( data + offset );
+                auto import_by_name = reinterpret_cast< import_by_name_t* >( data + offset );
 
                 // Set the hint to 0
                 import_by_name->Hint = 0;
 
                 // Set the name of the import
-                std::copy( import->import_name.begin( ), import->import_name.end( ), import_by_name->Name );
+                std::copy( import.import_name.begin( ), import.import_name.end( ), import_by_name->Name );
 
                 // Set the offset for the lookup table
                 lookup_table->u1.AddressOfData = section->VirtualAddress + offset;
 
                 // Update the IAT offset
-                iat_offset += sizeof( std::uintptr_t );
+                iat_offset += sizeof( thunk_t );
 
                 // Update the offset for the import by name structure
-                offset += sizeof( IMAGE_IMPORT_BY_NAME ) + import->import_name.size( );
+                offset += sizeof( import_by_name_t ) + import.import_name.size( );
 
                 // Update the lookup table
                 lookup_table++;
@@ -206,7 +270,7 @@ namespace vulkan::pe
             offset += module_name.size( ) + 2;
 
             // Update the IAT offset for the null terminator
-            iat_offset += sizeof( std::uintptr_t );
+            iat_offset += sizeof( thunk_t );
 
             // Increment the import descriptor
             import_descriptor++;
@@ -217,13 +281,20 @@ namespace vulkan::pe
         _iat_data_directory->Size = _iat_size;
 
         _import_data_directory->VirtualAddress = _iat_data_directory->VirtualAddress + _iat_data_directory->Size;
-        _import_data_directory->Size = _import_descriptor_count * sizeof( IMAGE_IMPORT_DESCRIPTOR );
+        _import_data_directory->Size = _import_descriptor_count * sizeof( import_descriptor_t );
+
+        // The section was written through a pointer, so make sure the image knows it changed.
+        img->touch( );
     }
 
-    import_directory::import_t::import_t( const std::string_view module_name, const std::string_view import_name, std::uintptr_t iat_rva ) noexcept
+    import_directory::import_t::import_t(
+        const std::string_view module_name,
+        const std::string_view import_name,
+        std::uintptr_t iat_rva,
+        const allocator_type& allocator ) noexcept
+        : module_name( module_name, allocator ),
+          import_name( import_name, allocator ),
+          iat_rva( iat_rva )
     {
-        this->module_name = module_name;
-        this->import_name = import_name;
-        this->iat_rva = iat_rva;
     }
 }  // namespace vulkan::pe
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "pe/relocation_directory.hpp"
+
+#include <algorithm>
+
+#include "pe/image.hpp"
+
+namespace vulkan::pe
+{
+    relocation_directory::relocation_directory( ) noexcept
+    {
+    }
+
+    void relocation_directory::refresh( const image* img ) noexcept
+    {
+        _relocations.clear( );
+        _is_valid = false;
+
+        const auto directory = img->data_directory( DIRECTORY_ENTRY_BASERELOC );
+
+        if ( !directory->VirtualAddress || !directory->Size )
+            return;
+
+        const auto directory_offset = img->rva_to_offset( directory->VirtualAddress );
+
+        if ( !directory_offset || directory_offset + directory->Size > img->buffer( ).size( ) )
+            return;
+
+        const auto data = img->buffer( ).data( ) + directory_offset;
+
+        std::size_t offset = 0;
+
+        while ( offset + sizeof( base_relocation_t ) <= directory->Size )
+        {
+            const auto block = reinterpret_cast< const base_relocation_t* >( data + offset );
+
+            // A block that is too small, runs past the directory or lies outside of the image means the directory is corrupt (or was
+            // never readable to begin with).
+            if ( block->SizeOfBlock < sizeof( base_relocation_t ) || offset + block->SizeOfBlock > directory->Size ||
+                 block->VirtualAddress >= img->size_of_image( ) )
+                return;
+
+            const auto count = ( block->SizeOfBlock - sizeof( base_relocation_t ) ) / sizeof( std::uint16_t );
+            const auto entries = reinterpret_cast< const std::uint16_t* >( block + 1 );
+
+            for ( std::size_t i = 0; i < count; ++i )
+            {
+                const auto type = static_cast< std::uint8_t >( entries[ i ] >> 12 );
+
+                if ( type == REL_BASED_ABSOLUTE )
+                    continue;
+
+                _relocations.push_back( { block->VirtualAddress + ( entries[ i ] & 0xFFF ), type } );
+
+                // The high-adjust relocation consumes the next entry as its parameter.
+                if ( type == REL_BASED_HIGHADJ )
+                    ++i;
+            }
+
+            offset += block->SizeOfBlock;
+        }
+
+        std::sort( _relocations.begin( ), _relocations.end( ), []( const relocation_t& a, const relocation_t& b ) { return a.rva < b.rva; } );
+
+        _is_valid = !_relocations.empty( );
+    }
+
+    const std::vector< relocation_directory::relocation_t >& relocation_directory::relocations( ) const noexcept
+    {
+        return _relocations;
+    }
+
+    void relocation_directory::clear( ) noexcept
+    {
+        _relocations.clear( );
+    }
+
+    void relocation_directory::add( std::uint32_t rva, std::uint8_t type ) noexcept
+    {
+        _relocations.push_back( { rva, type } );
+    }
+
+    void relocation_directory::recompile( image* img, const std::string_view section_name ) noexcept
+    {
+        auto relocations = _relocations;
+
+        std::sort( relocations.begin( ), relocations.end( ), []( const relocation_t& a, const relocation_t& b ) { return a.rva < b.rva; } );
+        relocations.erase(
+            std::unique( relocations.begin( ), relocations.end( ), []( const relocation_t& a, const relocation_t& b ) { return a.rva == b.rva; } ),
+            relocations.end( ) );
+
+        std::vector< std::uint8_t > data;
+
+        // Emit one block per page. Blocks must be 32-bit aligned, so odd blocks are padded with an absolute entry.
+        for ( auto it = relocations.begin( ); it != relocations.end( ); )
+        {
+            const auto page = it->rva & ~0xFFFu;
+            const auto last = std::find_if( it, relocations.end( ), [ page ]( const relocation_t& r ) { return ( r.rva & ~0xFFFu ) != page; } );
+
+            const auto count = static_cast< std::uint32_t >( std::distance( it, last ) );
+            const auto padded_count = count + ( count & 1 );
+
+            base_relocation_t block = { };
+            block.VirtualAddress = page;
+            block.SizeOfBlock = static_cast< std::uint32_t >( sizeof( base_relocation_t ) + padded_count * sizeof( std::uint16_t ) );
+
+            const auto block_offset = data.size( );
+            data.resize( block_offset + block.SizeOfBlock, 0 );
+
+            std::copy(
+                reinterpret_cast< std::uint8_t* >( &block ),
+                reinterpret_cast< std::uint8_t* >( &block ) + sizeof( base_relocation_t ),
+                data.begin( ) + block_offset );
+
+            auto entries = reinterpret_cast< std::uint16_t* >( data.data( ) + block_offset + sizeof( base_relocation_t ) );
+
+            for ( ; it != last; ++it )
+                *entries++ = static_cast< std::uint16_t >( ( it->type << 12 ) | ( it->rva & 0xFFF ) );
+        }
+
+        if ( data.empty( ) )
+            return;
+
+        const auto size = static_cast< std::uint32_t >( data.size( ) );
+
+        // Create a new section that will hold the relocation directory
+        const auto section =
+            img->append_section( section_name, SCN_CNT_INITIALIZED_DATA | SCN_MEM_READ | SCN_MEM_DISCARDABLE, data );
+
+        if ( !section )
+            return;
+
+        // Update the data directory
+        const auto directory = img->data_directory( DIRECTORY_ENTRY_BASERELOC );
+        directory->VirtualAddress = section->VirtualAddress;
+        directory->Size = size;
+
+        // The data directory was written through a pointer, so the directory is parsed back on the next access.
+        img->touch( );
+    }
+}  // namespace vulkan::pe
\ No newline at end of file
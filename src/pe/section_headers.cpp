@@ -1,6 +1,7 @@
 #include "pe/section_headers.hpp"
 
 #include <algorithm>
+#include <cstring>
 
 #include "pe/util.hpp"
 
@@ -8,9 +9,8 @@
 
 namespace vulkan::pe
 {
-    section_headers::section_headers( PIMAGE_NT_HEADERS nt_headers ) noexcept : _nt_headers( nt_headers )
+    section_headers::section_headers( nt_headers_t* nt_headers ) noexcept : _nt_headers( nt_headers )
     {
-        realign( );
     }
 
     void section_headers::realign( ) const noexcept
@@ -27,13 +27,13 @@ namespace vulkan::pe
         }
     }
 
-    void section_headers::append( IMAGE_SECTION_HEADER& header ) const noexcept
+    void section_headers::append( section_header_t& header ) const noexcept
     {
         auto last = at( count( ) );
 
         std::copy(
             reinterpret_cast< std::uint8_t* >( &header ),
-            reinterpret_cast< std::uint8_t* >( &header ) + sizeof( IMAGE_SECTION_HEADER ),
+            reinterpret_cast< std::uint8_t* >( &header ) + sizeof( section_header_t ),
             reinterpret_cast< std::uint8_t* >( last ) );
     }
 
@@ -45,7 +45,7 @@ namespace vulkan::pe
         {
             auto section = at( i );
 
-            if ( std::strncmp( reinterpret_cast< const char* >( section->Name ), name, IMAGE_SIZEOF_SHORT_NAME ) == 0 )
+            if ( std::strncmp( reinterpret_cast< const char* >( section->Name ), name, SIZEOF_SHORT_NAME ) == 0 )
             {
                 remove( i );
                 break;
@@ -61,18 +61,18 @@ namespace vulkan::pe
             auto src = at( j );
             auto dst = at( j - 1 );
 
-            std::memcpy( dst, src, sizeof( IMAGE_SECTION_HEADER ) );
+            std::memcpy( dst, src, sizeof( section_header_t ) );
         }
 
         // Zero out the now-redundant last section header.
         auto last = at( count( ) - 1 );
-        std::memset( last, 0, sizeof( IMAGE_SECTION_HEADER ) );
+        std::memset( last, 0, sizeof( section_header_t ) );
 
         // Update section count.
         _nt_headers->FileHeader.NumberOfSections -= 1;
     }
 
-    PIMAGE_SECTION_HEADER section_headers::find( const char* name ) const noexcept
+    section_header_t* section_headers::find( const char* name ) const noexcept
     {
         for ( std::uint16_t i = 0; i < count( ); ++i )
         {
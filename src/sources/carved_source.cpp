@@ -0,0 +1,69 @@
+#include "sources/carved_source.hpp"
+
+#include <algorithm>
+
+namespace vulkan::sources
+{
+    carved_source::carved_source( const source& inner, std::vector< module_t > carved ) : _inner( inner ), _carved( std::move( carved ) )
+    {
+        const auto listed = _inner.modules( );
+
+        std::erase_if(
+            _carved,
+            [ & ]( const module_t& module )
+            { return std::any_of( listed.begin( ), listed.end( ), [ & ]( const module_t& m ) { return m.address == module.address; } ); } );
+    }
+
+    bool carved_source::is_live( ) const noexcept
+    {
+        return _inner.is_live( );
+    }
+
+    std::chrono::steady_clock::time_point carved_source::now( ) const
+    {
+        return _inner.now( );
+    }
+
+    void carved_source::wait_until( std::chrono::steady_clock::time_point time ) const
+    {
+        _inner.wait_until( time );
+    }
+
+    std::vector< module_t > carved_source::modules( ) const
+    {
+        auto modules = _inner.modules( );
+        modules.insert( modules.end( ), _carved.begin( ), _carved.end( ) );
+
+        return modules;
+    }
+
+    std::optional< region_t > carved_source::query( std::uintptr_t address ) const
+    {
+        return _inner.query( address );
+    }
+
+    std::vector< region_t > carved_source::regions( std::uintptr_t address, std::size_t size ) const
+    {
+        return _inner.regions( address, size );
+    }
+
+    bool carved_source::read( std::uintptr_t address, std::span< std::uint8_t > out ) const
+    {
+        return _inner.read( address, out );
+    }
+
+    std::vector< export_t > carved_source::exports( const module_t& module ) const
+    {
+        return _inner.exports( module );
+    }
+
+    std::vector< api_set_t > carved_source::api_sets( ) const
+    {
+        return _inner.api_sets( );
+    }
+
+    std::vector< extent_t > carved_source::extents( ) const
+    {
+        return _inner.extents( );
+    }
+}  // namespace vulkan::sources
\ No newline at end of file
@@ -0,0 +1,49 @@
+#include "sources/export_cache.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <mutex>
+
+namespace vulkan::sources
+{
+    std::shared_ptr< const std::vector< export_t > > export_cache::exports( const source& source, const module_t& module )
+    {
+        key_t key{ module.path.empty( ) ? module.name : module.path, module.address, module.size, module.time_date_stamp, module.checksum };
+
+        // Paths are case insensitive on Windows.
+        std::transform(
+            std::get< 0 >( key ).begin( ),
+            std::get< 0 >( key ).end( ),
+            std::get< 0 >( key ).begin( ),
+            []( char c ) { return static_cast< char >( std::tolower( static_cast< unsigned char >( c ) ) ); } );
+
+        {
+            std::shared_lock lock( _mutex );
+
+            if ( const auto it = _entries.find( key ); it != _entries.end( ) )
+                return it->second;
+        }
+
+        // Enumerate outside of the lock, so that lookups of other modules are not blocked. If two dumps miss on the same module at once,
+        // the exports are enumerated twice and the first result is kept.
+        auto entry = std::make_shared< const std::vector< export_t > >( source.exports( module ) );
+
+        std::unique_lock lock( _mutex );
+
+        return _entries.try_emplace( std::move( key ), std::move( entry ) ).first->second;
+    }
+
+    std::size_t export_cache::size( ) const noexcept
+    {
+        std::shared_lock lock( _mutex );
+
+        return _entries.size( );
+    }
+
+    void export_cache::clear( ) noexcept
+    {
+        std::unique_lock lock( _mutex );
+
+        _entries.clear( );
+    }
+}  // namespace vulkan::sources
\ No newline at end of file
@@ -0,0 +1,287 @@
+#include "sources/export_resolver.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
+
+namespace vulkan::sources
+{
+    namespace
+    {
+        /// <summary>
+        /// The header of an API set schema (version 6).
+        /// </summary>
+        struct api_set_namespace_t
+        {
+            std::uint32_t version;
+            std::uint32_t size;
+            std::uint32_t flags;
+            std::uint32_t count;
+            std::uint32_t entry_offset;
+            std::uint32_t hash_offset;
+            std::uint32_t hash_factor;
+        };
+
+        /// <summary>
+        /// A contract of an API set schema.
+        /// </summary>
+        struct api_set_entry_t
+        {
+            std::uint32_t flags;
+            std::uint32_t name_offset;
+            std::uint32_t name_length;
+            std::uint32_t hashed_length;
+            std::uint32_t value_offset;
+            std::uint32_t value_count;
+        };
+
+        /// <summary>
+        /// A host of a contract. Hosts with an importing module name only apply to that module.
+        /// </summary>
+        struct api_set_value_t
+        {
+            std::uint32_t flags;
+            std::uint32_t name_offset;
+            std::uint32_t name_length;
+            std::uint32_t value_offset;
+            std::uint32_t value_length;
+        };
+
+        /// <summary>
+        /// Returns a name in lower case, as module names are case insensitive.
+        /// </summary>
+        std::string lower( std::string_view value )
+        {
+            std::string result( value );
+            std::transform(
+                result.begin( ),
+                result.end( ),
+                result.begin( ),
+                []( char c ) { return static_cast< char >( std::tolower( static_cast< unsigned char >( c ) ) ); } );
+
+            return result;
+        }
+
+        /// <summary>
+        /// Returns the lower case name of a module without its extension, which is how forwarder strings refer to it.
+        /// </summary>
+        std::string module_key( std::string_view name )
+        {
+            return lower( name.substr( 0, name.rfind( '.' ) ) );
+        }
+
+        /// <summary>
+        /// Returns whether a module key names an API set contract rather than a module.
+        /// </summary>
+        bool is_contract( std::string_view key ) noexcept
+        {
+            return key.starts_with( "api-" ) || key.starts_with( "ext-" );
+        }
+
+        /// <summary>
+        /// Returns the key of a contract without its minor version, which the loader ignores when it looks a contract up.
+        /// </summary>
+        std::string contract_key( std::string_view key )
+        {
+            return std::string( key.substr( 0, key.rfind( '-' ) ) );
+        }
+    }  // namespace
+
+    std::vector< api_set_t > parse_api_sets( std::span< const std::uint8_t > schema )
+    {
+        const auto read = [ & ]< typename T >( std::size_t offset, T& out )
+        {
+            if ( offset > schema.size( ) || schema.size( ) - offset < sizeof( T ) )
+                return false;
+
+            std::memcpy( &out, schema.data( ) + offset, sizeof( T ) );
+            return true;
+        };
+
+        // Names are UTF-16, but only ever hold ASCII characters.
+        const auto read_name = [ & ]( std::uint32_t offset, std::uint32_t length, std::string& out )
+        {
+            if ( offset > schema.size( ) || schema.size( ) - offset < length )
+                return false;
+
+            out.resize( length / 2 );
+
+            for ( std::size_t i = 0; i < out.size( ); ++i )
+                out[ i ] = static_cast< char >( schema[ offset + i * 2 ] );
+
+            return true;
+        };
+
+        api_set_namespace_t header;
+
+        if ( !read( 0, header ) || header.version != 6 )
+            return { };
+
+        std::vector< api_set_t > api_sets;
+
+        for ( std::size_t i = 0; i < header.count; ++i )
+        {
+            api_set_entry_t entry;
+            api_set_t api_set;
+
+            if ( !read( header.entry_offset + i * sizeof( entry ), entry ) || !read_name( entry.name_offset, entry.name_length, api_set.contract ) )
+                break;
+
+            // The default host is the one without an importing module.
+            for ( std::size_t j = 0; j < entry.value_count; ++j )
+            {
+                api_set_value_t value;
+
+                if ( !read( entry.value_offset + j * sizeof( value ), value ) || !value.value_length )
+                    continue;
+
+                if ( ( !value.name_length || api_set.host.empty( ) ) && !read_name( value.value_offset, value.value_length, api_set.host ) )
+                    continue;
+
+                if ( !value.name_length )
+                    break;
+            }
+
+            // Contracts without a host are not implemented on this system.
+            if ( !api_set.host.empty( ) )
+                api_sets.push_back( std::move( api_set ) );
+        }
+
+        return api_sets;
+    }
+
+    export_resolver::export_resolver( std::span< const std::span< const export_t > > tables, std::span< const api_set_t > api_sets )
+    {
+        // An export along with the key of its module.
+        struct node_t
+        {
+            const export_t* entry;
+            std::size_t module;
+        };
+
+        std::vector< node_t > nodes;
+        std::vector< std::string > modules;
+
+        // Exports by `module!name`, and exports that are not forwarded by name alone, for contracts that are not in the schema.
+        std::unordered_map< std::string, std::size_t > by_name, by_function;
+
+        for ( const auto& table : tables )
+        {
+            if ( table.empty( ) )
+                continue;
+
+            const auto module = modules.size( );
+            modules.push_back( module_key( table.front( ).module_name ) );
+
+            for ( const auto& entry : table )
+            {
+                by_name.try_emplace( modules[ module ] + '!' + entry.name, nodes.size( ) );
+
+                if ( entry.address && !is_contract( modules[ module ] ) )
+                    by_function.try_emplace( entry.name, nodes.size( ) );
+
+                nodes.push_back( { &entry, module } );
+            }
+        }
+
+        std::unordered_map< std::string, std::string > hosts;
+
+        for ( const auto& api_set : api_sets )
+            hosts.try_emplace( contract_key( module_key( api_set.contract ) ), module_key( api_set.host ) );
+
+        // Follows the forwarders of an export to the address they end at, along with the number of forwarders followed.
+        const auto resolve = [ & ]( std::size_t index ) -> std::optional< std::pair< std::uintptr_t, std::size_t > >
+        {
+            for ( std::size_t depth = 0; depth <= MAX_FORWARDER_DEPTH; ++depth )
+            {
+                const auto& entry = *nodes[ index ].entry;
+
+                if ( entry.address )
+                    return std::make_pair( entry.address, depth );
+
+                const auto dot = entry.forwarder.rfind( '.' );
+
+                if ( dot == std::string::npos || dot + 1 >= entry.forwarder.size( ) || entry.forwarder[ dot + 1 ] == '#' )
+                    return std::nullopt;
+
+                auto module = lower( std::string_view( entry.forwarder ).substr( 0, dot ) );
+                const auto function = entry.forwarder.substr( dot + 1 );
+
+                if ( is_contract( module ) )
+                {
+                    if ( const auto host = hosts.find( contract_key( module ) ); host != hosts.end( ) )
+                        module = host->second;
+                    else if ( const auto it = by_function.find( function ); it != by_function.end( ) )
+                    {
+                        index = it->second;
+                        continue;
+                    }
+                }
+
+                const auto it = by_name.find( module + '!' + function );
+
+                if ( it == by_name.end( ) )
+                    return std::nullopt;
+
+                index = it->second;
+            }
+
+            return std::nullopt;
+        };
+
+        // An export that resolves to an address, with the number of forwarders in between.
+        struct candidate_t
+        {
+            std::uintptr_t address;
+            std::size_t depth;
+            std::size_t index;
+        };
+
+        std::vector< candidate_t > candidates;
+        candidates.reserve( nodes.size( ) );
+
+        for ( std::size_t i = 0; i < nodes.size( ); ++i )
+        {
+            if ( is_contract( modules[ nodes[ i ].module ] ) )
+                continue;
+
+            if ( const auto resolved = resolve( i ) )
+                candidates.push_back( { resolved->first, resolved->second, i } );
+        }
+
+        std::sort(
+            candidates.begin( ),
+            candidates.end( ),
+            []( const candidate_t& a, const candidate_t& b )
+            { return std::tie( a.address, b.depth, a.index ) < std::tie( b.address, a.depth, b.index ); } );
+
+        for ( const auto& candidate : candidates )
+        {
+            if ( !_addresses.empty( ) && _addresses.back( ) == candidate.address )
+                continue;
+
+            const auto& entry = *nodes[ candidate.index ].entry;
+
+            _addresses.push_back( candidate.address );
+            _exports.push_back( { entry.module_name, entry.name, candidate.address, { } } );
+        }
+    }
+
+    const export_t* export_resolver::find( std::uintptr_t address ) const noexcept
+    {
+        const auto it = std::lower_bound( _addresses.begin( ), _addresses.end( ), address );
+
+        if ( it == _addresses.end( ) || *it != address )
+            return nullptr;
+
+        return &_exports[ static_cast< std::size_t >( it - _addresses.begin( ) ) ];
+    }
+
+    std::size_t export_resolver::size( ) const noexcept
+    {
+        return _addresses.size( );
+    }
+}  // namespace vulkan::sources
\ No newline at end of file
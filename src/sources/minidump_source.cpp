@@ -0,0 +1,55 @@
+#include "sources/minidump_source.hpp"
+
+namespace vulkan::sources
+{
+    minidump_source::minidump_source( std::string_view path ) noexcept : _reader( path )
+    {
+    }
+
+    bool minidump_source::is_valid( ) const noexcept
+    {
+        return _reader.is_valid( );
+    }
+
+    bool minidump_source::is_live( ) const noexcept
+    {
+        return false;
+    }
+
+    std::vector< module_t > minidump_source::modules( ) const
+    {
+        std::vector< module_t > modules;
+
+        for ( const auto& module : _reader.modules( ) )
+            modules.push_back(
+                { module.name, module.path, static_cast< std::uintptr_t >( module.base ), module.size, module.time_date_stamp, module.checksum } );
+
+        return modules;
+    }
+
+    std::optional< region_t > minidump_source::query( std::uintptr_t address ) const
+    {
+        const auto region = _reader.query( address );
+
+        if ( !region )
+            return std::nullopt;
+
+        return region_t{ static_cast< std::uintptr_t >( region->base ), static_cast< std::size_t >( region->size ), region->is_readable( ) };
+    }
+
+    bool minidump_source::read( std::uintptr_t address, std::span< std::uint8_t > out ) const
+    {
+        return _reader.read( address, out ) == out.size( );
+    }
+
+    std::vector< extent_t > minidump_source::extents( ) const
+    {
+        std::vector< extent_t > extents;
+        extents.reserve( _reader.ranges( ).size( ) );
+
+        for ( const auto& range : _reader.ranges( ) )
+            extents.push_back( { static_cast< std::uintptr_t >( range.base ), _reader.contents( range ) } );
+
+        return extents;
+    }
+}  // namespace vulkan::sources
\ No newline at end of file
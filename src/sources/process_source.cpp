@@ -0,0 +1,133 @@
+#include "sources/process_source.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include <winternl.h>
+
+#include "dumper.hpp"
+#include "sources/export_resolver.hpp"
+
+// clang-format off
+
+#include <DbgHelp.h>
+#pragma comment( lib, "Dbghelp.lib" )
+
+// clang-format on
+
+namespace vulkan::sources
+{
+    namespace
+    {
+        /// <summary>
+        /// Registers the pass that creates the minidump. The minidump only reads the target process, so it runs alongside the image passes.
+        /// </summary>
+        [[maybe_unused]] const bool minidump_pass_registered = []( )
+        {
+            dumper::register_pass( { "minidump",
+                                     resource_t::memory,
+                                     resource_t::none,
+                                     []( const dumper& d )
+                                     { return !d.settings( ).minidump_path( ).empty( ) && dynamic_cast< const process_source* >( &d.source( ) ); },
+                                     []( dumper& d, std::stop_token )
+                                     {
+                                         spdlog::info( "Creating minidump at \"{}\"", d.settings( ).minidump_path( ) );
+
+                                         static_cast< const process_source& >( d.source( ) ).save_minidump( d.settings( ).minidump_path( ) );
+                                     } } );
+
+            return true;
+        }( );
+    }  // namespace
+
+    process_source::process_source( wincpp::process_t& process ) noexcept : _process( process )
+    {
+    }
+
+    wincpp::process_t& process_source::process( ) const noexcept
+    {
+        return _process;
+    }
+
+    bool process_source::is_live( ) const noexcept
+    {
+        return true;
+    }
+
+    std::vector< module_t > process_source::modules( ) const
+    {
+        std::vector< module_t > modules;
+
+        for ( const auto& module : _process.module_factory.modules( ) )
+            modules.push_back( { module->name( ), module->path( ), module->address( ), module->size( ), 0, 0 } );
+
+        return modules;
+    }
+
+    std::optional< region_t > process_source::query( std::uintptr_t address ) const
+    {
+        const auto& regions = _process.memory_factory[ address ].regions( );
+
+        if ( regions.begin( ) == regions.end( ) )
+            return std::nullopt;
+
+        const auto& region = *regions.begin( );
+
+        return region_t{ region.address( ), region.size( ), !region.protection( ).has( wincpp::memory::protection_t::noaccess_t ) };
+    }
+
+    bool process_source::read( std::uintptr_t address, std::span< std::uint8_t > out ) const
+    {
+        const auto& data = _process.memory_factory.read( address, out.size( ) );
+
+        if ( !data )
+            return false;
+
+        std::copy( data.get( ), data.get( ) + out.size( ), out.begin( ) );
+        return true;
+    }
+
+    std::vector< api_set_t > process_source::api_sets( ) const
+    {
+#ifdef _WIN64
+        constexpr std::size_t API_SET_MAP_OFFSET = 0x68;
+#else
+        constexpr std::size_t API_SET_MAP_OFFSET = 0x38;
+#endif
+
+        const auto peb = reinterpret_cast< const std::uint8_t* >( NtCurrentTeb( )->ProcessEnvironmentBlock );
+
+        const std::uint8_t* schema = nullptr;
+        std::memcpy( &schema, peb + API_SET_MAP_OFFSET, sizeof( schema ) );
+
+        if ( !schema )
+            return { };
+
+        // The second field of the schema is its size.
+        std::uint32_t size = 0;
+        std::memcpy( &size, schema + sizeof( std::uint32_t ), sizeof( size ) );
+
+        return parse_api_sets( { schema, size } );
+    }
+
+    void process_source::save_minidump( std::string_view path ) const
+    {
+        const std::string file( path );
+
+        const auto& handle =
+            wincpp::core::handle_t::create( CreateFileA( file.c_str( ), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr ) );
+
+        if ( handle->native == INVALID_HANDLE_VALUE )
+            throw wincpp::core::error::from_win32( GetLastError( ) );
+
+        // The full memory of the process is included, so that the minidump can be rebuilt later with `--from-minidump`.
+        const auto minidump_type = static_cast< MINIDUMP_TYPE >(
+            MiniDumpWithFullMemory | MiniDumpWithFullMemoryInfo | MiniDumpWithHandleData | MiniDumpWithUnloadedModules | MiniDumpWithThreadInfo |
+            MiniDumpWithModuleHeaders );
+
+        if ( !MiniDumpWriteDump( _process.handle->native, _process.id( ), handle->native, minidump_type, nullptr, nullptr, nullptr ) )
+            throw wincpp::core::error::from_win32( GetLastError( ) );
+    }
+}  // namespace vulkan::sources
\ No newline at end of file
@@ -0,0 +1,166 @@
+#include "sources/recording_source.hpp"
+
+#include <algorithm>
+
+#include "pe/util.hpp"
+
+namespace vulkan::sources
+{
+    recording_source::recording_source( const source& inner, std::string_view path )
+        : _inner( inner ),
+          _file( std::string( path ), std::ios::binary ),
+          _start( inner.now( ) ),
+          _last( _start )
+    {
+        if ( !_file )
+            return;
+
+        const std::uint32_t header[] = { trace::SIGNATURE, trace::VERSION };
+        _file.write( reinterpret_cast< const char* >( header ), sizeof( header ) );
+    }
+
+    void recording_source::begin_event( trace::event_t kind ) const
+    {
+        const auto now = _inner.now( );
+
+        _file.put( static_cast< char >( kind ) );
+        trace::write_varint( _file, std::chrono::duration_cast< std::chrono::microseconds >( now - _last ).count( ) );
+
+        // Only advance by whole microseconds, so that rounding errors do not add up over long traces.
+        _last += std::chrono::duration_cast< std::chrono::microseconds >( now - _last );
+    }
+
+    bool recording_source::is_valid( ) const noexcept
+    {
+        return _file.good( );
+    }
+
+    bool recording_source::is_live( ) const noexcept
+    {
+        return _inner.is_live( );
+    }
+
+    std::chrono::steady_clock::time_point recording_source::now( ) const
+    {
+        return _inner.now( );
+    }
+
+    void recording_source::wait_until( std::chrono::steady_clock::time_point time ) const
+    {
+        _inner.wait_until( time );
+    }
+
+    std::vector< module_t > recording_source::modules( ) const
+    {
+        auto modules = _inner.modules( );
+
+        std::lock_guard lock( _mutex );
+
+        if ( _modules_recorded )
+            return modules;
+
+        for ( const auto& module : modules )
+        {
+            begin_event( trace::event_t::module );
+            trace::write_varint( _file, module.address );
+            trace::write_varint( _file, module.size );
+            trace::write_string( _file, module.name );
+            trace::write_string( _file, module.path );
+        }
+
+        _modules_recorded = true;
+        return modules;
+    }
+
+    std::optional< region_t > recording_source::query( std::uintptr_t address ) const
+    {
+        const auto region = _inner.query( address );
+        const auto readable = region && region->readable;
+        const auto first = address & ~static_cast< std::uintptr_t >( pe::PAGE_SIZE - 1 );
+
+        // The accessibility applies to every page of the region, and callers such as the region map rely on that instead of polling
+        // each page. Huge regions are only recorded up to a limit, since the pages of a module are all that is ever replayed.
+        auto last = first + pe::PAGE_SIZE;
+
+        if ( region && region->address + region->size > last )
+            last = std::min( region->address + region->size, first + MAX_REGION_PAGES * pe::PAGE_SIZE );
+
+        std::lock_guard lock( _mutex );
+
+        begin_event( trace::event_t::poll );
+        trace::write_varint( _file, address );
+
+        for ( auto page = first; page < last; page += pe::PAGE_SIZE )
+        {
+            // Only record the accessibility when it changes, polls are by far the most frequent events.
+            if ( const auto [ it, inserted ] = _readable.try_emplace( page, readable ); inserted || it->second != readable )
+            {
+                it->second = readable;
+
+                begin_event( trace::event_t::protect );
+                trace::write_varint( _file, page );
+                _file.put( static_cast< char >( readable ) );
+            }
+        }
+
+        return region;
+    }
+
+    bool recording_source::read( std::uintptr_t address, std::span< std::uint8_t > out ) const
+    {
+        if ( !_inner.read( address, out ) )
+            return false;
+
+        std::lock_guard lock( _mutex );
+
+        begin_event( trace::event_t::read );
+        trace::write_varint( _file, address );
+        trace::write_varint( _file, out.size( ) );
+        _file.write( reinterpret_cast< const char* >( out.data( ) ), static_cast< std::streamsize >( out.size( ) ) );
+
+        return true;
+    }
+
+    std::vector< export_t > recording_source::exports( const module_t& module ) const
+    {
+        const auto exports = _inner.exports( module );
+
+        std::lock_guard lock( _mutex );
+
+        begin_event( trace::event_t::exports );
+        trace::write_string( _file, module.name );
+        trace::write_varint( _file, exports.size( ) );
+
+        for ( const auto& e : exports )
+        {
+            trace::write_string( _file, e.name );
+            trace::write_varint( _file, e.address );
+            trace::write_string( _file, e.forwarder );
+        }
+
+        return exports;
+    }
+
+    std::vector< api_set_t > recording_source::api_sets( ) const
+    {
+        auto api_sets = _inner.api_sets( );
+
+        std::lock_guard lock( _mutex );
+
+        // The schema of a process never changes, so it is only recorded once.
+        if ( _api_sets_recorded )
+            return api_sets;
+
+        begin_event( trace::event_t::api_sets );
+        trace::write_varint( _file, api_sets.size( ) );
+
+        for ( const auto& api_set : api_sets )
+        {
+            trace::write_string( _file, api_set.contract );
+            trace::write_string( _file, api_set.host );
+        }
+
+        _api_sets_recorded = true;
+        return api_sets;
+    }
+}  // namespace vulkan::sources
\ No newline at end of file
@@ -0,0 +1,145 @@
+#include "sources/region_map.hpp"
+
+#include <algorithm>
+
+namespace vulkan::sources
+{
+    region_map::region_map(
+        const source& source,
+        std::uintptr_t address,
+        std::size_t size,
+        std::chrono::steady_clock::duration min_interval,
+        std::chrono::steady_clock::duration max_interval )
+        : _source( source ),
+          _address( address ),
+          _size( size ),
+          _min_interval( min_interval ),
+          _max_interval( max_interval ),
+          _entries( walk( address, size ) )
+    {
+        const auto now = _source.now( );
+
+        for ( auto& entry : _entries )
+        {
+            entry.interval = entry.mapped && entry.region.readable ? _max_interval : _min_interval;
+            entry.due = now + entry.interval;
+        }
+    }
+
+    std::vector< region_map::entry_t > region_map::walk( std::uintptr_t address, std::size_t size ) const
+    {
+        std::vector< entry_t > entries;
+
+        const auto end = address + size;
+        auto current = address;
+
+        for ( const auto& region : _source.regions( address, size ) )
+        {
+            const auto begin = std::max( region.address, current );
+            const auto last = std::min( region.address + region.size, end );
+
+            if ( last <= begin )
+                continue;
+
+            if ( begin > current )
+                entries.push_back( { { current, begin - current, false }, false, { }, { } } );
+
+            entries.push_back( { { begin, last - begin, region.readable }, true, { }, { } } );
+            current = last;
+        }
+
+        if ( current < end )
+            entries.push_back( { { current, end - current, false }, false, { }, { } } );
+
+        return entries;
+    }
+
+    std::optional< region_t > region_map::find( std::uintptr_t address ) const noexcept
+    {
+        if ( address < _address || address - _address >= _size )
+            return std::nullopt;
+
+        auto it = std::upper_bound(
+            _entries.begin( ), _entries.end( ), address, []( std::uintptr_t value, const entry_t& entry ) { return value < entry.region.address; } );
+
+        if ( it == _entries.begin( ) || !( --it )->mapped )
+            return std::nullopt;
+
+        return it->region;
+    }
+
+    std::size_t region_map::refresh( )
+    {
+        if ( !_source.is_live( ) )
+            return 0;
+
+        const auto now = _source.now( );
+
+        std::vector< entry_t > entries;
+        entries.reserve( _entries.size( ) );
+
+        std::size_t changed = 0;
+
+        for ( std::size_t i = 0; i < _entries.size( ); )
+        {
+            if ( _entries[ i ].due > now )
+            {
+                entries.push_back( _entries[ i++ ] );
+                continue;
+            }
+
+            // Adjacent entries that are due are walked together, so that a region that was split can merge again.
+            auto j = i;
+
+            while ( j < _entries.size( ) && _entries[ j ].due <= now )
+                ++j;
+
+            const auto begin = _entries[ i ].region.address;
+            const auto end = _entries[ j - 1 ].region.address + _entries[ j - 1 ].region.size;
+
+            // Both runs are sorted, so the old entry at the same address is found by walking along.
+            auto old = _entries.begin( ) + i;
+
+            for ( auto& entry : walk( begin, end - begin ) )
+            {
+                while ( old != _entries.begin( ) + j && old->region.address < entry.region.address )
+                    ++old;
+
+                const auto same = old != _entries.begin( ) + j && old->mapped == entry.mapped && old->region.size == entry.region.size &&
+                                  old->region.address == entry.region.address && old->region.readable == entry.region.readable;
+
+                if ( !same )
+                    ++changed;
+
+                if ( entry.mapped && entry.region.readable )
+                    entry.interval = _max_interval;
+                else if ( same )
+                    entry.interval = std::clamp( old->interval * 2, _min_interval, _max_interval );
+                else
+                    entry.interval = _min_interval;
+
+                entry.due = now + entry.interval;
+                entries.push_back( entry );
+            }
+
+            i = j;
+        }
+
+        _entries = std::move( entries );
+
+        return changed;
+    }
+
+    std::chrono::steady_clock::time_point region_map::next_due( ) const
+    {
+        if ( _entries.empty( ) )
+            return _source.now( );
+
+        return std::ranges::min( _entries, { }, &entry_t::due ).due;
+    }
+
+    std::size_t region_map::size( ) const noexcept
+    {
+        return _entries.size( );
+    }
+}  // namespace vulkan::sources
\ No newline at end of file
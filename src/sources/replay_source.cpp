@@ -0,0 +1,285 @@
+#include "sources/replay_source.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pe/util.hpp"
+#include "trace/format.hpp"
+
+namespace vulkan::sources
+{
+    namespace
+    {
+        constexpr std::uintptr_t page_of( std::uintptr_t address ) noexcept
+        {
+            return address & ~static_cast< std::uintptr_t >( pe::PAGE_SIZE - 1 );
+        }
+    }  // namespace
+
+    replay_source::replay_source( std::string_view path, std::chrono::nanoseconds step ) noexcept : _file( path )
+    {
+        if ( !_file.is_valid( ) || !( _is_valid = parse( ) ) )
+            return;
+
+        if ( step.count( ) > 0 )
+            _step = step.count( );
+    }
+
+    bool replay_source::parse( ) noexcept
+    {
+        const auto data = _file.data( );
+
+        if ( data.size( ) < sizeof( std::uint32_t ) * 2 )
+            return false;
+
+        const auto header = reinterpret_cast< const std::uint32_t* >( data.data( ) );
+
+        if ( header[ 0 ] != trace::SIGNATURE || !header[ 1 ] || header[ 1 ] > trace::VERSION )
+            return false;
+
+        const auto version = header[ 1 ];
+
+        std::size_t offset = sizeof( std::uint32_t ) * 2;
+        std::int64_t time = 0;
+        std::size_t operations = 0;
+
+        // A truncated trace (e.g. from a recording that was killed) is played back up to the last complete event.
+        while ( offset < data.size( ) )
+        {
+            const auto kind = static_cast< trace::event_t >( data[ offset++ ] );
+
+            std::uint64_t delta = 0, address = 0, size = 0;
+
+            if ( !trace::read_varint( data, offset, delta ) )
+                break;
+
+            time += static_cast< std::int64_t >( delta ) * 1000;
+
+            switch ( kind )
+            {
+                case trace::event_t::module:
+                {
+                    module_t module = { };
+
+                    if ( !trace::read_varint( data, offset, address ) || !trace::read_varint( data, offset, size ) ||
+                         !trace::read_string( data, offset, module.name ) || !trace::read_string( data, offset, module.path ) )
+                        return true;
+
+                    module.address = static_cast< std::uintptr_t >( address );
+                    module.size = static_cast< std::size_t >( size );
+
+                    _modules.push_back( std::move( module ) );
+                    break;
+                }
+                case trace::event_t::poll:
+                {
+                    if ( !trace::read_varint( data, offset, address ) )
+                        return true;
+
+                    ++operations;
+                    break;
+                }
+                case trace::event_t::protect:
+                {
+                    if ( !trace::read_varint( data, offset, address ) || offset >= data.size( ) )
+                        return true;
+
+                    _pages[ static_cast< std::uintptr_t >( address ) ].protect.emplace_back( time, data[ offset++ ] != 0 );
+                    break;
+                }
+                case trace::event_t::read:
+                {
+                    if ( !trace::read_varint( data, offset, address ) || !trace::read_varint( data, offset, size ) || size > data.size( ) - offset )
+                        return true;
+
+                    const auto index = _chunks.size( );
+                    _chunks.push_back( { time, static_cast< std::uintptr_t >( address ), static_cast< std::size_t >( size ), offset } );
+
+                    for ( auto page = page_of( _chunks.back( ).address ); page < address + size; page += pe::PAGE_SIZE )
+                        _pages[ page ].chunks.push_back( index );
+
+                    offset += static_cast< std::size_t >( size );
+                    ++operations;
+                    break;
+                }
+                case trace::event_t::exports:
+                {
+                    std::string module_name;
+                    std::uint64_t count = 0;
+
+                    if ( !trace::read_string( data, offset, module_name ) || !trace::read_varint( data, offset, count ) )
+                        return true;
+
+                    auto& exports = _exports[ module_name ];
+
+                    for ( std::uint64_t i = 0; i < count; ++i )
+                    {
+                        export_t e = { module_name, { }, 0, { } };
+
+                        if ( !trace::read_string( data, offset, e.name ) || !trace::read_varint( data, offset, address ) )
+                            return true;
+
+                        if ( version >= 2 && !trace::read_string( data, offset, e.forwarder ) )
+                            return true;
+
+                        e.address = static_cast< std::uintptr_t >( address );
+                        exports.push_back( std::move( e ) );
+                    }
+
+                    break;
+                }
+                case trace::event_t::api_sets:
+                {
+                    std::uint64_t count = 0;
+
+                    if ( !trace::read_varint( data, offset, count ) )
+                        return true;
+
+                    std::vector< api_set_t > api_sets;
+
+                    for ( std::uint64_t i = 0; i < count; ++i )
+                    {
+                        api_set_t api_set = { };
+
+                        if ( !trace::read_string( data, offset, api_set.contract ) || !trace::read_string( data, offset, api_set.host ) )
+                            return true;
+
+                        api_sets.push_back( std::move( api_set ) );
+                    }
+
+                    _api_sets = std::move( api_sets );
+                    break;
+                }
+                default: return true;
+            }
+
+            _duration = time;
+            _step = _duration / static_cast< std::int64_t >( std::max< std::size_t >( operations, 1 ) );
+        }
+
+        return true;
+    }
+
+    std::int64_t replay_source::tick( ) const noexcept
+    {
+        return _now.fetch_add( _step ) + _step;
+    }
+
+    bool replay_source::is_readable( const page_t& page, std::int64_t time ) const noexcept
+    {
+        // Pages that were never polled were read directly, so they are readable whenever there is something to read.
+        if ( page.protect.empty( ) )
+            return !page.chunks.empty( );
+
+        // Before the first poll, assume the page was in the state it was first observed in.
+        auto it = std::upper_bound(
+            page.protect.begin( ), page.protect.end( ), time, []( std::int64_t value, const auto& entry ) { return value < entry.first; } );
+
+        return it == page.protect.begin( ) ? it->second : std::prev( it )->second;
+    }
+
+    bool replay_source::is_valid( ) const noexcept
+    {
+        return _is_valid;
+    }
+
+    std::chrono::nanoseconds replay_source::duration( ) const noexcept
+    {
+        return std::chrono::nanoseconds( _duration );
+    }
+
+    bool replay_source::is_live( ) const noexcept
+    {
+        return _now.load( ) < _duration;
+    }
+
+    std::chrono::steady_clock::time_point replay_source::now( ) const
+    {
+        return std::chrono::steady_clock::time_point( std::chrono::nanoseconds( _now.load( ) ) );
+    }
+
+    void replay_source::wait_until( std::chrono::steady_clock::time_point time ) const
+    {
+        const auto target = std::chrono::duration_cast< std::chrono::nanoseconds >( time.time_since_epoch( ) ).count( );
+
+        // Reads from other threads tick the clock too, so it is only ever moved forward.
+        for ( auto current = _now.load( ); current < target && !_now.compare_exchange_weak( current, target ); )
+        {
+        }
+    }
+
+    std::vector< module_t > replay_source::modules( ) const
+    {
+        return _modules;
+    }
+
+    std::optional< region_t > replay_source::query( std::uintptr_t address ) const
+    {
+        const auto time = tick( );
+        const auto it = _pages.find( page_of( address ) );
+
+        if ( it == _pages.end( ) )
+            return std::nullopt;
+
+        return region_t{ page_of( address ), pe::PAGE_SIZE, is_readable( it->second, time ) };
+    }
+
+    bool replay_source::read( std::uintptr_t address, std::span< std::uint8_t > out ) const
+    {
+        const auto time = tick( );
+
+        for ( std::size_t done = 0; done < out.size( ); )
+        {
+            const auto current = address + done;
+            const auto count = std::min< std::size_t >( out.size( ) - done, page_of( current ) + pe::PAGE_SIZE - current );
+
+            const auto it = _pages.find( page_of( current ) );
+
+            if ( it == _pages.end( ) || !is_readable( it->second, time ) )
+                return false;
+
+            // Prefer the latest contents that had arrived by now, and fall back to the earliest ones.
+            const auto is_better = [ time ]( const chunk_t& chunk, const chunk_t& best )
+            {
+                if ( chunk.time <= time )
+                    return best.time > time || chunk.time > best.time;
+
+                return best.time > time && chunk.time < best.time;
+            };
+
+            const chunk_t* best = nullptr;
+
+            for ( const auto index : it->second.chunks )
+            {
+                const auto& chunk = _chunks[ index ];
+
+                if ( current < chunk.address || current + count > chunk.address + chunk.size )
+                    continue;
+
+                if ( !best || is_better( chunk, *best ) )
+                    best = &chunk;
+            }
+
+            if ( !best )
+                return false;
+
+            std::memcpy( out.data( ) + done, _file.data( ).data( ) + best->offset + ( current - best->address ), count );
+            done += count;
+        }
+
+        return true;
+    }
+
+    std::vector< export_t > replay_source::exports( const module_t& module ) const
+    {
+        if ( const auto it = _exports.find( module.name ); it != _exports.end( ) )
+            return it->second;
+
+        return source::exports( module );
+    }
+
+    std::vector< api_set_t > replay_source::api_sets( ) const
+    {
+        return _api_sets;
+    }
+}  // namespace vulkan::sources
\ No newline at end of file
@@ -0,0 +1,50 @@
+#include "sources/snapshot_source.hpp"
+
+#include <algorithm>
+
+namespace vulkan::sources
+{
+    snapshot_source::snapshot_source( std::string_view path, std::string_view name, std::uintptr_t base ) noexcept
+        : _file( path ),
+          _name( name ),
+          _base( base )
+    {
+    }
+
+    bool snapshot_source::is_valid( ) const noexcept
+    {
+        return _file.is_valid( );
+    }
+
+    bool snapshot_source::is_live( ) const noexcept
+    {
+        return false;
+    }
+
+    std::vector< module_t > snapshot_source::modules( ) const
+    {
+        return { { _name, _name, _base, _file.size( ), 0, 0 } };
+    }
+
+    std::optional< region_t > snapshot_source::query( std::uintptr_t address ) const
+    {
+        if ( address < _base || address - _base >= _file.size( ) )
+            return std::nullopt;
+
+        return region_t{ _base, _file.size( ), true };
+    }
+
+    bool snapshot_source::read( std::uintptr_t address, std::span< std::uint8_t > out ) const
+    {
+        if ( address < _base || address - _base > _file.size( ) || out.size( ) > _file.size( ) - ( address - _base ) )
+            return false;
+
+        std::copy_n( _file.data( ).data( ) + ( address - _base ), out.size( ), out.begin( ) );
+        return true;
+    }
+
+    std::vector< extent_t > snapshot_source::extents( ) const
+    {
+        return { { _base, _file.data( ) } };
+    }
+}  // namespace vulkan::sources
\ No newline at end of file
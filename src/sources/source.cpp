@@ -0,0 +1,118 @@
+#include "sources/source.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <thread>
+
+#include "pe/export_directory.hpp"
+#include "pe/image_view.hpp"
+#include "pe/util.hpp"
+
+namespace vulkan::sources
+{
+    std::chrono::steady_clock::time_point source::now( ) const
+    {
+        return std::chrono::steady_clock::now( );
+    }
+
+    void source::wait_until( std::chrono::steady_clock::time_point time ) const
+    {
+        std::this_thread::sleep_until( time );
+    }
+
+    std::vector< region_t > source::regions( std::uintptr_t address, std::size_t size ) const
+    {
+        std::vector< region_t > regions;
+
+        for ( auto current = address; current < address + size; )
+        {
+            const auto region = query( current );
+
+            // Unmapped pages are stepped over one at a time, since nothing is known about where the next region starts.
+            if ( !region || !region->size || region->address + region->size <= current )
+            {
+                current = ( current & ~static_cast< std::uintptr_t >( pe::PAGE_SIZE - 1 ) ) + pe::PAGE_SIZE;
+                continue;
+            }
+
+            regions.push_back( *region );
+            current = region->address + region->size;
+        }
+
+        return regions;
+    }
+
+    std::vector< export_t > source::exports( const module_t& module ) const
+    {
+        std::vector< std::uint8_t > buffer( pe::PAGE_SIZE );
+
+        if ( module.size < pe::PAGE_SIZE || !read( module.address, buffer ) )
+            return { };
+
+        const pe::image_view headers( std::move( buffer ) );
+
+        if ( !headers.is_valid( ) )
+            return { };
+
+        const auto directory = headers.data_directory( pe::DIRECTORY_ENTRY_EXPORT );
+
+        if ( !directory.VirtualAddress || !directory.Size || directory.VirtualAddress >= module.size )
+            return { };
+
+        // Linkers emit the names and forwarder strings of the exports inside of the directory, so only its pages are read rather than the
+        // whole module. Not all of them have to be accessible.
+        const auto first = directory.VirtualAddress & ~( pe::PAGE_SIZE - 1 );
+        const auto end = std::min< std::size_t >( static_cast< std::size_t >( directory.VirtualAddress ) + directory.Size, module.size );
+
+        std::vector< std::uint8_t > bytes( pe::align< std::size_t >( end - first, pe::PAGE_SIZE ) );
+
+        for ( std::size_t offset = 0; offset < bytes.size( ) && first + offset + pe::PAGE_SIZE <= module.size; offset += pe::PAGE_SIZE )
+            read( module.address + first + offset, std::span( bytes ).subspan( offset, pe::PAGE_SIZE ) );
+
+        std::vector< export_t > exports;
+
+        for ( const auto& entry : pe::export_directory::parse( bytes, first, directory ) )
+        {
+            if ( entry.name.empty( ) )
+                continue;
+
+            if ( entry.rva )
+                exports.push_back( { module.name, entry.name, module.address + entry.rva, { } } );
+            else
+                exports.push_back( { module.name, entry.name, 0, entry.forwarder } );
+        }
+
+        return exports;
+    }
+
+    std::vector< api_set_t > source::api_sets( ) const
+    {
+        return { };
+    }
+
+    std::vector< extent_t > source::extents( ) const
+    {
+        return { };
+    }
+
+    std::optional< module_t > source::find_module( std::string_view name ) const
+    {
+        const auto iequals = [ name ]( const module_t& module )
+        {
+            return std::equal(
+                module.name.begin( ),
+                module.name.end( ),
+                name.begin( ),
+                name.end( ),
+                []( char a, char b ) { return std::tolower( a ) == std::tolower( b ); } );
+        };
+
+        for ( auto& module : modules( ) )
+        {
+            if ( iequals( module ) )
+                return std::move( module );
+        }
+
+        return std::nullopt;
+    }
+}  // namespace vulkan::sources
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include "store/fingerprint.hpp"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "pe/image_view.hpp"
+#include "pe/util.hpp"
+
+namespace vulkan::store
+{
+    std::uint64_t hash( std::span< const std::uint8_t > bytes, std::uint64_t seed ) noexcept
+    {
+        for ( const auto byte : bytes )
+            seed = ( seed ^ byte ) * 0x100000001B3;
+
+        return seed;
+    }
+
+    std::optional< fingerprint_t > fingerprint( const sources::source& source, const sources::module_t& module )
+    {
+        std::vector< std::uint8_t > buffer( pe::PAGE_SIZE );
+
+        if ( module.size < buffer.size( ) || !source.read( module.address, buffer ) )
+            return std::nullopt;
+
+        const pe::image_view headers( std::move( buffer ) );
+
+        if ( !headers.is_valid( ) )
+            return std::nullopt;
+
+        const auto value = [ ]< typename T >( const T& field )
+        { return std::span( reinterpret_cast< const std::uint8_t* >( &field ), sizeof( field ) ); };
+
+        const auto nt_headers = headers.nt_headers( );
+        const auto sections = headers.sections( );
+
+        fingerprint_t result = { };
+
+        result.headers = hash( value( static_cast< std::uint64_t >( module.address ) ) );
+        result.headers = hash( value( nt_headers->FileHeader.TimeDateStamp ), result.headers );
+        result.headers = hash( value( nt_headers->OptionalHeader.SizeOfImage ), result.headers );
+        result.headers = hash( value( nt_headers->FileHeader.NumberOfSections ), result.headers );
+        result.headers = hash( { reinterpret_cast< const std::uint8_t* >( sections.data( ) ), sections.size_bytes( ) }, result.headers );
+
+        // The pages that can be sampled, as relative virtual addresses.
+        std::vector< std::uint32_t > candidates;
+
+        for ( const auto& section : sections )
+        {
+            if ( section.Characteristics & ( pe::SCN_MEM_WRITE | pe::SCN_MEM_EXECUTE | pe::SCN_CNT_CODE | pe::SCN_MEM_DISCARDABLE ) )
+                continue;
+
+            for ( std::uint32_t offset = 0; offset < section.Misc.VirtualSize; offset += pe::PAGE_SIZE )
+            {
+                if ( section.VirtualAddress + offset + pe::PAGE_SIZE <= module.size )
+                    candidates.push_back( section.VirtualAddress + offset );
+            }
+        }
+
+        result.pages = hash( { } );
+
+        std::array< std::uint8_t, pe::PAGE_SIZE > page;
+
+        const auto samples = std::min( candidates.size( ), FINGERPRINT_SAMPLES );
+
+        for ( std::size_t i = 0; i < samples; ++i )
+        {
+            const auto rva = candidates[ i * candidates.size( ) / samples ];
+
+            // Pages that cannot be read only contribute their address.
+            result.pages = hash( value( rva ), result.pages );
+
+            if ( source.read( module.address + rva, page ) )
+                result.pages = hash( page, result.pages );
+        }
+
+        return result;
+    }
+}  // namespace vulkan::store
\ No newline at end of file
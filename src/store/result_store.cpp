@@ -0,0 +1,137 @@
+#include "store/result_store.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <format>
+#include <fstream>
+#include <random>
+
+#include "io/mapped_file.hpp"
+#include "watch/delta.hpp"
+
+namespace vulkan::store
+{
+    namespace
+    {
+        /// <summary>
+        /// Returns a name for a temporary file that no other dump, in this process or another one, picks at the same time.
+        /// </summary>
+        std::string temporary_name( std::string_view key )
+        {
+            thread_local std::mt19937_64 random( std::random_device{ }( ) );
+
+            return std::format( "{}.{:016x}.tmp", key, random( ) );
+        }
+    }  // namespace
+
+    result_store::result_store( std::filesystem::path directory ) : _directory( std::move( directory ) )
+    {
+        std::error_code error;
+        std::filesystem::create_directories( _directory, error );
+    }
+
+    std::filesystem::path result_store::path( std::string_view key, std::string_view extension ) const
+    {
+        return _directory / std::format( "{}.{}", key, extension );
+    }
+
+    std::string result_store::key( std::string_view module_name, const fingerprint_t& fingerprint, std::uint64_t options )
+    {
+        std::string name( module_name );
+
+        // Module names are case insensitive.
+        std::transform(
+            name.begin( ),
+            name.end( ),
+            name.begin( ),
+            []( char c ) { return static_cast< char >( std::tolower( static_cast< unsigned char >( c ) ) ); } );
+
+        return std::format( "{}-{:016x}{:016x}{:016x}", name, fingerprint.headers, fingerprint.pages, options );
+    }
+
+    std::optional< result_store::entry_t > result_store::find( std::string_view key ) const
+    {
+        std::ifstream file( path( key, "entry" ) );
+
+        std::string field;
+        entry_t entry = { path( key, "image" ), path( key, "pages" ), 0 };
+
+        if ( !( file >> field >> entry.missing_pages ) || field != "missing_pages" )
+            return std::nullopt;
+
+        std::error_code error;
+
+        if ( !std::filesystem::is_regular_file( entry.image, error ) || !std::filesystem::is_regular_file( entry.pages, error ) )
+            return std::nullopt;
+
+        return entry;
+    }
+
+    std::unique_ptr< pe::image > result_store::load( const entry_t& entry ) const
+    {
+        const io::mapped_file file( entry.image.string( ) );
+
+        if ( !file.is_valid( ) )
+            return nullptr;
+
+        auto image = std::make_unique< pe::image >( std::vector< std::uint8_t >( file.data( ).begin( ), file.data( ).end( ) ), true );
+
+        if ( !image->is_valid( ) )
+            return nullptr;
+
+        return image;
+    }
+
+    std::optional< std::filesystem::path >
+    result_store::stage( std::string_view key, std::uintptr_t address, const pe::image& image, std::span< const std::uint32_t > pages ) const
+    {
+        auto staged = _directory / temporary_name( key );
+
+        if ( !watch::write_delta( staged.string( ), address, 0, image, pages ) )
+        {
+            std::error_code error;
+            std::filesystem::remove( staged, error );
+
+            return std::nullopt;
+        }
+
+        return staged;
+    }
+
+    bool result_store::commit( std::string_view key, pe::image& image, const std::filesystem::path& staged, std::size_t missing_pages ) const
+    {
+        const auto image_path = _directory / temporary_name( key );
+        const auto entry_path = _directory / temporary_name( key );
+
+        std::error_code error;
+
+        const auto discard = [ & ]( )
+        {
+            for ( const auto& file : { staged, image_path, entry_path } )
+                std::filesystem::remove( file, error );
+
+            return false;
+        };
+
+        if ( !image.save_to_file( image_path.string( ) ) )
+            return discard( );
+
+        {
+            std::ofstream file( entry_path );
+
+            if ( !( file << "missing_pages " << missing_pages << '\n' ) )
+                return discard( );
+        }
+
+        std::filesystem::rename( staged, path( key, "pages" ), error );
+
+        if ( !error )
+            std::filesystem::rename( image_path, path( key, "image" ), error );
+
+        // The entry goes last, since it is what makes the other files visible.
+        if ( !error )
+            std::filesystem::rename( entry_path, path( key, "entry" ), error );
+
+        return error ? discard( ) : true;
+    }
+}  // namespace vulkan::store
\ No newline at end of file
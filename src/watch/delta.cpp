@@ -0,0 +1,100 @@
+#include "watch/delta.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include "io/mapped_file.hpp"
+#include "pe/util.hpp"
+
+namespace vulkan::watch
+{
+    std::span< const std::uint8_t > delta_t::page( std::size_t index ) const noexcept
+    {
+        return std::span( bytes ).subspan( index * pe::PAGE_SIZE, pe::PAGE_SIZE );
+    }
+
+    bool write_delta(
+        std::string_view path,
+        std::uintptr_t address,
+        std::uint64_t sequence,
+        const pe::image& image,
+        std::span< const std::uint32_t > pages )
+    {
+        std::ofstream file( std::string( path ), std::ios::binary );
+
+        if ( !file )
+            return false;
+
+        const auto write = [ & ]< typename T >( const T& value ) { file.write( reinterpret_cast< const char* >( &value ), sizeof( value ) ); };
+
+        write( DELTA_SIGNATURE );
+        write( DELTA_VERSION );
+        write( static_cast< std::uint64_t >( address ) );
+        write( sequence );
+        write( static_cast< std::uint64_t >( pages.size( ) ) );
+
+        const auto buffer = image.buffer( );
+
+        for ( const auto rva : pages )
+        {
+            const auto offset = image.rva_to_offset( rva );
+
+            if ( !offset || offset + pe::PAGE_SIZE > buffer.size( ) )
+                return false;
+
+            write( rva );
+            file.write( reinterpret_cast< const char* >( buffer.data( ) + offset ), pe::PAGE_SIZE );
+        }
+
+        return file.good( );
+    }
+
+    std::optional< delta_t > read_delta( std::string_view path )
+    {
+        const io::mapped_file file( path );
+
+        if ( !file.is_valid( ) )
+            return std::nullopt;
+
+        const auto data = file.data( );
+
+        std::size_t offset = 0;
+
+        const auto read = [ & ]< typename T >( T& value )
+        {
+            if ( data.size( ) - offset < sizeof( value ) )
+                return false;
+
+            std::memcpy( &value, data.data( ) + offset, sizeof( value ) );
+            offset += sizeof( value );
+            return true;
+        };
+
+        std::uint32_t signature = 0, version = 0;
+        std::uint64_t address = 0, count = 0;
+
+        delta_t delta = { };
+
+        if ( !read( signature ) || !read( version ) || !read( address ) || !read( delta.sequence ) || !read( count ) ||
+             signature != DELTA_SIGNATURE || version != DELTA_VERSION )
+            return std::nullopt;
+
+        if ( count > ( data.size( ) - offset ) / ( sizeof( std::uint32_t ) + pe::PAGE_SIZE ) )
+            return std::nullopt;
+
+        delta.address = static_cast< std::uintptr_t >( address );
+        delta.pages.resize( static_cast< std::size_t >( count ) );
+        delta.bytes.resize( delta.pages.size( ) * pe::PAGE_SIZE );
+
+        for ( std::size_t i = 0; i < delta.pages.size( ); ++i )
+        {
+            read( delta.pages[ i ] );
+
+            std::memcpy( delta.bytes.data( ) + i * pe::PAGE_SIZE, data.data( ) + offset, pe::PAGE_SIZE );
+            offset += pe::PAGE_SIZE;
+        }
+
+        return delta;
+    }
+}  // namespace vulkan::watch
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "watch/watcher.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <utility>
+
+#include "analysis/page_classifier.hpp"
+
+namespace vulkan::watch
+{
+    watcher::watcher(
+        const sources::source& source,
+        std::uintptr_t address,
+        pe::image& image,
+        std::span< const std::uint32_t > pages,
+        std::span< const std::uint32_t > read_pages )
+        : _source( source ),
+          _address( address ),
+          _image( image ),
+          _regions( source, address, image.nt_headers( )->OptionalHeader.SizeOfImage )
+    {
+        std::vector< std::uint32_t > read( read_pages.begin( ), read_pages.end( ) );
+        std::sort( read.begin( ), read.end( ) );
+
+        _pages.reserve( pages.size( ) );
+
+        for ( const auto rva : pages )
+        {
+            page_t page{ rva, std::binary_search( read.begin( ), read.end( ), rva ), { } };
+
+            if ( page.known )
+            {
+                const auto bytes = std::span( std::as_const( _image ).buffer( ) ).subspan( _image.rva_to_offset( rva ), pe::PAGE_SIZE );
+
+                for ( std::size_t window = 0; window < WINDOW_COUNT; ++window )
+                    page.hashes[ window ] = hash( bytes.subspan( window * WINDOW_SIZE, WINDOW_SIZE ) );
+            }
+
+            _pages.push_back( page );
+        }
+
+        std::sort( _pages.begin( ), _pages.end( ), []( const page_t& a, const page_t& b ) { return a.rva < b.rva; } );
+    }
+
+    void watcher::update( page_t& page, std::span< const std::uint8_t > bytes )
+    {
+        for ( std::size_t window = 0; window < WINDOW_COUNT; ++window )
+            page.hashes[ window ] = hash( bytes.subspan( window * WINDOW_SIZE, WINDOW_SIZE ) );
+
+        page.known = true;
+
+        std::memcpy( _image.buffer( ).data( ) + _image.rva_to_offset( page.rva ), bytes.data( ), pe::PAGE_SIZE );
+    }
+
+    std::vector< std::uint32_t > watcher::poll( )
+    {
+        std::vector< std::uint32_t > changed;
+
+        _regions.refresh( );
+
+        const auto window = _round++ % WINDOW_COUNT;
+
+        std::array< std::uint8_t, pe::PAGE_SIZE > bytes;
+
+        for ( auto& page : _pages )
+        {
+            const auto address = _address + page.rva;
+            const auto region = _regions.find( address );
+
+            if ( !region || !region->readable )
+                continue;
+
+            // Pages that were read before only need their window checked. The rest of the page is only read once the window changed.
+            if ( page.known )
+            {
+                const auto sample = std::span( bytes ).subspan( window * WINDOW_SIZE, WINDOW_SIZE );
+
+                if ( !_source.read( address + window * WINDOW_SIZE, sample ) || hash( sample ) == page.hashes[ window ] )
+                    continue;
+            }
+
+            // Pages that look encrypted are left alone, so that code that was already read is not overwritten when it is encrypted again.
+            if ( !_source.read( address, bytes ) || analysis::classify_page( bytes ).type == analysis::page_class_t::encrypted )
+                continue;
+
+            update( page, bytes );
+            changed.push_back( page.rva );
+        }
+
+        if ( !changed.empty( ) )
+            _image.touch( );
+
+        return changed;
+    }
+
+    std::size_t watcher::size( ) const noexcept
+    {
+        return _pages.size( );
+    }
+
+    std::uint64_t watcher::hash( std::span< const std::uint8_t > window ) noexcept
+    {
+        constexpr std::uint64_t PRIME = 0x9E3779B97F4A7C15;
+
+        std::uint64_t lanes[ 4 ] = { PRIME, PRIME ^ 1, PRIME ^ 2, PRIME ^ 3 };
+
+        std::size_t offset = 0;
+
+        for ( ; offset + 4 * sizeof( std::uint64_t ) <= window.size( ); offset += 4 * sizeof( std::uint64_t ) )
+        {
+            for ( std::size_t lane = 0; lane < 4; ++lane )
+            {
+                std::uint64_t word;
+                std::memcpy( &word, window.data( ) + offset + lane * sizeof( word ), sizeof( word ) );
+
+                lanes[ lane ] = ( lanes[ lane ] ^ word ) * PRIME;
+                lanes[ lane ] ^= lanes[ lane ] >> 29;
+            }
+        }
+
+        auto result = lanes[ 0 ] ^ std::rotl( lanes[ 1 ], 16 ) ^ std::rotl( lanes[ 2 ], 32 ) ^ std::rotl( lanes[ 3 ], 48 );
+
+        for ( ; offset < window.size( ); ++offset )
+            result = ( result ^ window[ offset ] ) * PRIME;
+
+        return result ^ ( result >> 32 );
+    }
+}  // namespace vulkan::watch
\ No newline at end of file
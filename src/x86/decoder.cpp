@@ -0,0 +1,331 @@
+#include "x86/decoder.hpp"
+
+#include <array>
+
+namespace vulkan::x86
+{
+    namespace
+    {
+        // Each opcode is described by a single byte. The low bits hold the immediate kind, the high bits hold flags.
+        enum : std::uint8_t
+        {
+            N = 0x00,    // No operands encoded after the opcode.
+            I8 = 0x01,   // 8-bit immediate.
+            I16 = 0x02,  // 16-bit immediate.
+            IZ = 0x03,   // 16 or 32-bit immediate, depending on the operand size.
+            IV = 0x04,   // 16, 32 or 64-bit immediate, depending on the operand size.
+            IWB = 0x05,  // 16-bit immediate followed by an 8-bit immediate (`enter`).
+            MO = 0x06,   // Absolute memory offset (64 or 32-bit, depending on the address size).
+            R32 = 0x07,  // 32-bit relative branch target.
+            IMM_MASK = 0x07,
+
+            M = 0x08,   // Has a ModR/M byte.
+            G3 = 0x10,  // The immediate is only present if ModR/M.reg is 0 or 1 (`test` in group 3).
+            B = 0x20,   // Relative branch.
+            X = 0x40,   // Invalid in 64-bit mode (or handled separately).
+        };
+
+        // clang-format off
+
+        // The primary (one-byte) opcode map.
+        constexpr std::array< std::uint8_t, 256 > primary_map = {
+            /*       0       1       2       3       4       5       6       7       8       9       A       B       C       D       E       F */
+            /* 0 */ M,      M,      M,      M,      I8,     IZ,     X,      X,      M,      M,      M,      M,      I8,     IZ,     X,      X,
+            /* 1 */ M,      M,      M,      M,      I8,     IZ,     X,      X,      M,      M,      M,      M,      I8,     IZ,     X,      X,
+            /* 2 */ M,      M,      M,      M,      I8,     IZ,     X,      X,      M,      M,      M,      M,      I8,     IZ,     X,      X,
+            /* 3 */ M,      M,      M,      M,      I8,     IZ,     X,      X,      M,      M,      M,      M,      I8,     IZ,     X,      X,
+            /* 4 */ X,      X,      X,      X,      X,      X,      X,      X,      X,      X,      X,      X,      X,      X,      X,      X,
+            /* 5 */ N,      N,      N,      N,      N,      N,      N,      N,      N,      N,      N,      N,      N,      N,      N,      N,
+            /* 6 */ X,      X,      X,      M,      X,      X,      X,      X,      IZ,     M | IZ, I8,     M | I8, N,      N,      N,      N,
+            /* 7 */ B | I8, B | I8, B | I8, B | I8, B | I8, B | I8, B | I8, B | I8, B | I8, B | I8, B | I8, B | I8, B | I8, B | I8, B | I8, B | I8,
+            /* 8 */ M | I8, M | IZ, X,      M | I8, M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,
+            /* 9 */ N,      N,      N,      N,      N,      N,      N,      N,      N,      N,      X,      N,      N,      N,      N,      N,
+            /* A */ MO,     MO,     MO,     MO,     N,      N,      N,      N,      I8,     IZ,     N,      N,      N,      N,      N,      N,
+            /* B */ I8,     I8,     I8,     I8,     I8,     I8,     I8,     I8,     IV,     IV,     IV,     IV,     IV,     IV,     IV,     IV,
+            /* C */ M | I8, M | I8, I16,    N,      X,      X,      M | I8, M | IZ, IWB,    N,      I16,    N,      N,      I8,     X,      N,
+            /* D */ M,      M,      M,      M,      X,      X,      X,      N,      M,      M,      M,      M,      M,      M,      M,      M,
+            /* E */ B | I8, B | I8, B | I8, B | I8, I8,     I8,     I8,     I8,     B | R32,B | R32,X,      B | I8, N,      N,      N,      N,
+            /* F */ X,      N,      X,      X,      N,      N,      M | G3 | I8, M | G3 | IZ, N, N,   N,      N,      N,      N,      M,      M,
+        };
+
+        // The secondary (0F) opcode map.
+        constexpr std::array< std::uint8_t, 256 > secondary_map = {
+            /*       0       1       2       3       4       5       6       7       8       9       A       B       C       D       E       F */
+            /* 0 */ M,      M,      M,      M,      X,      N,      N,      N,      N,      N,      X,      N,      X,      M,      N,      M | I8,
+            /* 1 */ M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,
+            /* 2 */ M,      M,      M,      M,      X,      X,      X,      X,      M,      M,      M,      M,      M,      M,      M,      M,
+            /* 3 */ N,      N,      N,      N,      N,      N,      X,      N,      X,      X,      X,      X,      X,      X,      X,      X,
+            /* 4 */ M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,
+            /* 5 */ M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,
+            /* 6 */ M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,
+            /* 7 */ M | I8, M | I8, M | I8, M | I8, M,      M,      M,      N,      M,      M,      X,      X,      M,      M,      M,      M,
+            /* 8 */ B | R32,B | R32,B | R32,B | R32,B | R32,B | R32,B | R32,B | R32,B | R32,B | R32,B | R32,B | R32,B | R32,B | R32,B | R32,B | R32,
+            /* 9 */ M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,
+            /* A */ N,      N,      N,      M,      M | I8, M,      X,      X,      N,      N,      N,      M,      M | I8, M,      M,      M,
+            /* B */ M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M | I8, M,      M,      M,      M,      M,
+            /* C */ M,      M,      M | I8, M,      M | I8, M | I8, M | I8, M,      N,      N,      N,      N,      N,      N,      N,      N,
+            /* D */ M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,
+            /* E */ M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,
+            /* F */ M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,
+        };
+
+        // clang-format on
+
+        /// <summary>
+        /// Returns whether the byte is a legacy prefix.
+        /// </summary>
+        constexpr bool is_legacy_prefix( std::uint8_t byte ) noexcept
+        {
+            switch ( byte )
+            {
+                case 0x26:
+                case 0x2E:
+                case 0x36:
+                case 0x3E:
+                case 0x64:
+                case 0x65:
+                case 0x66:
+                case 0x67:
+                case 0xF0:
+                case 0xF2:
+                case 0xF3: return true;
+                default: return false;
+            }
+        }
+
+        /// <summary>
+        /// Returns the flags of an opcode in the given map.
+        /// </summary>
+        constexpr std::uint8_t flags_of( opcode_map_t map, std::uint8_t opcode ) noexcept
+        {
+            switch ( map )
+            {
+                case opcode_map_t::primary: return primary_map[ opcode ];
+                case opcode_map_t::secondary: return secondary_map[ opcode ];
+                case opcode_map_t::map_0f38: return M;
+                case opcode_map_t::map_0f3a: return M | I8;
+                default: return M;
+            }
+        }
+
+        /// <summary>
+        /// A small cursor over the instruction bytes that never reads past the architectural limit.
+        /// </summary>
+        struct cursor_t
+        {
+            std::span< const std::uint8_t > code;
+            std::size_t position = 0;
+
+            constexpr bool has( std::size_t count ) const noexcept
+            {
+                return position + count <= code.size( ) && position + count <= MAX_INSTRUCTION_LENGTH;
+            }
+
+            constexpr std::uint8_t peek( ) const noexcept
+            {
+                return code[ position ];
+            }
+
+            constexpr std::uint8_t next( ) noexcept
+            {
+                return code[ position++ ];
+            }
+        };
+    }  // namespace
+
+    std::optional< instruction_t > decode( std::span< const std::uint8_t > code ) noexcept
+    {
+        instruction_t insn;
+        cursor_t cursor{ code };
+
+        bool operand_size_override = false, address_size_override = false, rex_w = false;
+
+        // Consume the legacy prefixes.
+        while ( cursor.has( 1 ) && is_legacy_prefix( cursor.peek( ) ) )
+        {
+            const auto prefix = cursor.next( );
+
+            if ( prefix == 0x66 )
+                operand_size_override = true;
+            else if ( prefix == 0x67 )
+                address_size_override = true;
+        }
+
+        // The REX prefix must immediately precede the opcode.
+        if ( cursor.has( 1 ) && ( cursor.peek( ) & 0xF0 ) == 0x40 )
+            rex_w = cursor.next( ) & 0x08;
+
+        if ( !cursor.has( 1 ) )
+            return std::nullopt;
+
+        auto opcode = cursor.next( );
+        std::uint8_t flags = 0;
+
+        // Handle the VEX, EVEX and XOP encodings. They imply a ModR/M byte and select the opcode map themselves.
+        if ( opcode == 0xC4 || opcode == 0xC5 || opcode == 0x62 || ( opcode == 0x8F && cursor.has( 1 ) && ( cursor.peek( ) & 0x1F ) >= 8 ) )
+        {
+            const auto payload = opcode == 0xC5 ? 1 : opcode == 0x62 ? 3 : 2;
+
+            if ( !cursor.has( payload + 1 ) )
+                return std::nullopt;
+
+            const auto selector = cursor.peek( ) & ( opcode == 0x62 ? 0x07 : 0x1F );
+
+            if ( opcode == 0xC5 )
+                insn.map = opcode_map_t::secondary;
+            else if ( opcode == 0x8F )
+                insn.map = opcode_map_t::other;
+            else
+            {
+                switch ( selector )
+                {
+                    case 1: insn.map = opcode_map_t::secondary; break;
+                    case 2: insn.map = opcode_map_t::map_0f38; break;
+                    case 3: insn.map = opcode_map_t::map_0f3a; break;
+                    case 5:
+                    case 6: insn.map = opcode_map_t::other; break;
+                    default: return std::nullopt;
+                }
+            }
+
+            cursor.position += payload;
+            insn.opcode = cursor.next( );
+
+            if ( opcode == 0x8F )
+            {
+                // XOP map 8 takes an 8-bit immediate, map A a 32-bit one.
+                flags = M | ( selector == 0x08 ? I8 : selector == 0x0A ? IZ : N );
+            }
+            else
+            {
+                flags = flags_of( insn.map, insn.opcode ) & ( M | IMM_MASK );
+
+                // The VEX forms of `vzeroupper` and `vzeroall` are the only ones without a ModR/M byte.
+                if ( insn.map != opcode_map_t::secondary || insn.opcode != 0x77 || opcode == 0x62 )
+                    flags |= M;
+            }
+        }
+        else
+        {
+            if ( opcode == 0x0F )
+            {
+                if ( !cursor.has( 1 ) )
+                    return std::nullopt;
+
+                opcode = cursor.next( );
+                insn.map = opcode_map_t::secondary;
+
+                if ( opcode == 0x38 || opcode == 0x3A )
+                {
+                    if ( !cursor.has( 1 ) )
+                        return std::nullopt;
+
+                    insn.map = opcode == 0x38 ? opcode_map_t::map_0f38 : opcode_map_t::map_0f3a;
+                    opcode = cursor.next( );
+                }
+            }
+
+            insn.opcode = opcode;
+            flags = flags_of( insn.map, opcode );
+
+            if ( flags & X )
+                return std::nullopt;
+        }
+
+        // Decode the ModR/M byte, the SIB byte and the displacement.
+        if ( flags & M )
+        {
+            if ( !cursor.has( 1 ) )
+                return std::nullopt;
+
+            insn.has_modrm = true;
+            insn.modrm = cursor.next( );
+
+            const auto mod = insn.modrm >> 6;
+            const auto rm = insn.modrm & 7;
+
+            std::uint8_t disp_size = 0;
+
+            if ( mod != 3 )
+            {
+                if ( rm == 4 )
+                {
+                    if ( !cursor.has( 1 ) )
+                        return std::nullopt;
+
+                    const auto sib = cursor.next( );
+
+                    // A SIB base of 5 without a displacement byte encodes a 32-bit displacement with no base.
+                    if ( mod == 0 && ( sib & 7 ) == 5 )
+                        disp_size = 4;
+                }
+                else if ( mod == 0 && rm == 5 )
+                {
+                    insn.rip_relative = true;
+                    disp_size = 4;
+                }
+
+                if ( mod == 1 )
+                    disp_size = 1;
+                else if ( mod == 2 )
+                    disp_size = 4;
+            }
+
+            if ( !cursor.has( disp_size ) )
+                return std::nullopt;
+
+            if ( insn.rip_relative )
+            {
+                insn.disp_offset = static_cast< std::uint8_t >( cursor.position );
+                insn.disp_size = disp_size;
+                insn.disp = static_cast< std::int32_t >(
+                    code[ cursor.position ] | ( code[ cursor.position + 1 ] << 8 ) | ( code[ cursor.position + 2 ] << 16 ) |
+                    ( static_cast< std::uint32_t >( code[ cursor.position + 3 ] ) << 24 ) );
+            }
+
+            cursor.position += disp_size;
+        }
+
+        // Determine the immediate size.
+        std::uint8_t imm_size = 0;
+
+        if ( !( flags & G3 ) || insn.reg( ) < 2 )
+        {
+            switch ( flags & IMM_MASK )
+            {
+                case I8: imm_size = 1; break;
+                case I16: imm_size = 2; break;
+                case IZ: imm_size = operand_size_override ? 2 : 4; break;
+                case IV: imm_size = rex_w ? 8 : operand_size_override ? 2 : 4; break;
+                case IWB: imm_size = 3; break;
+                case MO: imm_size = address_size_override ? 4 : 8; break;
+                case R32: imm_size = 4; break;
+                default: break;
+            }
+        }
+
+        if ( !cursor.has( imm_size ) )
+            return std::nullopt;
+
+        // Relative branches store their target displacement in the immediate.
+        if ( flags & B )
+        {
+            insn.relative_branch = true;
+            insn.disp_offset = static_cast< std::uint8_t >( cursor.position );
+            insn.disp_size = imm_size;
+
+            if ( imm_size == 1 )
+                insn.disp = static_cast< std::int8_t >( code[ cursor.position ] );
+            else
+                insn.disp = static_cast< std::int32_t >(
+                    code[ cursor.position ] | ( code[ cursor.position + 1 ] << 8 ) | ( code[ cursor.position + 2 ] << 16 ) |
+                    ( static_cast< std::uint32_t >( code[ cursor.position + 3 ] ) << 24 ) );
+        }
+
+        cursor.position += imm_size;
+
+        insn.length = static_cast< std::uint8_t >( cursor.position );
+
+        return insn;
+    }
+}  // namespace vulkan::x86
\ No newline at end of file